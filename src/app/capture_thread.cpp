@@ -38,10 +38,12 @@ CaptureThread::CaptureThread(int cam_id)
   captureModule->addItem("DC 1394");
   captureModule->addItem("Video 4 Linux");
   captureModule->addItem("Read from files");
+  captureModule->addItem("Read from video file");
   captureModule->addItem("Generator");
   settings->addChild( (VarType*) (dc1394 = new VarList("DC1394")));
   settings->addChild( (VarType*) (v4l = new VarList("Video 4 Linux")));
   settings->addChild( (VarType*) (fromfile = new VarList("Read from files")));
+  settings->addChild( (VarType*) (videofile = new VarList("Read from video file")));
   settings->addChild( (VarType*) (generator = new VarList("Generator")));
   settings->addFlags( VARTYPE_FLAG_AUTO_EXPAND_TREE );
   c_stop->addFlags( VARTYPE_FLAG_READONLY );
@@ -56,6 +58,7 @@ CaptureThread::CaptureThread(int cam_id)
   capture=0;
   captureDC1394 = new CaptureDC1394v2(dc1394,camId);
   captureFiles = new CaptureFromFile(fromfile);
+  captureVideoFile = new CaptureVideoFile(videofile);
   captureGenerator = new CaptureGenerator(generator);
   captureV4L = new CaptureV4L(v4l,camId);
 
@@ -95,6 +98,7 @@ CaptureThread::~CaptureThread()
   delete captureDC1394;
   delete captureV4L;
   delete captureFiles;
+  delete captureVideoFile;
   delete captureGenerator;
   delete counter;
 
@@ -109,6 +113,7 @@ CaptureThread::~CaptureThread()
 
 void CaptureThread::setFrameBuffer(FrameBuffer * _rb) {
   rb=_rb;
+  slot_frames.assign(rb!=0 ? rb->size : 0,(const unsigned char *)0);
 }
 
 FrameBuffer * CaptureThread::getFrameBuffer() const {
@@ -119,12 +124,18 @@ VisionStack * CaptureThread::getStack() const {
   return stack;
 }
 
+CaptureGenerator * CaptureThread::getCaptureGenerator() const {
+  return (CaptureGenerator *)captureGenerator;
+}
+
 void CaptureThread::selectCaptureMethod() {
   capture_mutex.lock();
   CaptureInterface * old_capture=capture;
   CaptureInterface * new_capture=0;
   if(captureModule->getString() == "Read from files") {
     new_capture = captureFiles;
+  } else if(captureModule->getString() == "Read from video file") {
+    new_capture = captureVideoFile;
   } else if(captureModule->getString() == "Generator") {
     new_capture = captureGenerator;
 #ifdef MVIMPACT
@@ -149,6 +160,9 @@ void CaptureThread::selectCaptureMethod() {
     capture_mutex.unlock();
     return;
   }
+  //the old capture may have stopped by itself, its frames must not be
+  //handed to the new one:
+  if (new_capture!=old_capture) detachBorrowedFrames();
   capture=new_capture;
   capture_mutex.unlock();
 }
@@ -160,8 +174,39 @@ void CaptureThread::kill() {
   }
 }
 
+/// Frames which borrow a capture driver's buffers (zero-copy capture) are
+/// only valid while capturing. This gives them a private copy so that
+/// they can still be displayed after capture was stopped or reset, which
+/// also discards the driver frames they were holding.
+/// The caller has to hold capture_mutex.
+void CaptureThread::detachBorrowedFrames() {
+  if (rb==0) return;
+  stack_mutex.lock();
+  for (int i=0;i<rb->size;i++) {
+    rb->getPointer(i)->video.detach();
+  }
+  stack_mutex.unlock();
+  slot_frames.assign(rb->size,(const unsigned char *)0);
+}
+
+/// Detaches all frame buffer slots and hands the frames they were holding
+/// back to the driver. The caller has to hold capture_mutex.
+void CaptureThread::releaseHeldFrames() {
+  vector<const unsigned char *> held=slot_frames;
+  detachBorrowedFrames();
+  for (unsigned int i=0;i<held.size();i++) {
+    if (held[i]!=0) capture->releaseHeldFrame(held[i]);
+  }
+}
+
 bool CaptureThread::init() {
   capture_mutex.lock();
+  //a capture may have stopped by itself (e.g. a video file at its end),
+  //and restarting it discards the buffers the slots may still borrow:
+  detachBorrowedFrames();
+  //every frame buffer slot may hold a borrowed frame, plus the one
+  //being captured:
+  if (rb!=0) capture->setMaxHeldFrames(rb->size + 1);
   bool res = capture->startCapture();
   if (res==true) {
     c_start->addFlags( VARTYPE_FLAG_READONLY );
@@ -175,6 +220,7 @@ bool CaptureThread::init() {
 
 bool CaptureThread::stop() {
   capture_mutex.lock();
+  detachBorrowedFrames();
   bool res = capture->stopCapture();
   if (res==true) {
     c_stop->addFlags( VARTYPE_FLAG_READONLY );
@@ -188,6 +234,7 @@ bool CaptureThread::stop() {
 
 bool CaptureThread::reset() {
   capture_mutex.lock();
+  detachBorrowedFrames();
   bool res = capture->resetBus();
   capture_mutex.unlock();
   return res;
@@ -219,7 +266,16 @@ void CaptureThread::run() {
         if ((capture != 0) && (capture->isCapturing())) {
           RawImage pic_raw=capture->getFrame();
           d->time=pic_raw.getTime();
+          stats->dropped=capture->getDroppedFrames();
+          stats->frames_behind=capture->getFramesBehind();
           bool bSuccess = capture->copyAndConvertFrame( pic_raw,d->video);
+          //the driver frame which this slot used to borrow is overwritten
+          //now. Slots are not always reused in capture order, so release
+          //exactly that frame:
+          if (bSuccess && slot_frames[idx]!=0) {
+            capture->releaseHeldFrame(slot_frames[idx]);
+            slot_frames[idx]=0;
+          }
           capture_mutex.unlock();
 
           if (bSuccess) {           //only on a good frame read do we proceed
@@ -249,7 +305,15 @@ void CaptureThread::run() {
               }
               capture_mutex.lock();
               if ((capture != 0) && (capture->isCapturing())) {
-                capture->releaseFrame();
+                if (d->video.isBorrowed()) {
+                  //readers of the frame buffer still see this frame,
+                  //keep it until the slot is overwritten:
+                  slot_frames[idx]=pic_raw.getData();
+                } else {
+                  //zero-copy was turned off:
+                  releaseHeldFrames();
+                  capture->releaseHeldFrame(pic_raw.getData());
+                }
               }
               capture_mutex.unlock();
           }
@@ -263,6 +327,7 @@ void CaptureThread::run() {
         if (_kill) {
           capture_mutex.lock();
           if(capture != 0) {
+            detachBorrowedFrames();
             capture->stopCapture();
             //make sure to read latest params from camera to be saved to file...
             if (capture->isCapturing()) capture->readAllParameterValues();
@@ -25,6 +25,7 @@
 #include "capturefromfile.h"
 #include "capturev4l.h"
 #include "capture_generator.h"
+#include "capture_videofile.h"
 #include <QThread>
 #include "ringbuffer.h"
 #include "framedata.h"
@@ -62,8 +63,10 @@ protected:
   CaptureInterface * captureFlycap;
   CaptureInterface * captureFiles;
   CaptureInterface * captureGenerator;
+  CaptureInterface * captureVideoFile;
   AffinityManager * affinity;
   FrameBuffer * rb;
+  vector<const unsigned char *> slot_frames; //data of the driver frame each frame buffer slot still holds, or 0
   bool _kill;
   int camId;
   VarList * settings;
@@ -73,6 +76,7 @@ protected:
   VarList * flycap;
   VarList * generator;
   VarList * fromfile;
+  VarList * videofile;
   VarList * control;
   VarTrigger * c_start;
   VarTrigger * c_stop;
@@ -81,6 +85,8 @@ protected:
   VarBool * c_auto_refresh;
   VarStringEnum * captureModule;
   Timer timer;
+  void detachBorrowedFrames();
+  void releaseHeldFrames();
 
 public slots:
   bool init();
@@ -94,6 +100,7 @@ public:
   FrameBuffer * getFrameBuffer() const;
   void setStack(VisionStack * _stack);
   VisionStack * getStack() const;
+  CaptureGenerator * getCaptureGenerator() const;
   void kill();
   VarList * getSettings();
   void setAffinityManager(AffinityManager * _affinity);
@@ -31,9 +31,15 @@ class CaptureStats {
   public:
   double fps_capture;
   long long total;
+  /// frames lost by the capture device/driver since capture was started
+  long long dropped;
+  /// frames already queued in the driver behind the current one
+  int frames_behind;
   CaptureStats() {
     fps_capture=0.0;
     total=0;
+    dropped=0;
+    frames_behind=0;
   }
 };
 
@@ -145,6 +145,8 @@ MainWindow::MainWindow(bool start_capture, bool enforce_affinity)
   //update network output settings from xml file
   ((MultiStackRoboCupSSL*)multi_stack)->RefreshNetworkOutput();
   ((MultiStackRoboCupSSL*)multi_stack)->RefreshLegacyNetworkOutput();
+  ((MultiStackRoboCupSSL*)multi_stack)->RefreshAggregatedNetworkOutput();
+  ((MultiStackRoboCupSSL*)multi_stack)->RefreshStreamOutput();
   multi_stack->start();
 
   if (start_capture==true) {
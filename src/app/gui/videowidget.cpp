@@ -186,6 +186,7 @@ void VideoWidget::processVideoStats(VideoStats stats)
   //our display-widget as thrown us a stat-update event
   //let's display it
   statLabel->setText(
-    "Capture: "+ QString::number(stats.capture_stats.fps_capture,'f',2)  + " fps | Display: " + QString::number(stats.fps_draw,'f',2) + " fps | "
+    "Capture: "+ QString::number(stats.capture_stats.fps_capture,'f',2)  + " fps, "
+    + QString::number(stats.capture_stats.dropped) + " dropped | Display: " + QString::number(stats.fps_draw,'f',2) + " fps | "
     + QString::number(stats.fps_loop,'f',2) + " its/s");
 }
@@ -0,0 +1,368 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    plugin_ball_tracking.cpp
+  \brief   C++ Implementation: plugin_ball_tracking
+  \author  Author Name, 2026
+*/
+//========================================================================
+#include "plugin_ball_tracking.h"
+#include "plugin_detect_balls.h"
+#include <math.h>
+
+void BallTracker::Axis::init(double z, double var_p, double var_v) {
+  p=z;
+  v=0.0;
+  pp=var_p;
+  pv=0.0;
+  vv=var_v;
+}
+
+void BallTracker::Axis::predict(double dt, double var_a) {
+  double dt2=dt*dt;
+  p+=v*dt;
+  pp+=2.0*dt*pv+dt2*vv+var_a*dt2*dt2/4.0;
+  pv+=dt*vv+var_a*dt2*dt/2.0;
+  vv+=var_a*dt2;
+}
+
+void BallTracker::Axis::correct(double z, double var_z) {
+  double s=pp+var_z;
+  double k_p=pp/s;
+  double k_v=pv/s;
+  double innovation=z-p;
+  p+=k_p*innovation;
+  v+=k_v*innovation;
+  vv-=k_v*pv;
+  pv-=k_p*pv;
+  pp-=k_p*pp;
+}
+
+BallTracker::BallTracker()
+{
+  _settings=new VarList("Ball Tracking");
+  _settings->addChild(_v_enable=new VarBool("enable",false));
+  _settings->addChild(_v_acceleration_noise=new VarDouble("acceleration noise (mm/s^2)",5000.0,0.0));
+  _settings->addChild(_v_measurement_noise=new VarDouble("measurement noise (mm)",10.0,0.1));
+  _settings->addChild(_v_max_speed=new VarDouble("max ball speed (mm/s)",8000.0,0.0));
+  _settings->addChild(_v_gate=new VarDouble("gate (sigma)",3.0,0.0));
+  _settings->addChild(_v_window_margin=new VarDouble("window margin (pixels)",4.0,0.0));
+  _settings->addChild(_v_max_track_age=new VarDouble("max track age (s)",0.2,0.0));
+  _settings->addChild(_v_confidence_boost=new VarDouble("window confidence boost",0.1,0.0));
+
+  _settings->addChild(_outside_filters=new VarList("Outside Window Filters"));
+  _outside_filters->addChild(_v_outside_min_area=new VarInt("Min Area (sq-pixels, 0 = from ball filters)",0,0));
+  _outside_filters->addChild(_v_outside_max_area=new VarInt("Max Area (sq-pixels, 0 = from ball filters)",0,0));
+  _outside_filters->addChild(_v_outside_max_elongation=new VarDouble("Max Elongation",1.5,1.0));
+
+  _settings->addChild(_statistics=new VarList("Statistics"));
+  _statistics->addFlags(VARTYPE_FLAG_NOSTORE);
+  _statistics->addChild(_v_frames=new VarInt("Frames",0));
+  _statistics->addChild(_v_windowed_frames=new VarInt("Windowed Frames",0));
+  _statistics->addChild(_v_corrections=new VarInt("Corrections",0));
+  _statistics->addChild(_v_restarts=new VarInt("Restarts",0));
+  _statistics->addChild(_v_lost_tracks=new VarInt("Lost Tracks",0));
+  _statistics->addChild(_v_dropped_tracks=new VarInt("Dropped Tracks",0));
+  _v_frames->addFlags(VARTYPE_FLAG_READONLY);
+  _v_windowed_frames->addFlags(VARTYPE_FLAG_READONLY);
+  _v_corrections->addFlags(VARTYPE_FLAG_READONLY);
+  _v_restarts->addFlags(VARTYPE_FLAG_READONLY);
+  _v_lost_tracks->addFlags(VARTYPE_FLAG_READONLY);
+  _v_dropped_tracks->addFlags(VARTYPE_FLAG_READONLY);
+
+  tracking=false;
+  t=0.0;
+  t_measured=0.0;
+  measured_x=0.0;
+  measured_y=0.0;
+  frame_time=0.0;
+  frames=0;
+  windowed_frames=0;
+  corrections=0;
+  restarts=0;
+  lost_tracks=0;
+  dropped_tracks=0;
+}
+
+BallTracker::~BallTracker()
+{
+  delete _settings;
+}
+
+VarList * BallTracker::getSettings() {
+  return _settings;
+}
+
+void BallTracker::start(double time, const SSL_DetectionBall & ball) {
+  double var_z=_v_measurement_noise->getDouble();
+  var_z*=var_z;
+  double var_v=_v_max_speed->getDouble();
+  var_v*=var_v;
+  ax.init(ball.x(),var_z,var_v);
+  ay.init(ball.y(),var_z,var_v);
+  measured_x=ball.x();
+  measured_y=ball.y();
+  t=t_measured=time;
+  tracking=true;
+}
+
+bool BallTracker::advance(double time) {
+  if (tracking==false) return false;
+  if (_v_enable->getBool()==false) {
+    tracking=false;
+    return false;
+  }
+  //a track that was not seen for too long (or that is from the future,
+  //after a rewind) is lost:
+  if (time < t || time-t_measured > _v_max_track_age->getDouble()) {
+    tracking=false;
+    lost_tracks++;
+    return false;
+  }
+  if (time > t) {
+    double var_a=_v_acceleration_noise->getDouble();
+    var_a*=var_a;
+    ax.predict(time-t,var_a);
+    ay.predict(time-t,var_a);
+    t=time;
+  }
+  return true;
+}
+
+double BallTracker::getGateRadius() const {
+  double var_z=_v_measurement_noise->getDouble();
+  var_z*=var_z;
+  return _v_gate->getDouble()*sqrt(max(ax.pp,ay.pp)+var_z);
+}
+
+double BallTracker::getReachRadius(double time) const {
+  return _v_max_speed->getDouble()*max(0.0,time-t_measured)+_v_gate->getDouble()*_v_measurement_noise->getDouble();
+}
+
+void BallTracker::predict(double time, const CameraModel & model, double z, BallSearchWindow & window) {
+  window.valid=false;
+  if (_v_enable->getBool()==false) {
+    tracking=false;
+    return;
+  }
+  frames++;
+  if (advance(time)) {
+    //the gated area around the prediction, and the area a kicked ball can
+    //have reached since it was last seen:
+    double r=getGateRadius();
+    double reach=getReachRadius(time);
+    double field_x1=min(ax.p-r,measured_x-reach);
+    double field_x2=max(ax.p+r,measured_x+reach);
+    double field_y1=min(ay.p-r,measured_y-reach);
+    double field_y2=max(ay.p+r,measured_y+reach);
+
+    double x1=0.0,y1=0.0,x2=0.0,y2=0.0;
+    for (int i=0;i<4;i++) {
+      GVector::vector3d<double> p_f((i & 1) ? field_x2 : field_x1,(i & 2) ? field_y2 : field_y1,z);
+      GVector::vector2d<double> p_i;
+      model.field2image(p_f,p_i);
+      if (i==0 || p_i.x < x1) x1=p_i.x;
+      if (i==0 || p_i.x > x2) x2=p_i.x;
+      if (i==0 || p_i.y < y1) y1=p_i.y;
+      if (i==0 || p_i.y > y2) y2=p_i.y;
+    }
+    double margin=_v_window_margin->getDouble();
+    window.x1=(int)floor(x1-margin);
+    window.y1=(int)floor(y1-margin);
+    window.x2=(int)ceil(x2+margin);
+    window.y2=(int)ceil(y2+margin);
+    window.outside_min_area=_v_outside_min_area->getInt();
+    window.outside_max_area=_v_outside_max_area->getInt();
+    window.outside_max_elongation=_v_outside_max_elongation->getDouble();
+    window.confidence_boost=_v_confidence_boost->getDouble();
+    window.valid=true;
+    windowed_frames++;
+  }
+  frame_window=window;
+  frame_time=time;
+  updateStatistics();
+}
+
+void BallTracker::update(double time, const SSL_DetectionFrame & detection) {
+  if (_v_enable->getBool()==false) {
+    tracking=false;
+    return;
+  }
+
+  double var_z=_v_measurement_noise->getDouble();
+  var_z*=var_z;
+  if (advance(time)) {
+    //the closest ball within the gate corrects the track:
+    double r=getGateRadius();
+    int best=-1;
+    double best_dist=0.0;
+    for (int i=0;i<detection.balls_size();i++) {
+      const SSL_DetectionBall & ball=detection.balls(i);
+      double d=sqrt(sq(ball.x()-ax.p)+sq(ball.y()-ay.p));
+      if (d <= r && (best==-1 || d < best_dist)) {
+        best=i;
+        best_dist=d;
+      }
+    }
+    bool restart=false;
+    if (best < 0) {
+      //otherwise the ball may have been kicked: restart on the closest ball
+      //it can have reached since it was last seen:
+      double reach=getReachRadius(time);
+      for (int i=0;i<detection.balls_size();i++) {
+        const SSL_DetectionBall & ball=detection.balls(i);
+        double d=sqrt(sq(ball.x()-measured_x)+sq(ball.y()-measured_y));
+        if (d <= reach && (best==-1 || d < best_dist)) {
+          best=i;
+          best_dist=d;
+        }
+      }
+      if (time <= t_measured) best=-1;
+      restart=(best >= 0);
+    }
+
+    //a ball outside of the frame's search window that is clearly more
+    //confident than the matched one means the track follows a false blob:
+    if (frame_window.valid && frame_time==time) {
+      double matched_conf=(best >= 0) ? detection.balls(best).confidence() : 0.0;
+      int outside=-1;
+      for (int i=0;i<detection.balls_size();i++) {
+        const SSL_DetectionBall & ball=detection.balls(i);
+        if (frame_window.contains(ball.pixel_x(),ball.pixel_y())) continue;
+        if (ball.confidence() > matched_conf+frame_window.confidence_boost &&
+            (outside==-1 || ball.confidence() > detection.balls(outside).confidence())) {
+          outside=i;
+        }
+      }
+      if (outside >= 0) {
+        dropped_tracks++;
+        start(time,detection.balls(outside));
+        updateStatistics();
+        return;
+      }
+    }
+
+    if (best >= 0 && restart==false) {
+      ax.correct(detection.balls(best).x(),var_z);
+      ay.correct(detection.balls(best).y(),var_z);
+      measured_x=detection.balls(best).x();
+      measured_y=detection.balls(best).y();
+      t_measured=time;
+      corrections++;
+    } else if (restart) {
+      //with the velocity between the two sightings:
+      double dt=time-t_measured;
+      const SSL_DetectionBall & ball=detection.balls(best);
+      ax.init(ball.x(),var_z,2.0*var_z/(dt*dt));
+      ay.init(ball.y(),var_z,2.0*var_z/(dt*dt));
+      ax.v=(ball.x()-measured_x)/dt;
+      ay.v=(ball.y()-measured_y)/dt;
+      measured_x=ball.x();
+      measured_y=ball.y();
+      t_measured=time;
+      restarts++;
+    }
+  } else if (detection.balls_size() > 0) {
+    //start a new track on the most confident ball:
+    int best=0;
+    for (int i=1;i<detection.balls_size();i++) {
+      if (detection.balls(i).confidence() > detection.balls(best).confidence()) best=i;
+    }
+    start(time,detection.balls(best));
+  }
+  updateStatistics();
+}
+
+void BallTracker::updateStatistics() {
+  _v_frames->setInt((int)frames);
+  _v_windowed_frames->setInt((int)windowed_frames);
+  _v_corrections->setInt((int)corrections);
+  _v_restarts->setInt((int)restarts);
+  _v_lost_tracks->setInt((int)lost_tracks);
+  _v_dropped_tracks->setInt((int)dropped_tracks);
+}
+
+PluginBallPrediction::PluginBallPrediction(FrameBuffer * _buffer, BallTracker * _tracker, const CameraParameters & camera_params, PluginDetectBallsSettings * _ball_settings)
+ : VisionPlugin(_buffer), camera_parameters(camera_params)
+{
+  tracker=_tracker;
+  ball_settings=_ball_settings;
+}
+
+PluginBallPrediction::~PluginBallPrediction()
+{
+}
+
+ProcessResult PluginBallPrediction::process(FrameData * data, RenderOptions * options) {
+  (void)options;
+
+  BallSearchWindow * window;
+  if ((window=(BallSearchWindow *)data->map.get("ball_search_window")) == 0) {
+    window=(BallSearchWindow *)data->map.insert("ball_search_window",new BallSearchWindow());
+  }
+
+  //the calibration snapshot of this frame, or an own one if nobody took it:
+  const CameraModel * camera_model=(CameraModel *)data->map.get("camera_model");
+  if (camera_model==0) {
+    fallback_camera_model.update(camera_parameters,data->video.getWidth(),data->video.getHeight());
+    camera_model=&fallback_camera_model;
+  }
+
+  //the detected balls are projected at the ball height, so is the track:
+  double z=(ball_settings!=0) ? ball_settings->getZHeight() : 0.0;
+  tracker->predict(data->time,*camera_model,z,*window);
+
+  return ProcessingOk;
+}
+
+VarList * PluginBallPrediction::getSettings() {
+  return tracker->getSettings();
+}
+
+string PluginBallPrediction::getName() {
+  return "BallPrediction";
+}
+
+PluginBallTracking::PluginBallTracking(FrameBuffer * _buffer, BallTracker * _tracker)
+ : VisionPlugin(_buffer)
+{
+  tracker=_tracker;
+}
+
+PluginBallTracking::~PluginBallTracking()
+{
+}
+
+ProcessResult PluginBallTracking::process(FrameData * data, RenderOptions * options) {
+  (void)options;
+
+  SSL_DetectionFrame * detection_frame=(SSL_DetectionFrame *)data->map.get("ssl_detection_frame");
+  if (detection_frame==0) {
+    printf("error in ball tracking plugin: no detection frame was found!\n");
+    return ProcessingFailed;
+  }
+
+  tracker->update(data->time,*detection_frame);
+
+  return ProcessingOk;
+}
+
+VarList * PluginBallTracking::getSettings() {
+  return 0;
+}
+
+string PluginBallTracking::getName() {
+  return "BallTracking";
+}
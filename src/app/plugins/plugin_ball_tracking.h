@@ -0,0 +1,235 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    plugin_ball_tracking.h
+  \brief   C++ Interface: plugin_ball_tracking
+  \author  Author Name, 2026
+*/
+//========================================================================
+#ifndef PLUGIN_BALL_TRACKING_H
+#define PLUGIN_BALL_TRACKING_H
+
+#include <visionplugin.h>
+#include "camera_calibration.h"
+#include "messages_robocup_ssl_detection.pb.h"
+
+/**
+  The image region in which the ball tracker expects the ball of a frame,
+  put into the data map as "ball_search_window". Ball candidates inside
+  the window have their confidence boosted for the ranking, candidates
+  outside of it have to pass the stricter shape filters below.
+*/
+class BallSearchWindow {
+public:
+  bool valid; //false if there is no track, all candidates are treated alike
+  int x1,y1,x2,y2; //inclusive bounds in pixels
+
+  int outside_min_area; //0 derives the bound from the ball filters
+  int outside_max_area;
+  double outside_max_elongation; //longer over shorter side of the bounding box
+  double confidence_boost; //added to the rank of candidates inside
+
+  BallSearchWindow() {
+    valid=false;
+    x1=y1=x2=y2=0;
+    outside_min_area=0;
+    outside_max_area=0;
+    outside_max_elongation=0.0;
+    confidence_boost=0.0;
+  }
+
+  bool contains(double x, double y) const {
+    return valid && x >= x1 && x <= x2 && y >= y1 && y <= y2;
+  }
+};
+
+/*!
+  \class   BallTracker
+  \brief   Constant-velocity Kalman filter of a camera's ball in field coordinates
+
+  The state is the ball's field position and velocity, with white noise
+  acceleration as process noise. As the axes do not interact in this
+  model, each axis is filtered on its own 2x2 covariance.
+
+  Before a frame's balls are detected, the track is extrapolated to the
+  frame's time and its uncertainty ellipse is projected into the image as
+  the search window. Blurred, elongated blobs of a fast ball are expected
+  there, while the rest of the image is held to the shape of a ball at
+  rest. After detection, the reported ball closest to the prediction
+  within the gate corrects the state. A ball outside the gate, but within
+  the distance a kicked ball can travel since the last sighting, restarts
+  the track with the velocity between the two sightings, so kicks are not
+  lost. The track is dropped when no ball was found for the max track
+  age, or when a ball outside of the search window is more confident than
+  the matched one by more than the window's boost, and started anew on the
+  most confident ball.
+
+  One tracker belongs to one camera stack. PluginBallPrediction runs it
+  before PluginDetectBalls and PluginBallTracking feeds it the frame's
+  balls afterwards.
+*/
+class BallTracker
+{
+protected:
+  class Axis {
+  public:
+    double p; //position in mm
+    double v; //velocity in mm/s
+    double pp; //covariance
+    double pv;
+    double vv;
+
+    void init(double z, double var_p, double var_v);
+    void predict(double dt, double var_a);
+    void correct(double z, double var_z);
+  };
+
+  VarList * _settings;
+  VarBool * _v_enable;
+  VarDouble * _v_acceleration_noise;
+  VarDouble * _v_measurement_noise;
+  VarDouble * _v_max_speed;
+  VarDouble * _v_gate;
+  VarDouble * _v_window_margin;
+  VarDouble * _v_max_track_age;
+  VarDouble * _v_confidence_boost;
+  VarList * _outside_filters;
+  VarInt * _v_outside_min_area;
+  VarInt * _v_outside_max_area;
+  VarDouble * _v_outside_max_elongation;
+  VarList * _statistics;
+  VarInt * _v_frames;
+  VarInt * _v_windowed_frames;
+  VarInt * _v_corrections;
+  VarInt * _v_restarts;
+  VarInt * _v_lost_tracks;
+  VarInt * _v_dropped_tracks;
+
+  bool tracking;
+  Axis ax;
+  Axis ay;
+  double t; //time of the state
+  double t_measured; //time of the last correction
+  double measured_x; //position of the last correction
+  double measured_y;
+  BallSearchWindow frame_window; //the search window of the frame at frame_time
+  double frame_time;
+
+  long long frames;
+  long long windowed_frames;
+  long long corrections;
+  long long restarts;
+  long long lost_tracks;
+  long long dropped_tracks;
+
+  /// starts a new track on \p ball, seen at \p time
+  void start(double time, const SSL_DetectionBall & ball);
+  /// extrapolates the state to \p time, returns false if the track is lost
+  bool advance(double time);
+  /// field distance around the prediction within which a ball is matched
+  double getGateRadius() const;
+  /// field distance around the last sighting that the ball can have
+  /// travelled by \p time
+  double getReachRadius(double time) const;
+  void updateStatistics();
+
+public:
+  BallTracker();
+  ~BallTracker();
+
+  VarList * getSettings();
+
+  /// predicts the ball for a frame taken at \p time and fills \p window
+  /// with its image region, projected by \p model at the ball height \p z.
+  void predict(double time, const CameraModel & model, double z, BallSearchWindow & window);
+  /// corrects the track with the frame's best matching ball.
+  void update(double time, const SSL_DetectionFrame & detection);
+
+  bool isTracking() const {
+    return tracking;
+  }
+  /// the filtered field position and velocity
+  void getState(double & x, double & y, double & vx, double & vy) const {
+    x=ax.p;
+    y=ay.p;
+    vx=ax.v;
+    vy=ay.v;
+  }
+
+  long long getFrames() const {
+    return frames;
+  }
+  long long getWindowedFrames() const {
+    return windowed_frames;
+  }
+  long long getCorrections() const {
+    return corrections;
+  }
+  long long getRestarts() const {
+    return restarts;
+  }
+  long long getLostTracks() const {
+    return lost_tracks;
+  }
+  long long getDroppedTracks() const {
+    return dropped_tracks;
+  }
+};
+
+class PluginDetectBallsSettings;
+
+/**
+  Puts the ball tracker's search window for the frame into the data map as
+  "ball_search_window".
+*/
+class PluginBallPrediction : public VisionPlugin
+{
+protected:
+  BallTracker * tracker;
+  const CameraParameters & camera_parameters;
+  CameraModel fallback_camera_model;
+  PluginDetectBallsSettings * ball_settings;
+public:
+    PluginBallPrediction(FrameBuffer * _buffer, BallTracker * _tracker, const CameraParameters & camera_params, PluginDetectBallsSettings * _ball_settings);
+
+    ~PluginBallPrediction();
+
+    virtual ProcessResult process(FrameData * data, RenderOptions * options);
+
+    virtual VarList * getSettings();
+
+    virtual string getName();
+};
+
+/**
+  Feeds the balls of the frame's "ssl_detection_frame" back into the ball tracker.
+*/
+class PluginBallTracking : public VisionPlugin
+{
+protected:
+  BallTracker * tracker;
+public:
+    PluginBallTracking(FrameBuffer * _buffer, BallTracker * _tracker);
+
+    ~PluginBallTracking();
+
+    virtual ProcessResult process(FrameData * data, RenderOptions * options);
+
+    virtual VarList * getSettings();
+
+    virtual string getName();
+};
+
+#endif
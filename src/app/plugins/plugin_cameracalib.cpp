@@ -105,6 +105,11 @@ ProcessResult PluginCameraCalibration::process(
   video_width=data->video.getWidth();
   video_height=data->video.getHeight();
   (void)options;
+
+  //snapshot of the calibration for all plugins processing this frame:
+  CameraModel * camera_model=(CameraModel *)data->map.get("camera_model");
+  if (camera_model==0) camera_model=(CameraModel *)data->map.insert("camera_model",new CameraModel());
+  camera_model->update(camera_parameters,video_width,video_height);
   if(ccw) {
     if(ccw->getDetectEdges()) {
       detectEdges(data);
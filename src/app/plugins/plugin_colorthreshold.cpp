@@ -24,6 +24,14 @@ PluginColorThreshold::PluginColorThreshold(FrameBuffer * _buffer, YUVLUT * _lut)
  : VisionPlugin(_buffer)
 {
   lut=_lut;
+
+  _settings=new VarList("Segmentation");
+  _settings->addChild(_v_bayer_pattern=new VarStringEnum("RAW8 bayer pattern",Bayer::patternToString(Bayer::PATTERN_RGGB)));
+  for (int i = Bayer::PATTERN_RGGB; i <= Bayer::PATTERN_BGGR; i++) {
+    _v_bayer_pattern->addItem(Bayer::patternToString((Bayer::Pattern)i));
+  }
+  //only pays off if many candidates get histogram-checked per frame:
+  _settings->addChild(_v_integral_histogram=new VarBool("integral histograms",false));
 }
 
 
@@ -42,7 +50,28 @@ ProcessResult PluginColorThreshold::process(FrameData * data, RenderOptions * op
     img_thresholded=(Image<raw8> *)data->map.insert("cmv_threshold",new Image<raw8>());
   }
 
-  if (data->video.getColorFormat()==COLOR_YUV422_UYVY) {
+  //prefix counts of the labels for the histogram checks of the detectors.
+  //They describe the previous frame of this slot until rebuilt below, so
+  //a failed thresholding must not leave them valid:
+  CMVision::IntegralHistogram * integral=(CMVision::IntegralHistogram *)data->map.get("cmv_integral_histogram");
+  if (integral!=0) integral->clear();
+
+  //restricted to the windows of the ROI tracking, if it requested any:
+  CMVision::ROIList * rois=(CMVision::ROIList *)data->map.get("cmv_rois");
+  LUT3D * roi_lut=lut;
+  if (rois!=0 && !rois->isFullFrame() && data->video.getColorFormat()==COLOR_RGB8) {
+    roi_lut=lut->getDerivedLUT(CSPACE_RGB);
+  }
+
+  if (rois!=0 && !rois->isFullFrame() && roi_lut!=0) {
+    int scale=(data->video.getColorFormat()==COLOR_RAW8) ? 2 : 1;
+    img_thresholded->allocate(data->video.getWidth()/scale,data->video.getHeight()/scale);
+    rois->mapToImage(img_thresholded->getWidth(),img_thresholded->getHeight(),scale);
+    if (CMVisionThreshold::thresholdImageROIs(img_thresholded,&(data->video),roi_lut,
+                                              Bayer::stringToPattern(_v_bayer_pattern->getSelection()),*rois)==false) {
+      return ProcessingFailed;
+    }
+  } else if (data->video.getColorFormat()==COLOR_YUV422_UYVY) {
     //make sure image is allocated:
     img_thresholded->allocate(data->video.getWidth(),data->video.getHeight());
     //directly apply YUV lut:
@@ -52,6 +81,11 @@ ProcessResult PluginColorThreshold::process(FrameData * data, RenderOptions * op
     img_thresholded->allocate(data->video.getWidth(),data->video.getHeight());
     //directly apply YUV lut:
     CMVisionThreshold::thresholdImageYUV444(img_thresholded,&(data->video),lut);    
+  } else if (data->video.getColorFormat()==COLOR_RAW8) {
+    //label one sample per bayer quad, at half resolution:
+    img_thresholded->allocate(data->video.getWidth()/2,data->video.getHeight()/2);
+    CMVisionThreshold::thresholdImageBayerQuads(img_thresholded,&(data->video),lut,
+                                                Bayer::stringToPattern(_v_bayer_pattern->getSelection()));
   } else if (data->video.getColorFormat()==COLOR_RGB8) {
     //FIXME: check for changes in YUV LUT....if changed...copy things to RGB lut...
     RGBLUT * rgblut = (RGBLUT *) lut->getDerivedLUT(CSPACE_RGB);
@@ -62,15 +96,23 @@ ProcessResult PluginColorThreshold::process(FrameData * data, RenderOptions * op
       CMVisionThreshold::thresholdImageRGB(img_thresholded,&(data->video),rgblut);
     }
   } else {
-    fprintf(stderr,"ColorThresholding needs YUV422, YUV444, or RGB8 as input image, but found: %s\n",Colors::colorFormatToString(data->video.getColorFormat()).c_str());
+    fprintf(stderr,"ColorThresholding needs YUV422, YUV444, RGB8, or RAW8 as input image, but found: %s\n",Colors::colorFormatToString(data->video.getColorFormat()).c_str());
     return ProcessingFailed;
   }
-  
+
+  //the whole image has been labeled, whatever was requested:
+  if (rois!=0 && !rois->isFullFrame() && roi_lut==0) rois->setFullFrame();
+
+  if (_v_integral_histogram->getBool()) {
+    if (integral==0) integral=(CMVision::IntegralHistogram *)data->map.insert("cmv_integral_histogram",new CMVision::IntegralHistogram());
+    integral->build(img_thresholded,lut->getChannelCount());
+  }
+
   return ProcessingOk;
 }
 
 VarList * PluginColorThreshold::getSettings() {
-  return 0;
+  return _settings;
 }
 
 string PluginColorThreshold::getName() {
@@ -24,6 +24,7 @@
 #include <visionplugin.h>
 #include "lut3d.h"
 #include "cmvision_threshold.h"
+#include "cmvision_histogram.h"
 
 /**
 	@author Stefan Zickler
@@ -32,6 +33,9 @@ class PluginColorThreshold : public VisionPlugin
 {
 protected:
   YUVLUT * lut;
+  VarList * _settings;
+  VarStringEnum * _v_bayer_pattern;
+  VarBool * _v_integral_histogram;
 public:
     PluginColorThreshold(FrameBuffer * _buffer, YUVLUT * _lut);
 
@@ -18,7 +18,7 @@
   \author  Author Name, 2009
 */
 //========================================================================
-#include <list>
+#include <algorithm>
 #include "plugin_detect_balls.h"
 
 PluginDetectBalls::PluginDetectBalls ( FrameBuffer * _buffer, LUT3D * lut, const CameraParameters& camera_params, const RoboCupField& field,PluginDetectBallsSettings * settings )
@@ -70,13 +70,19 @@ string PluginDetectBalls::getName() {
   return "DetectBalls";
 }
 
-bool PluginDetectBalls::checkHistogram ( const Image<raw8> * image, const CMVision::Region * reg, double min_greenness, double max_markeryness ) {
+bool PluginDetectBalls::checkHistogram ( const Image<raw8> * image, const CMVision::Region * reg, double min_greenness, double max_markeryness, int label_scale, const CMVision::IntegralHistogram * integral ) {
   static const int PixelRadius = 4;
 
   histogram->clear();
 
-  int num = histogram->addBox ( image, reg->x1 - PixelRadius, reg->y1 - PixelRadius,
-                                reg->x2 + PixelRadius, reg->y2 + PixelRadius );
+  int num;
+  if ( integral!=0 ) {
+    num = histogram->addBox ( *integral, reg->x1 - PixelRadius, reg->y1 - PixelRadius,
+                              reg->x2 + PixelRadius, reg->y2 + PixelRadius, label_scale );
+  } else {
+    num = histogram->addBox ( image, reg->x1 - PixelRadius, reg->y1 - PixelRadius,
+                              reg->x2 + PixelRadius, reg->y2 + PixelRadius, label_scale );
+  }
 
 
   float pf = ( float ) ( histogram->getChannel ( color_id_pink ) ) / ( float ) ( histogram->getChannel ( color_id_orange ) );
@@ -89,22 +95,63 @@ bool PluginDetectBalls::checkHistogram ( const Image<raw8> * image, const CMVisi
   return ( true );
 }
 
-//Data structure for storing and sorting the filtered regions
-class BallDetectResult
-{
-public:
-  const CMVision::Region* reg;
-  float conf;
+void RobotPositionIndex::add ( const ::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot > & robots ) {
+  for ( int r = 0; r < robots.size(); r++ ) {
+    const SSL_DetectionRobot & robot = robots.Get ( r );
+    if ( robot.confidence() > 0.0 ) {
+      Position p;
+      p.x = robot.x();
+      p.y = robot.y();
+      positions.push_back ( p );
+    }
+  }
+}
+
+void RobotPositionIndex::build() {
+  sort ( positions.begin(),positions.end() );
+}
 
-  BallDetectResult(const CMVision::Region* reg, float conf) {
-    this->reg = reg;
-    this->conf = conf;    
+bool RobotPositionIndex::isNear ( double x, double y, double dist ) const {
+  double dist_sq = sq ( dist );
+  //the 1mm margin keeps rounding of the range bounds from skipping a robot,
+  //the distance test itself decides:
+  double range = fabs ( dist ) + 1.0;
+  Position first;
+  first.x = x - range;
+  vector<Position>::const_iterator it = lower_bound ( positions.begin(),positions.end(),first );
+  for ( ; it != positions.end() && it->x <= x + range; it++ ) {
+    if ( ( sq ( it->x - x ) + sq ( it->y - y ) ) < dist_sq ) return true;
   }
+  return false;
+}
 
-  bool operator< (BallDetectResult a) {
-    return conf < a.conf;
+//most confident first, with the boost of the search window,
+//ties go to the later region
+static bool rankBallCandidate ( const BallCandidate & a, const BallCandidate & b ) {
+  if ( a.rank != b.rank ) return a.rank > b.rank;
+  return a.order > b.order;
+}
+
+void PluginDetectBalls::getOutsideAreaBounds ( const BallSearchWindow & window, int label_scale, int & min_area, int & max_area ) const {
+  //a ball at rest is expected within two deviations of the gaussian size
+  //filter, or anywhere in the general area bounds if that filter is off:
+  min_area = ball_min_area;
+  max_area = ball_max_area;
+  if ( filter_gauss==true ) {
+    double stddev = sqrt ( exp_area_var );
+    min_area = max ( min_area, ( int ) floor ( exp_area_min - 2.0 * stddev ) );
+    max_area = min ( max_area, ( int ) ceil ( exp_area_max + 2.0 * stddev ) );
   }
-};
+  if ( window.outside_min_area > 0 ) min_area = window.outside_min_area;
+  if ( window.outside_max_area > 0 ) max_area = window.outside_max_area;
+
+  //with coarser labels, the border of a blob is only known to a label
+  //pixel, which changes its area by up to one label pixel around it:
+  if ( label_scale > 1 ) {
+    min_area -= ( label_scale - 1 ) * 4 * ( int ) ceil ( sqrt ( ( double ) max ( min_area,0 ) ) );
+    max_area += ( label_scale - 1 ) * 4 * ( int ) ceil ( sqrt ( ( double ) max ( max_area,0 ) ) );
+  }
+}
 
 ProcessResult PluginDetectBalls::process ( FrameData * data, RenderOptions * options ) {
   ( void ) options;
@@ -124,6 +171,13 @@ ProcessResult PluginDetectBalls::process ( FrameData * data, RenderOptions * opt
   //delete any previous detection results:
   detection_frame->clear_balls();
 
+  //the calibration snapshot of this frame, or an own one if nobody took it:
+  const CameraModel * camera_model= ( CameraModel * ) data->map.get ( "camera_model" );
+  if ( camera_model==0 ) {
+    fallback_camera_model.update ( camera_parameters,data->video.getWidth(),data->video.getHeight() );
+    camera_model=&fallback_camera_model;
+  }
+
   //TODO: add a vartype notifier for better performance.
 
   //initialize filter:
@@ -159,10 +213,12 @@ ProcessResult PluginDetectBalls::process ( FrameData * data, RenderOptions * opt
     exp_area_min =  _settings->_ball_gauss_min->getInt();
     exp_area_max = _settings->_ball_gauss_max->getInt();
     exp_area_var = sq ( _settings->_ball_gauss_stddev->getDouble() );
+    ball_min_area = _settings->_ball_min_area->getInt();
+    ball_max_area = _settings->_ball_max_area->getInt();
     z_height= _settings->_ball_z_height->getDouble();
 
     near_robot_filter = _settings->_ball_too_near_robot_enabled->getBool();
-    near_robot_dist_sq = sq(_settings->_ball_too_near_robot_dist->getDouble());
+    near_robot_dist = _settings->_ball_too_near_robot_dist->getDouble();
   }
 
   const CMVision::Region * reg = 0;
@@ -182,28 +238,42 @@ ProcessResult PluginDetectBalls::process ( FrameData * data, RenderOptions * opt
     printf ( "error in ball detection plugin: no color-thresholded image was found!\n" );
     return ProcessingFailed;
   }
+  int label_scale = CMVisionThreshold::getLabelScale ( data->video.getWidth(), image );
 
-  int robots_blue_n=0;
-  int robots_yellow_n=0;
-  bool use_near_robot_filter=near_robot_filter;
-  if ( use_near_robot_filter ) {
-    SSL_DetectionFrame * detection_frame = ( SSL_DetectionFrame * ) data->map.get ( "ssl_detection_frame" );
-    if ( detection_frame==0 ) {
-      use_near_robot_filter=false;
-    } else {
-      robots_blue_n=detection_frame->robots_blue_size();
-      robots_yellow_n=detection_frame->robots_yellow_size();
-      if (robots_blue_n==0 && robots_yellow_n==0) use_near_robot_filter=false;
-    }
-  }
+  //optional prefix counts of the labels, built by the thresholding stage:
+  const CMVision::IntegralHistogram * integral = ( CMVision::IntegralHistogram * ) data->map.get ( "cmv_integral_histogram" );
+  if ( integral!=0 && integral->isBuiltFor ( image ) ==false ) integral=0;
+
+  //the ball tracker's prediction for this frame, if it is enabled:
+  const BallSearchWindow * window = ( BallSearchWindow * ) data->map.get ( "ball_search_window" );
+  if ( window!=0 && window->valid==false ) window=0;
+  int outside_min_area = 0;
+  int outside_max_area = 0;
+  if ( window!=0 ) getOutsideAreaBounds ( *window,label_scale,outside_min_area,outside_max_area );
 
   if ( max_balls > 0 ) {
-    list<BallDetectResult> result;
+    //stage 1: cheap per-region filters, collecting the candidates that remain:
+    candidates.clear();
     filter.init ( reg );
-    
+    int order = -1;
     while ( ( reg = filter.getNext() ) != 0 ) {
+      order++;
       float conf = 1.0;
 
+      //outside of the tracker's window, only blobs shaped like a ball at
+      //rest are considered. Blurred blobs of a fast ball are expected inside:
+      bool in_window = false;
+      if ( window!=0 ) {
+        in_window = window->contains ( reg->cen_x,reg->cen_y );
+        if ( in_window==false ) {
+          int w = reg->width();
+          int h = reg->height();
+          if ( reg->area < outside_min_area || reg->area > outside_max_area ) continue;
+          //the extents are only known to a label pixel:
+          if ( max ( w,h ) - label_scale > window->outside_max_elongation * min ( w,h ) ) continue;
+        }
+      }
+
       if ( filter_gauss==true ) {
         int a = reg->area - bound ( reg->area,exp_area_min,exp_area_max );
         conf = gaussian ( a / exp_area_var );
@@ -216,7 +286,7 @@ ProcessResult PluginDetectBalls::process ( FrameData * data, RenderOptions * opt
       //convert from image to field coordinates:
       vector2d pixel_pos ( reg->cen_x,reg->cen_y );
       vector3d field_pos_3d;
-      camera_parameters.image2field ( field_pos_3d,pixel_pos,z_height );
+      camera_model->image2field ( field_pos_3d,pixel_pos,z_height );
       vector2d field_pos ( field_pos_3d.x,field_pos_3d.y );
 
       //filter points that are outside of the field:
@@ -229,71 +299,52 @@ ProcessResult PluginDetectBalls::process ( FrameData * data, RenderOptions * opt
         conf = 0.0;
       }
 
-      //TODO add ball-too-near-robot filter
-      if ( use_near_robot_filter && conf > 0.0 ) {
-        int robots_n=0;
-        for (int team = 0; team < 2; team++) {
-          if (team==0) {
-            robots_n=robots_blue_n;
-          } else {
-            robots_n=robots_yellow_n;
-          }
-          if (robots_n > 0) {
-            ::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot > * robots;
-            if (team==0) {
-              robots = detection_frame->mutable_robots_blue();
-            } else {
-              robots = detection_frame->mutable_robots_yellow();
-            }
-            for (int r = 0; r < robots_n; r++) {
-              const SSL_DetectionRobot & robot = robots->Get(r);
-              if (robot.confidence() > 0.0) {
-                if ((sq((double)(robot.x())-(double)(field_pos.x)) + sq((double)(robot.y())-(double)(field_pos.y))) < near_robot_dist_sq) {
-                  conf = 0.0;
-                  break;
-                }
-              }
-            }
-            if (conf==0.0) break;
-          }
-        }
-      }
-
-      // histogram check if enabled
-      if ( filter_ball_histogram && conf > 0.0 && checkHistogram ( image, reg, min_greenness, max_markeryness ) ==false ) {
-        conf = 0.0;
-      }
-
-      // add filtered region to the region list
-      if(conf > 0) {
-        result.push_back(BallDetectResult(reg,conf));
+      if ( conf > 0.0 ) {
+        BallCandidate candidate;
+        candidate.reg = reg;
+        candidate.conf = conf;
+        candidate.x = field_pos.x;
+        candidate.y = field_pos.y;
+        candidate.order = order;
+        candidate.rank = in_window ? conf + window->confidence_boost : conf;
+        candidates.push_back ( candidate );
       }
+    }
 
+    //index the robots found in this frame for the near-robot filter:
+    bool use_near_robot_filter = near_robot_filter && candidates.empty() == false;
+    if ( use_near_robot_filter ) {
+      robot_index.clear();
+      robot_index.add ( detection_frame->robots_blue() );
+      robot_index.add ( detection_frame->robots_yellow() );
+      robot_index.build();
+      use_near_robot_filter = ( robot_index.empty() == false );
     }
 
-    // sort result by confidence and output first max_balls region(s)
-    result.sort();
-    
-    int num_ball = 0;
-    list<BallDetectResult>::reverse_iterator it;
-    for(it=result.rbegin(); it!=result.rend(); it++) {
-      if(++num_ball > max_balls)
-        break;
+    //stage 2 and 3: near-robot filter, then the more expensive histogram
+    //check, compacting the surviving candidates in place:
+    int n = 0;
+    for ( unsigned int i = 0; i < candidates.size(); i++ ) {
+      const BallCandidate & candidate = candidates[i];
+      if ( use_near_robot_filter && robot_index.isNear ( candidate.x,candidate.y,near_robot_dist ) ) continue;
+      if ( filter_ball_histogram && checkHistogram ( image, candidate.reg, min_greenness, max_markeryness, label_scale, integral ) ==false ) continue;
+      candidates[n++] = candidate;
+    }
+    candidates.resize ( n );
 
-      //update result:
+    //stage 4: output the max_balls most confident candidates:
+    int num_balls = min ( max_balls,n );
+    partial_sort ( candidates.begin(),candidates.begin() + num_balls,candidates.end(),rankBallCandidate );
+    for ( int i = 0; i < num_balls; i++ ) {
+      const BallCandidate & candidate = candidates[i];
       SSL_DetectionBall* ball = detection_frame->add_balls();
 
-      ball->set_confidence ( it->conf );
-
-      vector2d pixel_pos ( it->reg->cen_x,it->reg->cen_y );
-      vector3d field_pos_3d;
-      camera_parameters.image2field ( field_pos_3d,pixel_pos,z_height );
-
-      ball->set_area ( it->reg->area );
-      ball->set_x ( field_pos_3d.x );
-      ball->set_y ( field_pos_3d.y );
-      ball->set_pixel_x ( it->reg->cen_x );
-      ball->set_pixel_y ( it->reg->cen_y );
+      ball->set_confidence ( candidate.conf );
+      ball->set_area ( candidate.reg->area );
+      ball->set_x ( candidate.x );
+      ball->set_y ( candidate.y );
+      ball->set_pixel_x ( candidate.reg->cen_x );
+      ball->set_pixel_y ( candidate.reg->cen_y );
     }
 
   }
@@ -301,4 +352,3 @@ ProcessResult PluginDetectBalls::process ( FrameData * data, RenderOptions * opt
   return ProcessingOk;
 
 }
-
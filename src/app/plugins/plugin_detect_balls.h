@@ -30,6 +30,8 @@
 #include "vis_util.h"
 #include "VarNotifier.h"
 #include "lut3d.h"
+#include "plugin_ball_tracking.h"
+#include <vector>
 /**
 	@author Author Name
 */
@@ -110,7 +112,53 @@ public:
   VarList * getSettings() {
     return _settings;
   }
+  double getZHeight() const {
+    return _ball_z_height->getDouble();
+  }
+
+};
 
+/// a ball candidate that passed the region filter, with its field position
+struct BallCandidate {
+  const CMVision::Region * reg;
+  float conf;
+  double x;
+  double y;
+  int order; //position in the region list, later candidates win ties
+  float rank; //conf, boosted inside the ball tracker's search window
+};
+
+/**
+  The field positions of the robots of a detection frame, sorted by x,
+  for the near-robot filter. A query only visits the robots within the
+  x-range of the distance instead of all robots of both teams.
+*/
+class RobotPositionIndex {
+protected:
+  struct Position {
+    double x;
+    double y;
+    bool operator< (const Position & other) const {
+      return x < other.x;
+    }
+  };
+  vector<Position> positions;
+public:
+  void clear() {
+    positions.clear();
+  }
+  /// adds all robots with a confidence above 0
+  void add(const ::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot > & robots);
+  /// sorts the added robots, has to be called before querying
+  void build();
+  bool empty() const {
+    return positions.empty();
+  }
+  int size() const {
+    return (int)positions.size();
+  }
+  /// true if any robot is closer than \p dist to (\p x, \p y)
+  bool isNear(double x, double y, double dist) const;
 };
 
 class PluginDetectBalls : public VisionPlugin
@@ -130,9 +178,11 @@ protected:
   int exp_area_min;
   int exp_area_max;
   double exp_area_var;
+  int ball_min_area;
+  int ball_max_area;
   double z_height;
   bool near_robot_filter;
-  double near_robot_dist_sq;
+  double near_robot_dist;
   int max_balls;
   //-----------------------------
   
@@ -153,11 +203,19 @@ protected:
   CMVision::RegionFilter filter;
 
   const CameraParameters& camera_parameters;
+  CameraModel fallback_camera_model;
   const RoboCupField& field;
 
   FieldFilter field_filter;
 
-  bool checkHistogram(const Image<raw8> * image, const CMVision::Region * reg, double min_greenness=0.5, double max_markeryness=2.0);
+  //kept across frames, so the pipeline does not allocate:
+  vector<BallCandidate> candidates;
+  RobotPositionIndex robot_index;
+
+  bool checkHistogram(const Image<raw8> * image, const CMVision::Region * reg, double min_greenness=0.5, double max_markeryness=2.0, int label_scale=1, const CMVision::IntegralHistogram * integral=0);
+  /// the area bounds for blobs outside of the ball tracker's \p window,
+  /// derived from the ball filters where the window leaves them at 0
+  void getOutsideAreaBounds(const BallSearchWindow & window, int label_scale, int & min_area, int & max_area) const;
 
 public:
     PluginDetectBalls(FrameBuffer * _buffer, LUT3D * lut, const CameraParameters& camera_params, const RoboCupField& field, PluginDetectBallsSettings * _settings=0);
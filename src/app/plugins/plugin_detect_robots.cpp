@@ -44,10 +44,11 @@ PluginDetectRobots::PluginDetectRobots(FrameBuffer * _buffer, LUT3D * lut, const
   global_team_selector_blue=_global_team_selector_blue;
   global_team_selector_yellow=_global_team_selector_yellow;
 
-  team_detector_blue=new CMPattern::TeamDetector(_lut,camera_params,field);
-  team_detector_yellow=new CMPattern::TeamDetector(_lut,camera_params,field);
+  team_detector_blue=new CMPattern::TeamDetector(_lut,field);
+  team_detector_yellow=new CMPattern::TeamDetector(_lut,field);
 
   _settings=new VarList("Robot Detection");
+  _settings->addChild(_v_parallel=new VarBool("parallel team detection",true));
   _notifier.addRecursive(_settings);
   connect(_global_team_selector_blue,SIGNAL(signalTeamDataChanged()),&_notifier,SLOT(changeSlotOtherChange()));
   connect(_global_team_selector_yellow,SIGNAL(signalTeamDataChanged()),&_notifier,SLOT(changeSlotOtherChange()));
@@ -66,20 +67,25 @@ string PluginDetectRobots::getName() {
   return "DetectRobots";
 }
 
-void PluginDetectRobots::buildRegionTree(CMVision::ColorRegionList * colorlist) {
-  reg_tree.clear();
+void PluginDetectRobots::TeamDetectionTask::run() {
+  detector->update(robots, color_id, num_robots, image, colorlist, *reg_grid, *camera_model, label_scale, integral_histogram);
+}
+
+void PluginDetectRobots::buildRegionGrid(const CMVision::ColorRegionList * colorlist) {
+  reg_grid.clear();
   int num_colors=colorlist->getNumColorRegions();
   for(int c=0;c<num_colors;c++) {
     //ONLY ADD ROBOT MARKER COLORS:
     if (c!= color_id_clear && c!=color_id_field && c!= color_id_ball && c!= color_id_black) {
       CMVision::Region *reg = colorlist->getRegionList(c).getInitialElement();
       while(reg!=0) {
-        reg_tree.add(reg);
+        reg_grid.add(reg);
         reg = reg->next;
       }
     }
   }
-  reg_tree.build();
+  //cells of the marker query size, so that a query visits at most 3x3 cells:
+  reg_grid.build(max(team_detector_blue->getMarkerQueryDistance(),team_detector_yellow->getMarkerQueryDistance()));
 }
 
 ProcessResult PluginDetectRobots::process(FrameData * data, RenderOptions * options)
@@ -93,8 +99,8 @@ ProcessResult PluginDetectRobots::process(FrameData * data, RenderOptions * opti
   if (detection_frame == 0) detection_frame=(SSL_DetectionFrame *)data->map.insert("ssl_detection_frame",new SSL_DetectionFrame());
 
   //acquire orange region list from data-map:
-  CMVision::ColorRegionList * colorlist;
-  colorlist=(CMVision::ColorRegionList *)data->map.get("cmv_colorlist");
+  const CMVision::ColorRegionList * colorlist;
+  colorlist=(const CMVision::ColorRegionList *)data->map.get("cmv_colorlist");
   if (colorlist==0) {
     printf("error in robot detection plugin: no region-lists were found!\n");
     return ProcessingFailed;
@@ -107,46 +113,70 @@ ProcessResult PluginDetectRobots::process(FrameData * data, RenderOptions * opti
     return ProcessingFailed;
   }
 
-  CMPattern::Team * team=0;
-  ::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robotlist=0;
-  
-  int color_id;
-  int num_robots;
-  CMPattern::TeamDetector * detector;
-  //TODO: lookup color label from LUT
+  //the calibration snapshot of this frame, or an own one if nobody took it:
+  const CameraModel * camera_model=(CameraModel *)data->map.get("camera_model");
+  if (camera_model==0) {
+    fallback_camera_model.update(camera_parameters,data->video.getWidth(),data->video.getHeight());
+    camera_model=&fallback_camera_model;
+  }
+
+  //optional, built by the thresholding stage:
+  const CMVision::IntegralHistogram * integral_histogram=(CMVision::IntegralHistogram *)data->map.get("cmv_integral_histogram");
 
-  buildRegionTree(colorlist);
+  CMPattern::Team * team=0;
   bool need_reinit=_notifier.hasChanged();
+  int label_scale=CMVisionThreshold::getLabelScale(data->video.getWidth(), image);
+  //TODO: lookup color label from LUT
 
+  //set up both teams first; only the detection itself runs concurrently
+  TeamDetectionTask tasks[2];
+  int num_tasks=0;
   for (int team_i = 0; team_i < 2; team_i++) {
     //team_i: 0==blue, 1==yellow
+    TeamDetectionTask & task=tasks[num_tasks];
     if (team_i==0) {
-      color_id=color_id_blue;
+      task.color_id=color_id_blue;
       team=global_team_selector_blue->getSelectedTeam();
-      num_robots=global_team_selector_blue->getNumberRobots();
+      task.num_robots=global_team_selector_blue->getNumberRobots();
       detection_frame->clear_robots_blue();
-      robotlist=detection_frame->mutable_robots_blue();
-      detector=team_detector_blue;
+      task.robots=detection_frame->mutable_robots_blue();
+      task.detector=team_detector_blue;
     } else {
-      color_id=color_id_yellow;
+      task.color_id=color_id_yellow;
       team=global_team_selector_yellow->getSelectedTeam();
-      num_robots=global_team_selector_yellow->getNumberRobots();
+      task.num_robots=global_team_selector_yellow->getNumberRobots();
       detection_frame->clear_robots_yellow();
-      robotlist=detection_frame->mutable_robots_yellow();
-      detector=team_detector_yellow;
+      task.robots=detection_frame->mutable_robots_yellow();
+      task.detector=team_detector_yellow;
     }
     if (team!=0) {
       if (need_reinit) {
-        detector->init(team);
+        task.detector->init(team);
       }
-
-      detector->update(robotlist, color_id,  num_robots, image, colorlist, reg_tree);
+      task.image=image;
+      task.colorlist=colorlist;
+      task.reg_grid=&reg_grid;
+      task.camera_model=camera_model;
+      task.label_scale=label_scale;
+      task.integral_histogram=integral_histogram;
+      num_tasks++;
     } else {
       _notifier.changeSlotOtherChange();
     }
+  }
 
-//    printf("DETECTED %d robots on team %d\n",robotlist->size(),team_i);
-//    fflush(stdout);
+  //from here on, the region lists, the grid, the thresholded image and the
+  //camera model are only read. Each detector writes to its own robot list.
+  buildRegionGrid(colorlist);
+
+  if (num_tasks==2 && _v_parallel->getBool()) {
+    //the second team runs on the persistent worker, the calling thread takes the first
+    WorkerThreads::Task * team_tasks[2]={&tasks[0],&tasks[1]};
+    team_workers.run(team_tasks,2);
+  } else {
+    for (int i = 0; i < num_tasks; i++) {
+      tasks[i].run();
+    }
   }
   return ProcessingOk;
 
@@ -27,11 +27,13 @@
 #include "camera_calibration.h"
 #include "field_filter.h"
 #include "cmvision_histogram.h"
+#include "cmvision_regiongrid.h"
 #include "cmpattern_teamdetector.h"
 #include "cmpattern_team.h"
 #include "vis_util.h"
 #include "lut3d.h"
 #include "VarNotifier.h"
+#include "worker_threads.h"
 /**
 	@author Author Name
 */
@@ -52,7 +54,7 @@ protected:
   int color_id_field;
   
 
-  CMVision::RegionTree reg_tree;
+  CMVision::RegionGrid reg_grid;
 
   CMPattern::TeamSelector * global_team_selector_blue;
   CMPattern::TeamSelector * global_team_selector_yellow;
@@ -61,9 +63,31 @@ protected:
   CMPattern::TeamDetector * team_detector_yellow;
 
   const CameraParameters& camera_parameters;
+  CameraModel fallback_camera_model;
   const RoboCupField& field;
 
-  void buildRegionTree(CMVision::ColorRegionList * colorlist);
+  VarBool * _v_parallel;
+  /// runs the second team's detection. Its worker is not pinned to the
+  /// capture thread's core, see WorkerThreads.
+  WorkerThreads team_workers;
+
+  /// the inputs and the output list of one team's detection
+  class TeamDetectionTask : public WorkerThreads::Task {
+  public:
+    CMPattern::TeamDetector * detector;
+    ::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots;
+    int color_id;
+    int num_robots;
+    const Image<raw8> * image;
+    const CMVision::ColorRegionList * colorlist;
+    const CMVision::RegionGrid * reg_grid;
+    const CameraModel * camera_model;
+    int label_scale;
+    const CMVision::IntegralHistogram * integral_histogram;
+    virtual void run();
+  };
+
+  void buildRegionGrid(const CMVision::ColorRegionList * colorlist);
 
 protected slots:
     void teamDataChange();
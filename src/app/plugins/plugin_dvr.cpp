@@ -19,6 +19,8 @@
 */
 //========================================================================
 #include "plugin_dvr.h"
+#include "capturefromfile.h"
+#include "raw_video_file.h"
 
 PluginDVRWidget::PluginDVRWidget(PluginDVR * dvr, QWidget * parent, Qt::WindowFlags f) : QWidget(parent,f) {
   layout_main=new QVBoxLayout();
@@ -340,8 +342,47 @@ void PluginDVR::slotMovieLoad() {
   unlock();
 }
 
+/// writes the stream into a single raw video file, which can be replayed
+/// with its timestamps by the "Read from video file" capture module.
+void PluginDVR::saveRawVideoFile() {
+  QString filename = QFileDialog::getSaveFileName(0,"Select Raw Video File to Save","","Raw Video (*.raw)");
+  if (filename=="" || stream.getFrameCount()==0) return;
+  DVRFrame * first = stream.getFrame(0);
+  RawVideoWriter writer;
+  if (first==0 || !writer.open(filename.toStdString(),first->video.getColorFormat(),
+                               first->video.getWidth(),first->video.getHeight())) {
+    return;
+  }
+  QProgressDialog * dlg = new QProgressDialog("Saving Movie to Raw Video File...","Cancel", 1,stream.getFrameCount());
+  dlg->setWindowModality(Qt::WindowModal);
+  for (int i = 0; i < stream.getFrameCount(); i++) {
+    DVRFrame * f = stream.getFrame(i);
+    dlg->setValue(i+1);
+    if (f!=0) {
+      //all frames of a file share the size and format of the first one:
+      if (f->video.getColorFormat()!=first->video.getColorFormat() ||
+          f->video.getWidth()!=first->video.getWidth() || f->video.getHeight()!=first->video.getHeight()) {
+        fprintf(stderr,"DVR: skipping frame %d, its format differs from the first frame\n",i);
+      } else if (!writer.appendFrame(f->video.getData(),f->video.getTime())) {
+        fprintf(stderr,"DVR: failed to write frame %d to %s\n",i,filename.toStdString().c_str());
+        break;
+      }
+    }
+    if (dlg->wasCanceled()) break;
+  }
+  if (!writer.close()) {
+    fprintf(stderr,"DVR: failed to finish %s\n",filename.toStdString().c_str());
+  }
+  delete dlg;
+}
+
 void PluginDVR::slotMovieSave() {
   lock();
+  if (_save_format->getString()=="Raw Video File") {
+    saveRawVideoFile();
+    unlock();
+    return;
+  }
   QString dir = QFileDialog::getExistingDirectory(0,"Select Directory to Save");
   rgbImage output;
   QProgressDialog * dlg = new QProgressDialog("Saving Movie to PNG Files...","Cancel", 1,stream.getFrameCount());
@@ -353,21 +394,26 @@ void PluginDVR::slotMovieSave() {
       dlg->setValue(i+1);
       if (f!=0) {
         ColorFormat fmt=f->video.getColorFormat();
-        output.allocate(f->video.getWidth(),f->video.getHeight());
-        if (fmt==COLOR_YUV422_UYVY) {
-          Conversions::uyvy2rgb(f->video.getData(),output.getData(),f->video.getWidth(),f->video.getHeight());
-        } else if (fmt==COLOR_RGB8) {
-          memcpy(output.getData(),f->video.getData(),f->video.getNumBytes());
+        QString num = QString::number(i);
+        num = "00000" + num;
+        num = num.right(5);
+        if (fmt==COLOR_YUV422_UYVY && _save_format->getString()=="Raw Frames (.uyvy)") {
+          //raw frames are replayed by the file capture without decoding:
+          CaptureFromFile::writeRawFrame(f->video,(dir + "/" + num + ".uyvy").toStdString());
         } else {
-          output.allocate(0,0);
-        }
-        if (output.getNumBytes() > 0) {
-          //write file:
-          QString num = QString::number(i);
-          num = "00000" + num;
-          num = num.right(5);
-          QString filename = dir + "/" + num + ".png";
-          output.save(filename.toStdString());
+          output.allocate(f->video.getWidth(),f->video.getHeight());
+          if (fmt==COLOR_YUV422_UYVY) {
+            Conversions::uyvy2rgb(f->video.getData(),output.getData(),f->video.getWidth(),f->video.getHeight());
+          } else if (fmt==COLOR_RGB8) {
+            memcpy(output.getData(),f->video.getData(),f->video.getNumBytes());
+          } else {
+            output.allocate(0,0);
+          }
+          if (output.getNumBytes() > 0) {
+            //write file:
+            QString filename = dir + "/" + num + ".png";
+            output.save(filename.toStdString());
+          }
         }
       }
       if (dlg->wasCanceled()) break;
@@ -390,8 +436,14 @@ PluginDVR::PluginDVR(FrameBuffer * fb)
   _max_frames = new VarInt("Max Frames",250);
   _max_frames->setMin(0);
   _shift_on_exceed = new VarBool("Shift Video On Exceeding",true);
+  //raw frames are only written for YUV422 frames, others are saved as png:
+  _save_format = new VarStringEnum("Save Movies As","PNG Files");
+  _save_format->addItem("PNG Files");
+  _save_format->addItem("Raw Frames (.uyvy)");
+  _save_format->addItem("Raw Video File");
   _settings->addChild(_max_frames);
   _settings->addChild(_shift_on_exceed);
+  _settings->addChild(_save_format);
   slotModeToggled();
   slotSeekModeToggled();
 }
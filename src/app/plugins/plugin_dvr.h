@@ -158,6 +158,7 @@ protected:
   VarList * _settings;
   VarInt * _max_frames;
   VarBool * _shift_on_exceed;
+  VarStringEnum * _save_format;
   PluginDVRWidget * w;
 
   double advance_last_t;
@@ -165,6 +166,7 @@ protected:
   bool trigger_pause_refresh;
   DVRFrame pause_frame;
   DVRStream stream;
+  void saveRawVideoFile();
 public:
     PluginDVR(FrameBuffer * fb);
     virtual VarList * getSettings();
@@ -69,6 +69,10 @@ ProcessResult PluginFindBlobs::process(FrameData * data, RenderOptions * options
     if (reglist->getUsedRegions() == reglist->getMaxRegions()) {
       printf("Warning: extract regions exceeded maximum number of %d regions\n",reglist->getMaxRegions());
     }
+
+    //Report regions of a reduced-resolution (e.g. bayer quad) label image in video coordinates:
+    CMVision::RegionProcessing::scaleRegions(reglist, CMVisionThreshold::getLabelScale(data->video.getWidth(),
+                                             (Image<raw8> *)data->map.get("cmv_threshold")));
   
     //Separate Regions by colors:
     int max_area = CMVision::RegionProcessing::separateRegions(colorlist, reglist, _v_min_blob_area->getInt());
@@ -0,0 +1,299 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    plugin_frameaggregator.cpp
+  \brief   C++ Implementation: plugin_frameaggregator
+  \author  Author Name, 2026
+*/
+//========================================================================
+#include "plugin_frameaggregator.h"
+
+const double FrameAggregator::ActiveCameraTimeout = 1.0;
+
+AggregatorTimeoutThread::AggregatorTimeoutThread(FrameAggregator * aggregator)
+{
+  _aggregator=aggregator;
+}
+
+void AggregatorTimeoutThread::run() {
+  _aggregator->runTimeouts();
+}
+
+FrameAggregator::FrameAggregator(RoboCupSSLServer * server, int num_cameras)
+{
+  _server=server;
+  _num_cameras=num_cameras;
+  last_seen.resize(num_cameras,0.0);
+  has_counter_offset.resize(num_cameras,false);
+  counter_offset.resize(num_cameras,0);
+  last_counter.resize(num_cameras,0);
+  newest_key=0.0;
+  for (int i=0;i<MaxOpenTicks;i++) {
+    ticks[i].open=false;
+    ticks[i].present.resize(num_cameras,false);
+  }
+
+  _settings=new VarList("Frame Aggregation");
+  _settings->addChild(_enable=new VarBool("Enable",false));
+  _settings->addChild(_mode=new VarStringEnum("Group By","Capture Time"));
+  _mode->addItem("Capture Time");
+  _mode->addItem("Frame Counter");
+  _settings->addChild(_window=new VarDouble("Capture Time Window (ms)",4.0,0.0));
+  _settings->addChild(_timeout=new VarDouble("Timeout (ms)",10.0,0.0));
+  _settings->addChild(multicast_address=new VarString("Multicast Address","224.5.23.2"));
+  _settings->addChild(multicast_port=new VarInt("Multicast Port",10020,1,65535));
+  _settings->addChild(multicast_interface=new VarString("Multicast Interface",""));
+
+  _settings->addChild(_stats=new VarList("Statistics"));
+  _stats->addFlags(VARTYPE_FLAG_NOSTORE);
+  _stats->addChild(_last_skew=new VarDouble("Last Skew (ms)",0.0));
+  _stats->addChild(_max_skew=new VarDouble("Max Skew (ms)",0.0));
+  _stats->addChild(_ticks_complete=new VarInt("Complete Ticks",0));
+  _stats->addChild(_ticks_incomplete=new VarInt("Timed Out Ticks",0));
+  _last_skew->addFlags(VARTYPE_FLAG_READONLY);
+  _max_skew->addFlags(VARTYPE_FLAG_READONLY);
+  _ticks_complete->addFlags(VARTYPE_FLAG_READONLY);
+  _ticks_incomplete->addFlags(VARTYPE_FLAG_READONLY);
+
+  vnotify.addItem(_mode);
+  vnotify.addItem(_window);
+  vnotify.addItem(_timeout);
+  vnotify.changeSlotOtherChange();
+  by_frame_counter=false;
+  max_skew=0.0;
+  ticks_complete=0;
+  ticks_incomplete=0;
+  updateSettings();
+
+  _timeout_thread=0;
+  shutdown=false;
+}
+
+FrameAggregator::~FrameAggregator()
+{
+  if (_timeout_thread!=0) {
+    mutex.lock();
+    shutdown=true;
+    timeout_condition.wakeAll();
+    mutex.unlock();
+    _timeout_thread->wait();
+    delete _timeout_thread;
+  }
+  delete _settings;
+}
+
+VarList * FrameAggregator::getSettings() {
+  return _settings;
+}
+
+bool FrameAggregator::isEnabled() const {
+  return _enable->getBool();
+}
+
+bool FrameAggregator::isComplete(const Tick & tick, double now) const {
+  for (int i=0;i<_num_cameras;i++) {
+    if (tick.present[i]==false && (now - last_seen[i]) < ActiveCameraTimeout) return false;
+  }
+  return true;
+}
+
+void FrameAggregator::emitTick(Tick & tick, double now) {
+  bool complete=isComplete(tick,now);
+  double skew=tick.t_capture_max - tick.t_capture_min;
+  tick.msg.set_t_capture(tick.t_capture_min);
+  tick.msg.set_skew(skew);
+  tick.msg.set_complete(complete);
+  tick.msg.set_t_sent(GetTimeSec());
+  _server->send(tick.msg);
+  tick.open=false;
+
+  if (complete) {
+    ticks_complete++;
+  } else {
+    ticks_incomplete++;
+  }
+  if (skew > max_skew) max_skew=skew;
+  _last_skew->setDouble(skew*1000.0);
+  _max_skew->setDouble(max_skew*1000.0);
+  _ticks_complete->setInt(ticks_complete);
+  _ticks_incomplete->setInt(ticks_incomplete);
+}
+
+void FrameAggregator::emitOlderThan(double key, double now) {
+  //emit in order of their key to keep the output monotonic:
+  while(true) {
+    Tick * oldest=0;
+    for (int i=0;i<MaxOpenTicks;i++) {
+      if (ticks[i].open && ticks[i].key < key && (oldest==0 || ticks[i].key < oldest->key)) {
+        oldest=&ticks[i];
+      }
+    }
+    if (oldest==0) return;
+    emitTick(*oldest,now);
+  }
+}
+
+void FrameAggregator::updateSettings() {
+  if (vnotify.hasChanged()) {
+    bool counter_mode=(_mode->getString()=="Frame Counter");
+    if (counter_mode!=by_frame_counter) {
+      //the keys of the other mode do not compare, align the counters anew:
+      has_counter_offset.assign(_num_cameras,false);
+      newest_key=0.0;
+    }
+    by_frame_counter=counter_mode;
+    window=_window->getDouble()/1000.0;
+    timeout=_timeout->getDouble()/1000.0;
+  }
+}
+
+void FrameAggregator::emitOverdue(double now) {
+  double tolerance = by_frame_counter ? 0.5 : window;
+  for (int i=0;i<MaxOpenTicks;i++) {
+    if (ticks[i].open && (now - ticks[i].t_opened) > timeout) {
+      emitOlderThan(ticks[i].key + tolerance,now);
+    }
+  }
+}
+
+double FrameAggregator::getNextTimeout() const {
+  double next=-1.0;
+  for (int i=0;i<MaxOpenTicks;i++) {
+    if (ticks[i].open && (next < 0.0 || ticks[i].t_opened + timeout < next)) {
+      next=ticks[i].t_opened + timeout;
+    }
+  }
+  return next;
+}
+
+void FrameAggregator::runTimeouts() {
+  mutex.lock();
+  while(!shutdown) {
+    updateSettings();
+    double now=GetTimeSec();
+    emitOverdue(now);
+    double next=getNextTimeout();
+    if (next < 0.0) {
+      timeout_condition.wait(&mutex);
+    } else {
+      //a millisecond more, so the tick is overdue when we wake up:
+      timeout_condition.wait(&mutex,(unsigned long)ceil(max(0.0,next-now)*1000.0)+1);
+    }
+  }
+  mutex.unlock();
+}
+
+double FrameAggregator::getCounterKey(int cam, long long counter, double now) {
+  bool restarted = counter < last_counter[cam] || (now - last_seen[cam]) >= ActiveCameraTimeout;
+  if (has_counter_offset[cam]==false || restarted) {
+    counter_offset[cam]=counter - (long long)newest_key;
+    has_counter_offset[cam]=true;
+  }
+  last_counter[cam]=counter;
+  return (double)(counter - counter_offset[cam]);
+}
+
+void FrameAggregator::add(const SSL_DetectionFrame & frame) {
+  int cam=frame.camera_id();
+  if (cam < 0 || cam >= _num_cameras) return;
+
+  mutex.lock();
+  if (_timeout_thread==0) {
+    _timeout_thread=new AggregatorTimeoutThread(this);
+    _timeout_thread->start();
+  }
+  updateSettings();
+
+  double now=GetTimeSec();
+  double key = by_frame_counter ? getCounterKey(cam,frame.frame_number(),now) : frame.t_capture();
+  double tolerance = by_frame_counter ? 0.5 : window;
+  last_seen[cam]=now;
+
+  //strict timeout: emit whatever is overdue before accepting new data
+  emitOverdue(now);
+
+  Tick * tick=0;
+  for (int i=0;i<MaxOpenTicks && tick==0;i++) {
+    if (ticks[i].open && ticks[i].present[cam]==false && fabs(ticks[i].key - key) <= tolerance) {
+      tick=&ticks[i];
+    }
+  }
+
+  if (tick==0) {
+    //a camera only ever moves forward, so any older open tick it has
+    //already contributed to will not receive more frames from it.
+    for (int i=0;i<MaxOpenTicks && tick==0;i++) {
+      if (ticks[i].open==false) tick=&ticks[i];
+    }
+    if (tick==0) {
+      //all slots in use: emit the oldest tick to make room.
+      Tick * oldest=&ticks[0];
+      for (int i=1;i<MaxOpenTicks;i++) {
+        if (ticks[i].key < oldest->key) oldest=&ticks[i];
+      }
+      emitTick(*oldest,now);
+      tick=oldest;
+    }
+    tick->open=true;
+    tick->key=key;
+    tick->t_opened=now;
+    tick->t_capture_min=frame.t_capture();
+    tick->t_capture_max=frame.t_capture();
+    tick->present.assign(_num_cameras,false);
+    tick->msg.clear_frames();
+    if (key > newest_key) newest_key=key;
+    //the timeout thread has to wake up for the new tick:
+    timeout_condition.wakeOne();
+  }
+
+  tick->msg.add_frames()->CopyFrom(frame);
+  tick->present[cam]=true;
+  tick->t_capture_min=min(tick->t_capture_min,frame.t_capture());
+  tick->t_capture_max=max(tick->t_capture_max,frame.t_capture());
+
+  if (isComplete(*tick,now)) {
+    emitOlderThan(tick->key,now);
+    emitTick(*tick,now);
+  }
+  mutex.unlock();
+}
+
+PluginFrameAggregator::PluginFrameAggregator(FrameBuffer * _fb, FrameAggregator * aggregator)
+ : VisionPlugin(_fb)
+{
+  _aggregator=aggregator;
+}
+
+PluginFrameAggregator::~PluginFrameAggregator()
+{
+}
+
+ProcessResult PluginFrameAggregator::process(FrameData * data, RenderOptions * options)
+{
+  (void)options;
+  if (data==0) return ProcessingFailed;
+  if (_aggregator->isEnabled()==false) return ProcessingOk;
+
+  SSL_DetectionFrame * detection_frame = 0;
+  detection_frame=(SSL_DetectionFrame *)data->map.get("ssl_detection_frame");
+  if (detection_frame != 0) {
+    _aggregator->add(*detection_frame);
+  }
+  return ProcessingOk;
+}
+
+string PluginFrameAggregator::getName() {
+  return "Frame Aggregation";
+}
@@ -0,0 +1,167 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    plugin_frameaggregator.h
+  \brief   C++ Interface: plugin_frameaggregator
+  \author  Author Name, 2026
+*/
+//========================================================================
+#ifndef PLUGIN_FRAMEAGGREGATOR_H
+#define PLUGIN_FRAMEAGGREGATOR_H
+
+#include <visionplugin.h>
+#include "robocup_ssl_server.h"
+#include "messages_robocup_ssl_detection_tick.pb.h"
+#include "VarNotifier.h"
+#include "timer.h"
+#include <QThread>
+#include <QWaitCondition>
+
+class FrameAggregator;
+
+/*!
+  \class   AggregatorTimeoutThread
+  \brief   Emits the overdue ticks of a FrameAggregator when no camera
+           delivers frames anymore.
+
+  Without it, overdue ticks would only be emitted by the next call to
+  add(), so the last tick would never be sent if every camera stalls.
+  It sleeps until the oldest open tick is due, and without open ticks
+  until add() opens one.
+*/
+class AggregatorTimeoutThread : public QThread
+{
+protected:
+  FrameAggregator * _aggregator;
+  virtual void run();
+public:
+  AggregatorTimeoutThread(FrameAggregator * aggregator);
+};
+
+/*!
+  \class   FrameAggregator
+  \brief   Collects the detection frames of all cameras that belong to the
+           same capture instant and sends them as one SSL_DetectionTick.
+
+  Frames are grouped either by capture time (within a configurable window)
+  or by their frame counter. A tick is sent as soon as every active camera
+  has reported, or once its timeout expires, so that a slow camera can not
+  stall the output of the others. The timeout is checked on every new
+  frame and by an AggregatorTimeoutThread, so that it also expires when
+  all cameras stop. The thread is started by the first aggregated frame.
+  The per-camera packets are not affected.
+
+  The frame counters of the cameras need not agree: each camera's counter
+  is aligned to the newest tick on its first frame, and again whenever it
+  runs backwards or the camera was inactive. Grouping by frame counter
+  therefore assumes that the cameras are triggered together from their
+  first frame on and do not drop frames differently.
+*/
+class FrameAggregator
+{
+friend class AggregatorTimeoutThread;
+protected:
+  static const int MaxOpenTicks = 4;
+  //a camera is expected in a tick if it reported within this time (s):
+  static const double ActiveCameraTimeout;
+
+  struct Tick {
+    bool open;
+    double key;
+    double t_opened;
+    double t_capture_min;
+    double t_capture_max;
+    vector<bool> present;
+    SSL_DetectionTick msg;
+  };
+
+  QMutex mutex;
+  RoboCupSSLServer * _server;
+  int _num_cameras;
+  vector<double> last_seen;
+  Tick ticks[MaxOpenTicks];
+  //per camera frame counter alignment, see above:
+  vector<bool> has_counter_offset;
+  vector<long long> counter_offset;
+  vector<long long> last_counter;
+  double newest_key;
+
+  VarNotifier vnotify;
+  VarList * _settings;
+  VarBool * _enable;
+  VarStringEnum * _mode;
+  VarDouble * _window;
+  VarDouble * _timeout;
+  VarList * _stats;
+  VarDouble * _last_skew;
+  VarDouble * _max_skew;
+  VarInt * _ticks_complete;
+  VarInt * _ticks_incomplete;
+
+  //local copies of the settings:
+  bool by_frame_counter;
+  double window;
+  double timeout;
+  double max_skew;
+  int ticks_complete;
+  int ticks_incomplete;
+
+  AggregatorTimeoutThread * _timeout_thread;
+  QWaitCondition timeout_condition;
+  bool shutdown;
+
+  void updateSettings();
+  void emitOverdue(double now);
+  /// emits the overdue ticks until shut down, run by the timeout thread.
+  void runTimeouts();
+  /// the time at which the oldest open tick is due, or -1 without open ticks
+  double getNextTimeout() const;
+  /// the grouping key of a camera's frame counter
+  double getCounterKey(int cam, long long counter, double now);
+  bool isComplete(const Tick & tick, double now) const;
+  void emitTick(Tick & tick, double now);
+  void emitOlderThan(double key, double now);
+
+public:
+  VarString * multicast_address;
+  VarInt * multicast_port;
+  VarString * multicast_interface;
+
+  FrameAggregator(RoboCupSSLServer * server, int num_cameras);
+  ~FrameAggregator();
+  VarList * getSettings();
+  bool isEnabled() const;
+
+  /// adds the frame of one camera. thread-safe, called from the camera stacks.
+  void add(const SSL_DetectionFrame & frame);
+};
+
+/*!
+  \class   PluginFrameAggregator
+  \brief   Hands the detection frame of a single camera stack to the shared FrameAggregator
+*/
+class PluginFrameAggregator : public VisionPlugin
+{
+protected:
+  FrameAggregator * _aggregator;
+public:
+  PluginFrameAggregator(FrameBuffer * _fb, FrameAggregator * aggregator);
+  ~PluginFrameAggregator();
+
+  virtual ProcessResult process(FrameData * data, RenderOptions * options);
+  virtual string getName();
+};
+
+#endif
@@ -48,46 +48,26 @@ PluginLegacyPublishGeometry::PluginLegacyPublishGeometry(
     FrameBuffer* fb,
     RoboCupSSLServer* ds_udp_server_old,
     const RoboCupField& field) :
-    VisionPlugin(fb),
-    _ds_udp_server_old(ds_udp_server_old),
-    _field(field) {
-  setSharedAmongStacks(true);
-  _settings=new VarList("Publish Legacy Geometry");
-  _settings->addChild(_pub=new VarTrigger("Publish","Publish!"));
-  _settings->addChild(_pub_auto=new VarList("Auto Publish"));
-  _pub_auto->addChild(_pub_auto_enable=new VarBool("Enable",true));
-  _pub_auto->addChild(_pub_auto_interval=new VarDouble("Interval (seconds)",3.0));
-  last_t=0;
-  connect(_pub,SIGNAL(signalTriggered()),this,SLOT(slotPublishTriggered()));
-}
-
-void PluginLegacyPublishGeometry::addCameraParameters(CameraParameters * param) {
-  lock();
-  params.push_back(param);
-  unlock();
+    PluginPublishGeometry(fb, ds_udp_server_old, field,
+                          "Publish Legacy Geometry", 10015) {
 }
 
 PluginLegacyPublishGeometry::~PluginLegacyPublishGeometry() {
-  delete _settings;
-  delete _pub;
-}
-
-VarList * PluginLegacyPublishGeometry::getSettings() {
-  return _settings;
-}
-
-string PluginLegacyPublishGeometry::getName() {
-  return "Publish Geometry";
+  // The publisher thread calls serializeGeometry(), stop it before this
+  // part of the object goes away.
+  stopPublisher();
 }
 
-void PluginLegacyPublishGeometry::sendGeometry() {
+void PluginLegacyPublishGeometry::serializeGeometry(string & buffer) {
   // NOTE: The field dimensions are derived from one half irrespective of
   // the exact field half / end in question.
   SSL_GeometryFieldSize field;
   _field.toProtoBuffer(field);
 
+  RoboCup2014Legacy::Wrapper::SSL_WrapperPacket pkt;
   // Geometry data for double-sized field in old format.
-  RoboCup2014Legacy::Geometry::SSL_GeometryData ds_geodata_old;
+  RoboCup2014Legacy::Geometry::SSL_GeometryData & ds_geodata_old =
+      *pkt.mutable_geometry();
   // Field data for double-sized field in old format.
   RoboCup2014Legacy::Geometry::SSL_GeometryFieldSize ds_field_old;
 
@@ -118,7 +98,7 @@ void PluginLegacyPublishGeometry::sendGeometry() {
     params[i]->toProtoBuffer(*ds_calib_old,i);
   }
 
-  _ds_udp_server_old->sendLegacyMessage(ds_geodata_old);
+  pkt.SerializeToString(&buffer);
 }
 
 float PluginLegacyPublishGeometry::GetFieldLineLength(const string& line_name) {
@@ -142,24 +122,3 @@ float PluginLegacyPublishGeometry::GetFieldCircularArcRadius(
   if (arc == NULL) return 0;
   return (arc->radius->getDouble() + 0.5 * arc->thickness->getDouble());
 }
-
-void PluginLegacyPublishGeometry::slotPublishTriggered() {
-  lock();
-  sendGeometry();
-  unlock();
-}
-
-ProcessResult PluginLegacyPublishGeometry::process(FrameData * data, RenderOptions * options) {
-  (void)data;
-  (void)options;
-  //TODO: check client requests in server process
-  //      if requested, call sendGeometry();
-  if (_pub_auto_enable->getBool()==true) {
-    double t = data->time - last_t;
-    if (t > _pub_auto_interval->getDouble()) {
-      sendGeometry();
-      last_t=data->time;
-    }
-  }
-  return ProcessingOk;
-}
@@ -21,9 +21,7 @@
 #ifndef PLUGIN_LEGACYPUBLISHGEOMETRY_H
 #define PLUGIN_LEGACYPUBLISHGEOMETRY_H
 
-#include <visionplugin.h>
-#include "robocup_ssl_server.h"
-#include "camera_calibration.h"
+#include "plugin_publishgeometry.h"
 #include "messages_robocup_ssl_geometry_legacy.pb.h"
 #include "VarTypes.h"
 
@@ -35,34 +33,16 @@ const FieldCircularArc* GetFieldCircularArc(
     const string& arc_name,
     const vector<FieldCircularArc*>& field_arcs);
 
-class PluginLegacyPublishGeometry : public VisionPlugin
+class PluginLegacyPublishGeometry : public PluginPublishGeometry
 {
-Q_OBJECT
 protected:
-  // UDP Server for Double-Sized field, old protobuf format.
-  RoboCupSSLServer * _ds_udp_server_old;
-  const RoboCupField & _field;
-  vector<CameraParameters *> params;
-  VarList * _settings;
-  VarTrigger * _pub;
-  VarBool * _pub_auto_enable;
-  VarDouble * _pub_auto_interval;
-  VarList * _pub_auto;
-  QMutex mutex;
-  void sendGeometry();
-  double last_t;
-protected slots:
-  void slotPublishTriggered();
+  virtual void serializeGeometry(string & buffer);
 public:
   PluginLegacyPublishGeometry(FrameBuffer* fb,
                               RoboCupSSLServer* ds_udp_server_old,
                               const RoboCupField& field);
-  void addCameraParameters(CameraParameters * param);
-  virtual VarList * getSettings();
   virtual ~PluginLegacyPublishGeometry();
 
-  virtual string getName();
-  virtual ProcessResult process(FrameData * data, RenderOptions * options);
   float GetFieldCircularArcRadius(const string& arc_name);
   float GetFieldLineLength(const string& line_name);
   float GetFieldLineThickness(const string& line_name);
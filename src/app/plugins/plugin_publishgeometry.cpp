@@ -19,29 +19,116 @@
 */
 //========================================================================
 #include "plugin_publishgeometry.h"
+#include "timer.h"
+#include <unistd.h>
 
-PluginPublishGeometry::PluginPublishGeometry(FrameBuffer * fb, RoboCupSSLServer * server, const RoboCupField & field)
+GeometryPublisherThread::GeometryPublisherThread(PluginPublishGeometry * plugin)
+{
+  _plugin=plugin;
+  _shutdown=false;
+}
+
+void GeometryPublisherThread::stop() {
+  _shutdown=true;
+  wait();
+}
+
+void GeometryPublisherThread::run() {
+  while(!_shutdown) {
+    bool requested=_plugin->waitForRequest(PollInterval);
+    if (_shutdown) break;
+    _plugin->publish(requested);
+  }
+}
+
+PluginPublishGeometry::PluginPublishGeometry(FrameBuffer * fb, RoboCupSSLServer * server, const RoboCupField & field,
+                                             const string & settings_name, int request_port)
  : VisionPlugin(fb), _field(field)
 {
   _server=server;
+  _stream_server=0;
   setSharedAmongStacks(true);
-  _settings=new VarList("Publish Geometry");
+  _settings=new VarList(settings_name);
   _settings->addChild(_pub=new VarTrigger("Publish","Publish!"));
   _settings->addChild(_pub_auto=new VarList("Auto Publish"));
   _pub_auto->addChild(_pub_auto_enable=new VarBool("Enable",true));
   _pub_auto->addChild(_pub_auto_interval=new VarDouble("Interval (seconds)",3.0));
+  _settings->addChild(_requests=new VarList("Client Requests"));
+  _requests->addChild(_requests_enable=new VarBool("Enable",true));
+  _requests->addChild(_request_port=new VarInt("Request Port",request_port));
+  _requests->addChild(_requests_served=new VarInt("Requests Served",0));
+  _requests_served->addFlags(VARTYPE_FLAG_READONLY | VARTYPE_FLAG_NOSTORE);
   last_t=0;
+  _geometry_valid=false;
+  _open_request_port=-1;
+  _publisher=0;
   connect(_pub,SIGNAL(signalTriggered()),this,SLOT(slotPublishTriggered()));
+
+  //field lines and arcs are created and destroyed at runtime,
+  //so keep the notifier in sync with the field's lists:
+  _notifier.addRecursive(_field.getSettings());
+  connect(_field.field_lines_list,SIGNAL(childAdded(VarType *)),this,SLOT(slotFieldMarkingAdded(VarType *)));
+  connect(_field.field_lines_list,SIGNAL(childRemoved(VarType *)),this,SLOT(slotFieldMarkingRemoved(VarType *)));
+  connect(_field.field_arcs_list,SIGNAL(childAdded(VarType *)),this,SLOT(slotFieldMarkingAdded(VarType *)));
+  connect(_field.field_arcs_list,SIGNAL(childRemoved(VarType *)),this,SLOT(slotFieldMarkingRemoved(VarType *)));
+}
+
+void PluginPublishGeometry::trackCameraParameters(CameraParameters * param) {
+  _notifier.addItem(param->focal_length);
+  _notifier.addItem(param->principal_point_x);
+  _notifier.addItem(param->principal_point_y);
+  _notifier.addItem(param->distortion);
+  _notifier.addItem(param->q0);
+  _notifier.addItem(param->q1);
+  _notifier.addItem(param->q2);
+  _notifier.addItem(param->q3);
+  _notifier.addItem(param->tx);
+  _notifier.addItem(param->ty);
+  _notifier.addItem(param->tz);
 }
 
 void PluginPublishGeometry::addCameraParameters(CameraParameters * param) {
   lock();
   params.push_back(param);
+  trackCameraParameters(param);
+  _geometry_valid=false;
   unlock();
 }
 
+void PluginPublishGeometry::setStreamServer(RoboCupSSLStreamServer * stream_server) {
+  lock();
+  _stream_server=stream_server;
+  unlock();
+}
+
+void PluginPublishGeometry::slotFieldMarkingAdded(VarType * item) {
+  _notifier.addRecursive(item);
+  _notifier.setChanged(true);
+}
+
+void PluginPublishGeometry::slotFieldMarkingRemoved(VarType * item) {
+  //called before the marking gets deleted:
+  _notifier.removeRecursive(item);
+  _notifier.setChanged(true);
+}
+
+void PluginPublishGeometry::startPublisher() {
+  if (_publisher!=0) return;
+  _publisher=new GeometryPublisherThread(this);
+  _publisher->start();
+}
+
+void PluginPublishGeometry::stopPublisher() {
+  if (_publisher==0) return;
+  _publisher->stop();
+  delete _publisher;
+  _publisher=0;
+}
+
 PluginPublishGeometry::~PluginPublishGeometry()
 {
+  stopPublisher();
+  _request_socket.close();
   delete _settings;
   delete _pub;
 }
@@ -54,15 +141,26 @@ string PluginPublishGeometry::getName() {
   return "Publish Geometry";
 }
 
-void PluginPublishGeometry::sendGeometry() {
-  SSL_GeometryData geodata;
-  SSL_GeometryFieldSize * gfield = geodata.mutable_field();
+void PluginPublishGeometry::serializeGeometry(string & buffer) {
+  SSL_WrapperPacket pkt;
+  SSL_GeometryData * geodata = pkt.mutable_geometry();
+  SSL_GeometryFieldSize * gfield = geodata->mutable_field();
   _field.toProtoBuffer(*gfield);
   for (unsigned int i = 0; i < params.size(); i++) {
-    SSL_GeometryCameraCalibration * calib = geodata.add_calib();
+    SSL_GeometryCameraCalibration * calib = geodata->add_calib();
     params[i]->toProtoBuffer(*calib,i);
   }
-  _server->send(geodata);
+  pkt.SerializeToString(&buffer);
+}
+
+void PluginPublishGeometry::sendGeometry() {
+  //hasChanged() must be called every time to reset the notifier:
+  if (_notifier.hasChanged() || _geometry_valid==false) {
+    serializeGeometry(_geometry_buffer);
+    _geometry_valid=true;
+  }
+  _server->sendSerialized(_geometry_buffer);
+  if (_stream_server!=0) _stream_server->sendSerialized(_geometry_buffer);
 }
 
 void PluginPublishGeometry::slotPublishTriggered() {
@@ -71,17 +169,49 @@ void PluginPublishGeometry::slotPublishTriggered() {
   unlock();
 }
 
+bool PluginPublishGeometry::waitForRequest(int timeout_ms) {
+  int port = _requests_enable->getBool() ? _request_port->getInt() : -1;
+  if (port!=_open_request_port) {
+    _request_socket.close();
+    _open_request_port=port;
+    if (port > 0 && _request_socket.open(port)==false) {
+      fprintf(stderr,"Unable to open geometry request port: %d\n",port);
+      fflush(stderr);
+    }
+  }
+  if (_request_socket.isOpen()==false) {
+    usleep(timeout_ms*1000);
+    return false;
+  }
+  if (_request_socket.wait(timeout_ms)==false) return false;
+
+  //the content of a request does not matter, drain all pending ones:
+  char buf[256];
+  Net::Address src;
+  bool requested=false;
+  while (_request_socket.recv(buf,sizeof(buf),src) >= 0) {
+    requested=true;
+  }
+  return requested;
+}
+
+void PluginPublishGeometry::publish(bool requested) {
+  double t=GetTimeSec();
+  bool auto_due=(_pub_auto_enable->getBool()==true && t - last_t > _pub_auto_interval->getDouble());
+  if (requested==false && auto_due==false) return;
+  if (_server->isOpen()==false) return;
+  lock();
+    sendGeometry();
+  unlock();
+  last_t=t;
+  if (requested) {
+    _requests_served->setInt(_requests_served->getInt()+1);
+  }
+}
+
 ProcessResult PluginPublishGeometry::process(FrameData * data, RenderOptions * options) {
   (void)data;
   (void)options;
-  //TODO: check client requests in server process
-  //      if requested, call sendGeometry();
-  if (_pub_auto_enable->getBool()==true) {
-    double t = data->time - last_t;
-    if (t > _pub_auto_interval->getDouble()) {
-      sendGeometry();
-      last_t=data->time;
-    }
-  }
+  //sending happens in the GeometryPublisherThread.
   return ProcessingOk;
 }
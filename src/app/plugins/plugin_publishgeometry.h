@@ -22,10 +22,36 @@
 #define PLUGIN_PUBLISHGEOMETRY_H
 
 #include <visionplugin.h>
+#include <QThread>
 #include "robocup_ssl_server.h"
+#include "robocup_ssl_stream_server.h"
 #include "camera_calibration.h"
+#include "netraw.h"
 #include "messages_robocup_ssl_geometry.pb.h"
 #include "VarTypes.h"
+#include "VarNotifier.h"
+
+class PluginPublishGeometry;
+
+/*!
+  \class   GeometryPublisherThread
+  \brief   Sends the cached geometry packet of a PluginPublishGeometry
+           outside of the camera threads.
+
+  The thread wakes up whenever a client request datagram arrives and at
+  least every PollInterval milliseconds to handle auto publishing.
+*/
+class GeometryPublisherThread : public QThread
+{
+protected:
+  PluginPublishGeometry * _plugin;
+  volatile bool _shutdown;
+  virtual void run();
+public:
+  static const int PollInterval = 100;
+  GeometryPublisherThread(PluginPublishGeometry * plugin);
+  void stop();
+};
 
 /**
 	@author Author Name
@@ -33,8 +59,10 @@
 class PluginPublishGeometry : public VisionPlugin
 {
 Q_OBJECT
+friend class GeometryPublisherThread;
 protected:
   RoboCupSSLServer * _server;
+  RoboCupSSLStreamServer * _stream_server;
   const RoboCupField & _field;
   vector<CameraParameters *> params;
   VarList * _settings;
@@ -42,14 +70,44 @@ protected:
   VarBool * _pub_auto_enable;
   VarDouble * _pub_auto_interval;
   VarList * _pub_auto;
+  VarList * _requests;
+  VarBool * _requests_enable;
+  VarInt * _request_port;
+  VarInt * _requests_served;
   QMutex mutex;
+
+  //the serialized packet is only rebuilt when the field or one of the
+  //camera calibrations changed:
+  VarNotifier _notifier;
+  string _geometry_buffer;
+  bool _geometry_valid;
+
+  //clients may ask for the geometry by sending any datagram to this socket:
+  Net::UDP _request_socket;
+  int _open_request_port;
+
+  GeometryPublisherThread * _publisher;
   void sendGeometry();
   double last_t;
+
+  /// serializes the complete packet that is sent on _server
+  virtual void serializeGeometry(string & buffer);
+
+  void trackCameraParameters(CameraParameters * param);
+  bool waitForRequest(int timeout_ms);
+  void publish(bool requested);
 protected slots:
   void slotPublishTriggered();
+  void slotFieldMarkingAdded(VarType * item);
+  void slotFieldMarkingRemoved(VarType * item);
 public:
-    PluginPublishGeometry(FrameBuffer * fb, RoboCupSSLServer * server, const RoboCupField & field);
+    PluginPublishGeometry(FrameBuffer * fb, RoboCupSSLServer * server, const RoboCupField & field,
+                          const string & settings_name="Publish Geometry", int request_port=10016);
     void addCameraParameters(CameraParameters * param);
+    /// the geometry is also sent to the subscribers of this stream server
+    void setStreamServer(RoboCupSSLStreamServer * stream_server);
+    void startPublisher();
+    void stopPublisher();
     virtual VarList * getSettings();
     virtual ~PluginPublishGeometry();
 
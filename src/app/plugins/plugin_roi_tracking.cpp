@@ -0,0 +1,289 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    plugin_roi_tracking.cpp
+  \brief   C++ Implementation: plugin_roi_tracking
+  \author  Author Name, 2026
+*/
+//========================================================================
+#include "plugin_roi_tracking.h"
+#include <math.h>
+
+ROITracker::ROITracker()
+{
+  _settings=new VarList("ROI Tracking");
+  _settings->addChild(_v_enable=new VarBool("enable",false));
+  _settings->addChild(_v_full_scan_interval=new VarInt("full scan interval (frames)",10,1));
+  _settings->addChild(_v_robot_window=new VarDouble("robot window radius (pixels)",40.0,0.0));
+  _settings->addChild(_v_ball_window=new VarDouble("ball window radius (pixels)",20.0,0.0));
+  _settings->addChild(_v_max_track_age=new VarDouble("max track age (s)",0.1,0.0));
+
+  _settings->addChild(_statistics=new VarList("Statistics"));
+  _statistics->addFlags(VARTYPE_FLAG_NOSTORE);
+  _statistics->addChild(_v_frames=new VarInt("Frames",0));
+  _statistics->addChild(_v_full_scans=new VarInt("Full Scans",0));
+  _statistics->addChild(_v_full_scan_rate=new VarDouble("Full Scan Rate",0.0));
+  _statistics->addChild(_v_hits=new VarInt("Track Hits",0));
+  _statistics->addChild(_v_misses=new VarInt("Track Misses",0));
+  _statistics->addChild(_v_hit_rate=new VarDouble("Hit Rate",0.0));
+  _statistics->addChild(_v_coverage=new VarDouble("Mean Image Coverage",0.0));
+  _v_frames->addFlags(VARTYPE_FLAG_READONLY);
+  _v_full_scans->addFlags(VARTYPE_FLAG_READONLY);
+  _v_full_scan_rate->addFlags(VARTYPE_FLAG_READONLY);
+  _v_hits->addFlags(VARTYPE_FLAG_READONLY);
+  _v_misses->addFlags(VARTYPE_FLAG_READONLY);
+  _v_hit_rate->addFlags(VARTYPE_FLAG_READONLY);
+  _v_coverage->addFlags(VARTYPE_FLAG_READONLY);
+
+  track_lost=false;
+  full_scan=true;
+  frames_since_full_scan=0;
+  frames=0;
+  full_scans=0;
+  hits=0;
+  misses=0;
+  coverage_sum=0.0;
+}
+
+ROITracker::~ROITracker()
+{
+  delete _settings;
+}
+
+VarList * ROITracker::getSettings() {
+  return _settings;
+}
+
+void ROITracker::predict(double time, int width, int height, CMVision::ROIList & rois) {
+  if (_v_enable->getBool()==false) {
+    tracks.clear();
+    full_scan=true;
+    rois.setFullFrame();
+    return;
+  }
+
+  //tracks that are too old to extrapolate (or from the future, after a
+  //rewind) are lost:
+  double max_age=_v_max_track_age->getDouble();
+  for (unsigned int i=0;i<tracks.size();) {
+    double dt=time-tracks[i].t;
+    if (dt < 0.0 || dt > max_age) {
+      tracks[i]=tracks.back();
+      tracks.pop_back();
+      track_lost=true;
+    } else {
+      i++;
+    }
+  }
+
+  double robot_window=_v_robot_window->getDouble();
+  double ball_window=_v_ball_window->getDouble();
+  for (unsigned int i=0;i<tracks.size();i++) {
+    Track & track=tracks[i];
+    double dt=time-track.t;
+    track.pred_x=track.x+track.vx*dt;
+    track.pred_y=track.y+track.vy*dt;
+    //the window grows with the extrapolated distance, as the velocity is
+    //only a two-frame estimate:
+    track.half_size=(track.type==TrackBall ? ball_window : robot_window) +
+                    0.5*sqrt(track.vx*track.vx+track.vy*track.vy)*dt;
+  }
+
+  full_scan=tracks.empty() || track_lost || frames_since_full_scan+1 >= _v_full_scan_interval->getInt();
+  frames++;
+  if (full_scan) {
+    rois.setFullFrame();
+    frames_since_full_scan=0;
+    track_lost=false;
+    full_scans++;
+    coverage_sum+=1.0;
+  } else {
+    rois.clear();
+    double area=0.0;
+    for (unsigned int i=0;i<tracks.size();i++) {
+      const Track & track=tracks[i];
+      int x1=(int)floor(track.pred_x-track.half_size);
+      int y1=(int)floor(track.pred_y-track.half_size);
+      int x2=(int)ceil(track.pred_x+track.half_size);
+      int y2=(int)ceil(track.pred_y+track.half_size);
+      rois.add(x1,y1,x2,y2);
+      int w=min(x2,width-1)-max(x1,0)+1;
+      int h=min(y2,height-1)-max(y1,0)+1;
+      if (w > 0 && h > 0) area+=(double)w*h;
+    }
+    frames_since_full_scan++;
+    coverage_sum+=(width > 0 && height > 0) ? min(1.0,area/((double)width*height)) : 1.0;
+  }
+  updateStatistics();
+}
+
+void ROITracker::updateTrack(TrackType type, int id, double x, double y, double time) {
+  Track * best=0;
+  double best_dist=0.0;
+  for (unsigned int i=0;i<tracks.size();i++) {
+    Track & track=tracks[i];
+    if (track.matched || track.type!=type) continue;
+    if (id >= 0 && track.id >= 0) {
+      //identified robots only match their own track:
+      if (track.id==id) {
+        best=&track;
+        break;
+      }
+      continue;
+    }
+    double d=sqrt((x-track.pred_x)*(x-track.pred_x)+(y-track.pred_y)*(y-track.pred_y));
+    if (d <= track.half_size && (best==0 || d < best_dist)) {
+      best=&track;
+      best_dist=d;
+    }
+  }
+
+  if (best!=0) {
+    double dt=time-best->t;
+    if (dt > 0.0) {
+      best->vx=(x-best->x)/dt;
+      best->vy=(y-best->y)/dt;
+    }
+    best->x=x;
+    best->y=y;
+    best->t=time;
+    if (id >= 0) best->id=id;
+    best->matched=true;
+    if (!full_scan) hits++;
+  } else {
+    Track track;
+    track.type=type;
+    track.id=id;
+    track.x=track.pred_x=x;
+    track.y=track.pred_y=y;
+    track.vx=0.0;
+    track.vy=0.0;
+    track.t=time;
+    track.half_size=0.0;
+    track.matched=true;
+    tracks.push_back(track);
+  }
+}
+
+void ROITracker::update(double time, const SSL_DetectionFrame & detection) {
+  if (_v_enable->getBool()==false) return;
+
+  unsigned int num_predicted=tracks.size();
+  for (unsigned int i=0;i<num_predicted;i++) {
+    tracks[i].matched=false;
+  }
+
+  for (int i=0;i<detection.balls_size();i++) {
+    const SSL_DetectionBall & ball=detection.balls(i);
+    updateTrack(TrackBall,-1,ball.pixel_x(),ball.pixel_y(),time);
+  }
+  for (int i=0;i<detection.robots_blue_size();i++) {
+    const SSL_DetectionRobot & robot=detection.robots_blue(i);
+    updateTrack(TrackRobotBlue,robot.has_robot_id() ? (int)robot.robot_id() : -1,robot.pixel_x(),robot.pixel_y(),time);
+  }
+  for (int i=0;i<detection.robots_yellow_size();i++) {
+    const SSL_DetectionRobot & robot=detection.robots_yellow(i);
+    updateTrack(TrackRobotYellow,robot.has_robot_id() ? (int)robot.robot_id() : -1,robot.pixel_x(),robot.pixel_y(),time);
+  }
+
+  //predicted tracks that were not detected again are dropped. Within the
+  //windows that is a miss, and the next frame has to search everywhere:
+  unsigned int kept=0;
+  for (unsigned int i=0;i<tracks.size();i++) {
+    if (i < num_predicted && tracks[i].matched==false) {
+      if (!full_scan) {
+        misses++;
+        track_lost=true;
+      }
+      continue;
+    }
+    tracks[kept++]=tracks[i];
+  }
+  tracks.resize(kept);
+  updateStatistics();
+}
+
+void ROITracker::updateStatistics() {
+  _v_frames->setInt((int)frames);
+  _v_full_scans->setInt((int)full_scans);
+  _v_full_scan_rate->setDouble(frames > 0 ? (double)full_scans/frames : 0.0);
+  _v_hits->setInt((int)hits);
+  _v_misses->setInt((int)misses);
+  _v_hit_rate->setDouble(hits+misses > 0 ? (double)hits/(hits+misses) : 0.0);
+  _v_coverage->setDouble(getMeanCoverage());
+}
+
+PluginROIPrediction::PluginROIPrediction(FrameBuffer * _buffer, ROITracker * _tracker)
+ : VisionPlugin(_buffer)
+{
+  tracker=_tracker;
+}
+
+PluginROIPrediction::~PluginROIPrediction()
+{
+}
+
+ProcessResult PluginROIPrediction::process(FrameData * data, RenderOptions * options) {
+  (void)options;
+
+  CMVision::ROIList * rois;
+  if ((rois=(CMVision::ROIList *)data->map.get("cmv_rois")) == 0) {
+    rois=(CMVision::ROIList *)data->map.insert("cmv_rois",new CMVision::ROIList());
+  }
+
+  tracker->predict(data->time,data->video.getWidth(),data->video.getHeight(),*rois);
+
+  return ProcessingOk;
+}
+
+VarList * PluginROIPrediction::getSettings() {
+  return tracker->getSettings();
+}
+
+string PluginROIPrediction::getName() {
+  return "ROIPrediction";
+}
+
+PluginROIUpdate::PluginROIUpdate(FrameBuffer * _buffer, ROITracker * _tracker)
+ : VisionPlugin(_buffer)
+{
+  tracker=_tracker;
+}
+
+PluginROIUpdate::~PluginROIUpdate()
+{
+}
+
+ProcessResult PluginROIUpdate::process(FrameData * data, RenderOptions * options) {
+  (void)options;
+
+  SSL_DetectionFrame * detection_frame=(SSL_DetectionFrame *)data->map.get("ssl_detection_frame");
+  if (detection_frame==0) {
+    printf("error in ROI update plugin: no detection frame was found!\n");
+    return ProcessingFailed;
+  }
+
+  tracker->update(data->time,*detection_frame);
+
+  return ProcessingOk;
+}
+
+VarList * PluginROIUpdate::getSettings() {
+  return 0;
+}
+
+string PluginROIUpdate::getName() {
+  return "ROIUpdate";
+}
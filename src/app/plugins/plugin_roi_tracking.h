@@ -0,0 +1,167 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    plugin_roi_tracking.h
+  \brief   C++ Interface: plugin_roi_tracking
+  \author  Author Name, 2026
+*/
+//========================================================================
+#ifndef PLUGIN_ROI_TRACKING_H
+#define PLUGIN_ROI_TRACKING_H
+
+#include <visionplugin.h>
+#include <vector>
+#include "cmvision_roi.h"
+#include "messages_robocup_ssl_detection.pb.h"
+
+/*!
+  \class   ROITracker
+  \brief   Predicts the image windows of a camera's next frame from its last detections
+
+  The tracker keeps the image position and velocity of every ball and
+  robot detected in the camera's previous frame. Before a frame is
+  segmented, it predicts where these objects are now and restricts
+  thresholding and runlength encoding to windows around the predictions.
+  The whole frame is scanned every few frames, whenever a tracked object
+  was not found in its window, and whenever there is nothing to track,
+  so new objects still get picked up.
+
+  One tracker belongs to one camera stack. PluginROIPrediction runs it
+  before segmentation and PluginROIUpdate feeds it the frame's
+  detections after detection.
+*/
+class ROITracker
+{
+public:
+  enum TrackType {
+    TrackBall=0,
+    TrackRobotBlue,
+    TrackRobotYellow
+  };
+
+  class Track {
+  public:
+    TrackType type;
+    int id; //robot id, or -1 if unknown or a ball
+    double x; //last detected image position in pixels
+    double y;
+    double vx; //image velocity in pixels per second
+    double vy;
+    double t; //time of the last detection
+    double pred_x; //predicted position in the current frame
+    double pred_y;
+    double half_size; //half size of the window around the prediction
+    bool matched;
+  };
+
+protected:
+  VarList * _settings;
+  VarBool * _v_enable;
+  VarInt * _v_full_scan_interval;
+  VarDouble * _v_robot_window;
+  VarDouble * _v_ball_window;
+  VarDouble * _v_max_track_age;
+  VarList * _statistics;
+  VarInt * _v_frames;
+  VarInt * _v_full_scans;
+  VarInt * _v_hits;
+  VarInt * _v_misses;
+  VarDouble * _v_full_scan_rate;
+  VarDouble * _v_hit_rate;
+  VarDouble * _v_coverage;
+
+  std::vector<Track> tracks;
+  bool track_lost;
+  bool full_scan; //whether the current frame is scanned completely
+  int frames_since_full_scan;
+
+  long long frames;
+  long long full_scans;
+  long long hits;
+  long long misses;
+  double coverage_sum;
+
+  void updateTrack(TrackType type, int id, double x, double y, double time);
+  void updateStatistics();
+
+public:
+  ROITracker();
+  ~ROITracker();
+
+  VarList * getSettings();
+
+  /// predicts the tracks for a frame taken at \p time and fills \p rois with
+  /// either their windows or a full-frame request for a video of the given size.
+  void predict(double time, int width, int height, CMVision::ROIList & rois);
+  /// matches the frame's detections against the predicted tracks.
+  void update(double time, const SSL_DetectionFrame & detection);
+
+  long long getFrames() const {
+    return frames;
+  }
+  long long getFullScans() const {
+    return full_scans;
+  }
+  long long getHits() const {
+    return hits;
+  }
+  long long getMisses() const {
+    return misses;
+  }
+  /// mean fraction of the video covered by windows, over all frames
+  double getMeanCoverage() const {
+    return frames > 0 ? coverage_sum / frames : 1.0;
+  }
+};
+
+/**
+  Puts the ROI tracker's windows for the frame into the data map as "cmv_rois".
+*/
+class PluginROIPrediction : public VisionPlugin
+{
+protected:
+  ROITracker * tracker;
+public:
+    PluginROIPrediction(FrameBuffer * _buffer, ROITracker * _tracker);
+
+    ~PluginROIPrediction();
+
+    virtual ProcessResult process(FrameData * data, RenderOptions * options);
+
+    virtual VarList * getSettings();
+
+    virtual string getName();
+};
+
+/**
+  Feeds the frame's "ssl_detection_frame" back into the ROI tracker.
+*/
+class PluginROIUpdate : public VisionPlugin
+{
+protected:
+  ROITracker * tracker;
+public:
+    PluginROIUpdate(FrameBuffer * _buffer, ROITracker * _tracker);
+
+    ~PluginROIUpdate();
+
+    virtual ProcessResult process(FrameData * data, RenderOptions * options);
+
+    virtual VarList * getSettings();
+
+    virtual string getName();
+};
+
+#endif
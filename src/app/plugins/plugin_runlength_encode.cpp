@@ -47,8 +47,12 @@ ProcessResult PluginRunlengthEncode::process(FrameData * data, RenderOptions * o
     return ProcessingFailed;
   }
 
+  //rows outside the windows of the ROI tracking are known to be clear:
+  const CMVision::ROIList * rois=(CMVision::ROIList *)data->map.get("cmv_rois");
+  if (rois!=0 && rois->isFullFrame()) rois=0;
+
   //Runlength Encode the image:
-  CMVision::RegionProcessing::encodeRuns(img_thresholded, runlist);
+  CMVision::RegionProcessing::encodeRuns(img_thresholded, runlist, rois);
   if (runlist->getUsedRuns() == runlist->getMaxRuns()) {
     printf("Warning: runlength encoder exceeded current max run size of %d\n",runlist->getMaxRuns());
   }
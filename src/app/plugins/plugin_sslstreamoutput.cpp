@@ -0,0 +1,168 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    plugin_sslstreamoutput.cpp
+  \brief   C++ Implementation: plugin_sslstreamoutput
+  \author  Author Name, 2026
+*/
+//========================================================================
+#include "plugin_sslstreamoutput.h"
+
+const double PluginSSLStreamOutputSettings::StatisticsInterval = 0.5;
+
+PluginSSLStreamOutputSettings::PluginSSLStreamOutputSettings()
+{
+  settings = new VarList("Stream Output");
+
+  settings->addChild(tcp_enable = new VarBool("Enable TCP",false));
+  settings->addChild(tcp_port = new VarInt("TCP Port",10030,1,65535));
+  settings->addChild(unix_enable = new VarBool("Enable Unix Socket",false));
+  settings->addChild(unix_path = new VarString("Unix Socket Path","/tmp/ssl-vision.sock"));
+  settings->addChild(queue_limit = new VarInt("Queue Limit per Subscriber (KB)",1024,1));
+  settings->addChild(stall_timeout = new VarDouble("Drop Stalled Subscriber after (s)",1.0,0.0));
+
+  settings->addChild(statistics = new VarList("Statistics"));
+  statistics->addFlags(VARTYPE_FLAG_NOSTORE);
+  statistics->addChild(dropped_subscribers = new VarInt("Dropped Slow Subscribers",0));
+  statistics->addChild(connected_subscribers = new VarInt("Connected Subscribers",0));
+  statistics->addChild(subscribers = new VarList("Subscribers"));
+  dropped_subscribers->addFlags(VARTYPE_FLAG_READONLY);
+  connected_subscribers->addFlags(VARTYPE_FLAG_READONLY);
+
+  char name[32];
+  for (int i=0;i<ListedSubscribers;i++) {
+    snprintf(name,sizeof(name),"Subscriber %d",i+1);
+    createSubscriberVars(subscriber_vars[i],name);
+  }
+  createSubscriberVars(overflow_vars,"More Subscribers");
+
+  last_stats_update=0.0;
+}
+
+void PluginSSLStreamOutputSettings::createSubscriberVars(SubscriberVars & v, const char * name)
+{
+  v.list=new VarList(name);
+  v.list->addChild(v.peer=new VarString("Peer",""));
+  v.list->addChild(v.queued_bytes=new VarInt("Queued Bytes",0));
+  v.list->addChild(v.queued_packets=new VarInt("Queued Packets",0));
+  v.list->addChild(v.sent_packets=new VarInt("Sent Packets",0));
+  v.list->addChild(v.dropped_packets=new VarInt("Dropped Packets",0));
+  v.list->addFlags(VARTYPE_FLAG_READONLY);
+  v.peer->addFlags(VARTYPE_FLAG_READONLY);
+  v.queued_bytes->addFlags(VARTYPE_FLAG_READONLY);
+  v.queued_packets->addFlags(VARTYPE_FLAG_READONLY);
+  v.sent_packets->addFlags(VARTYPE_FLAG_READONLY);
+  v.dropped_packets->addFlags(VARTYPE_FLAG_READONLY);
+  subscribers->addChild(v.list);
+}
+
+PluginSSLStreamOutputSettings::~PluginSSLStreamOutputSettings()
+{
+  delete settings;
+}
+
+VarList * PluginSSLStreamOutputSettings::getSettings()
+{
+  return settings;
+}
+
+void PluginSSLStreamOutputSettings::updateStatistics(RoboCupSSLStreamServer * server)
+{
+  //called by all camera threads, only one of them needs to do the work:
+  if (!stats_mutex.tryLock()) return;
+  double now=GetTimeSec();
+  if (now - last_stats_update < StatisticsInterval) {
+    stats_mutex.unlock();
+    return;
+  }
+  last_stats_update=now;
+
+  server->getSubscriberStats(stats);
+  dropped_subscribers->setInt(server->getDisconnectedSlowCount());
+  connected_subscribers->setInt(stats.size());
+
+  //only values change here, the items themselves belong to the GUI thread:
+  for (int i=0;i<ListedSubscribers;i++) {
+    SubscriberVars & v=subscriber_vars[i];
+    if (i < (int)stats.size()) {
+      const RoboCupSSLStreamServer::SubscriberStats & st=stats[i];
+      v.peer->setString(st.peer);
+      v.queued_bytes->setInt(st.queued_bytes);
+      v.queued_packets->setInt(st.queued_packets);
+      v.sent_packets->setInt(st.sent_packets);
+      v.dropped_packets->setInt(st.dropped_packets);
+    } else {
+      v.peer->setString("");
+      v.queued_bytes->setInt(0);
+      v.queued_packets->setInt(0);
+      v.sent_packets->setInt(0);
+      v.dropped_packets->setInt(0);
+    }
+  }
+
+  //the sums of the subscribers that did not fit into the list:
+  int more=0;
+  int queued_bytes=0;
+  int queued_packets=0;
+  int sent_packets=0;
+  int dropped_packets=0;
+  for (unsigned int i=ListedSubscribers;i<stats.size();i++) {
+    const RoboCupSSLStreamServer::SubscriberStats & st=stats[i];
+    more++;
+    queued_bytes+=st.queued_bytes;
+    queued_packets+=st.queued_packets;
+    sent_packets+=st.sent_packets;
+    dropped_packets+=st.dropped_packets;
+  }
+  char peer[32]="";
+  if (more > 0) snprintf(peer,sizeof(peer),"%d more",more);
+  overflow_vars.peer->setString(peer);
+  overflow_vars.queued_bytes->setInt(queued_bytes);
+  overflow_vars.queued_packets->setInt(queued_packets);
+  overflow_vars.sent_packets->setInt(sent_packets);
+  overflow_vars.dropped_packets->setInt(dropped_packets);
+  stats_mutex.unlock();
+}
+
+PluginSSLStreamOutput::PluginSSLStreamOutput(FrameBuffer * _fb, RoboCupSSLStreamServer * server, PluginSSLStreamOutputSettings * settings)
+ : VisionPlugin(_fb)
+{
+  _server=server;
+  _settings=settings;
+}
+
+PluginSSLStreamOutput::~PluginSSLStreamOutput()
+{
+}
+
+ProcessResult PluginSSLStreamOutput::process(FrameData * data, RenderOptions * options)
+{
+  (void)options;
+  if (data==0) return ProcessingFailed;
+
+  if (_settings->tcp_enable->getBool() || _settings->unix_enable->getBool()) {
+    SSL_DetectionFrame * detection_frame = 0;
+    detection_frame=(SSL_DetectionFrame *)data->map.get("ssl_detection_frame");
+    if (detection_frame != 0) {
+      _server->send(*detection_frame);
+    }
+    _settings->updateStatistics(_server);
+  }
+  return ProcessingOk;
+}
+
+string PluginSSLStreamOutput::getName() {
+  return "Stream Output";
+}
@@ -0,0 +1,102 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    plugin_sslstreamoutput.h
+  \brief   C++ Interface: plugin_sslstreamoutput
+  \author  Author Name, 2026
+*/
+//========================================================================
+#ifndef PLUGIN_SSLSTREAMOUTPUT_H
+#define PLUGIN_SSLSTREAMOUTPUT_H
+
+#include <visionplugin.h>
+#include <map>
+#include "robocup_ssl_stream_server.h"
+#include "timer.h"
+
+/*!
+  \class   PluginSSLStreamOutputSettings
+  \brief   Global settings and per-subscriber statistics of the TCP /
+           Unix domain socket stream output.
+
+  The statistics are updated by the camera threads, while the GUI holds
+  pointers to the items of the settings tree. The subscriber lists are
+  therefore a fixed pool that is created once and only ever changes
+  its values: a slot shows an empty peer when it is not in use.
+  Subscribers beyond the pool are summed up in a "More Subscribers"
+  entry, whose peer tells how many there are.
+*/
+class PluginSSLStreamOutputSettings {
+protected:
+  static const double StatisticsInterval;
+  static const int ListedSubscribers = 8;
+
+  struct SubscriberVars {
+    VarList * list;
+    VarString * peer;
+    VarInt * queued_bytes;
+    VarInt * queued_packets;
+    VarInt * sent_packets;
+    VarInt * dropped_packets;
+  };
+
+  QMutex stats_mutex;
+  double last_stats_update;
+  SubscriberVars subscriber_vars[ListedSubscribers];
+  SubscriberVars overflow_vars;
+  vector<RoboCupSSLStreamServer::SubscriberStats> stats;
+
+  void createSubscriberVars(SubscriberVars & v, const char * name);
+public:
+  VarList * settings;
+  VarBool * tcp_enable;
+  VarInt * tcp_port;
+  VarBool * unix_enable;
+  VarString * unix_path;
+  VarInt * queue_limit;
+  VarDouble * stall_timeout;
+  VarList * statistics;
+  VarInt * dropped_subscribers;
+  VarInt * connected_subscribers;
+  VarList * subscribers;
+
+  PluginSSLStreamOutputSettings();
+  ~PluginSSLStreamOutputSettings();
+  VarList * getSettings();
+
+  /// copies the server's subscriber statistics into the settings tree,
+  /// at most every StatisticsInterval seconds.
+  void updateStatistics(RoboCupSSLStreamServer * server);
+};
+
+/*!
+  \class   PluginSSLStreamOutput
+  \brief   Sends the detection frame of a camera to all stream subscribers.
+*/
+class PluginSSLStreamOutput : public VisionPlugin
+{
+protected:
+  RoboCupSSLStreamServer * _server;
+  PluginSSLStreamOutputSettings * _settings;
+public:
+    PluginSSLStreamOutput(FrameBuffer * _fb, RoboCupSSLStreamServer * server, PluginSSLStreamOutputSettings * settings);
+
+    ~PluginSSLStreamOutput();
+
+    virtual ProcessResult process(FrameData * data, RenderOptions * options);
+    virtual string getName();
+};
+
+#endif
@@ -28,7 +28,7 @@ typedef CameraParameters::AdditionalCalibrationInformation AddnlCalibInfo;
 PluginVisualize::PluginVisualize(
     FrameBuffer* _buffer, const CameraParameters& camera_params,
     const RoboCupField& real_field) :
-    VisionPlugin(_buffer), camera_parameters(camera_params),
+    VisionPlugin(_buffer), camera_parameters(camera_params), camera_model(0),
     real_field(real_field) {
   _v_enabled = new VarBool("enable", true);
   _v_image = new VarBool("image", true);
@@ -83,12 +83,18 @@ void PluginVisualize::DrawCameraImage(
         data->video.getData(),
         reinterpret_cast<unsigned char*>(vis_frame->data.getData()),
         data->video.getWidth(), data->video.getHeight());
+  } else if (source_format==COLOR_RAW8) {
+    //show the undemosaiced bayer mosaic as a grey image
+    Conversions::y2rgb(
+        data->video.getData(),
+        reinterpret_cast<unsigned char*>(vis_frame->data.getData()),
+        data->video.getWidth(), data->video.getHeight());
   } else {
     //blank it:
     vis_frame->data.fillBlack();
     fprintf(stderr, "Unable to visualize color format: %s\n",
             Colors::colorFormatToString(source_format).c_str());
-    fprintf(stderr, "Currently supported are rgb8 and yuv422 (UYVY).\n");
+    fprintf(stderr, "Currently supported are rgb8, yuv422 (UYVY) and raw8.\n");
     fprintf(stderr, "(Feel free to add more conversions to %s in %s).\n",
             __FUNCTION__, __FILE__);
   }
@@ -111,6 +117,8 @@ void PluginVisualize::DrawThresholdedImage(
         reinterpret_cast<Image<raw8>*>(data->map.get("cmv_threshold"));
     if (img_thresholded != 0) {
       int n = vis_frame->data.getNumPixels();
+      int scale = CMVisionThreshold::getLabelScale(
+          vis_frame->data.getWidth(), img_thresholded);
       if (img_thresholded->getNumPixels() == n) {
         rgb * vis_ptr = vis_frame->data.getPixelData();
         raw8 * seg_ptr = img_thresholded->getPixelData();
@@ -120,6 +128,26 @@ void PluginVisualize::DrawThresholdedImage(
                 seg_ptr[i].getIntensity()).draw_color;
           }
         }
+      } else if (scale > 1 &&
+                 img_thresholded->getHeight() * scale <=
+                 vis_frame->data.getHeight()) {
+        // reduced resolution labels (e.g. bayer quads): paint each label
+        // over the block of pixels it covers
+        int w = img_thresholded->getWidth();
+        int h = img_thresholded->getHeight();
+        int vis_w = vis_frame->data.getWidth();
+        rgb * vis_ptr = vis_frame->data.getPixelData();
+        raw8 * seg_ptr = img_thresholded->getPixelData();
+        for (int y = 0; y < h * scale; y++) {
+          raw8 * seg_row = seg_ptr + (y / scale) * w;
+          rgb * vis_row = vis_ptr + y * vis_w;
+          for (int x = 0; x < w * scale; x++) {
+            int label = seg_row[x / scale].getIntensity();
+            if (label != 0) {
+              vis_row[x] = _threshold_lut->getChannel(label).draw_color;
+            }
+          }
+        }
       }
     }
   }
@@ -161,8 +189,10 @@ void PluginVisualize::DrawCameraCalibration(
   // Principal point
   rgb ppoint_draw_color;
   ppoint_draw_color.set(255, 0, 0);
-  int x = camera_parameters.principal_point_x->getDouble();
-  int y = camera_parameters.principal_point_y->getDouble();
+  const GVector::vector2d<double> principal_point =
+      camera_model->getPrincipalPoint();
+  int x = principal_point.x;
+  int y = principal_point.y;
   vis_frame->data.drawFatLine(x-15, y-15, x+15, y+15, ppoint_draw_color);
   vis_frame->data.drawFatLine(x+15, y-15, x-15, y+15, ppoint_draw_color);
   // Calibration points
@@ -266,7 +296,7 @@ void PluginVisualize::DrawEdgeTangent(
   const GVector::vector3d<double> field_point_plus_tangent =
       field_point + 1000.0 * field_tangent;
   GVector::vector2d<double> image_point_plus_tangent(0.0, 0.0);
-  camera_parameters.field2image(
+  camera_model->field2image(
       field_point_plus_tangent, image_point_plus_tangent);
   const GVector::vector2d<double> edge_p1 =
       image_point + (image_point_plus_tangent - image_point).norm(6.0);
@@ -374,6 +404,14 @@ ProcessResult PluginVisualize::process(
       vis_frame->data.allocate(data->video.getWidth(), data->video.getHeight());
     }
 
+    // The calibration snapshot of this frame, or an own one if nobody took it
+    camera_model = reinterpret_cast<CameraModel*>(data->map.get("camera_model"));
+    if (camera_model == 0) {
+      fallback_camera_model.update(camera_parameters, data->video.getWidth(),
+                                   data->video.getHeight());
+      camera_model = &fallback_camera_model;
+    }
+
     // Draw camera image
     if (_v_image->getBool()) {
       DrawCameraImage(data, vis_frame);
@@ -430,13 +468,13 @@ void PluginVisualize::drawFieldArc(
   GVector::vector2d<double> lastInImage(0.0, 0.0);
   GVector::vector3d<double> lastInWorld =  center +
       radius * GVector::vector3d<double>(cos(theta1), sin(theta1), 0.0);
-  camera_parameters.field2image(lastInWorld, lastInImage);
+  camera_model->field2image(lastInWorld, lastInImage);
   for (int i = 1; i <= steps; ++i) {
     const double theta = theta1 + static_cast<double>(i) * delta;
     GVector::vector3d<double> nextInWorld =  center +
         radius * GVector::vector3d<double>(cos(theta), sin(theta), 0.0);
     GVector::vector2d<double> nextInImage(0.0, 0.0);
-    camera_parameters.field2image(nextInWorld, nextInImage);
+    camera_model->field2image(nextInWorld, nextInImage);
     rgb draw_color;
     draw_color.set(r,g,b);
     vis_frame->data.drawFatLine(
@@ -455,11 +493,11 @@ void PluginVisualize::drawFieldLine(
       (end - start) / static_cast<double>(steps);
   GVector::vector2d<double> lastInImage(0.0, 0.0);
   GVector::vector3d<double> lastInWorld(start);
-  camera_parameters.field2image(lastInWorld, lastInImage);
+  camera_model->field2image(lastInWorld, lastInImage);
   for (int i = 0; i < steps; ++i) {
     GVector::vector3d<double> nextInWorld = lastInWorld + delta;
     GVector::vector2d<double> nextInImage;
-    camera_parameters.field2image(nextInWorld, nextInImage);
+    camera_model->field2image(nextInWorld, nextInImage);
     rgb draw_color;
     draw_color.set(r,g,b);
     vis_frame->data.drawFatLine(
@@ -64,6 +64,9 @@ protected:
   VarBool * _v_detected_edges;
 
   const CameraParameters& camera_parameters;
+  // Snapshot of the calibration used for the frame being drawn
+  const CameraModel* camera_model;
+  CameraModel fallback_camera_model;
   const RoboCupField& real_field;
 
   LUT3D * _threshold_lut;
@@ -23,7 +23,11 @@
 MultiStackRoboCupSSL::MultiStackRoboCupSSL(RenderOptions * _opts, int cameras) :
     MultiVisionStack("RoboCup SSL Multi-Cam",_opts),
     ds_udp_server_new(NULL),
-    ds_udp_server_old(NULL) {
+    ds_udp_server_old(NULL),
+    aggregated_udp_server(NULL),
+    frame_aggregator(NULL),
+    stream_server(NULL),
+    stream_output_settings(NULL) {
   //add global field calibration parameter
   global_field = new RoboCupField();
   settings->addChild(global_field->getSettings());
@@ -72,6 +76,50 @@ MultiStackRoboCupSSL::MultiStackRoboCupSSL(RenderOptions * _opts, int cameras) :
 
   ds_udp_server_new = new RoboCupSSLServer(10006, "224.5.23.2");
   ds_udp_server_old = new RoboCupSSLServer(10005, "224.5.23.2");
+  aggregated_udp_server = new RoboCupSSLServer(10020, "224.5.23.2");
+
+  frame_aggregator = new FrameAggregator(aggregated_udp_server, cameras);
+  settings->addChild(frame_aggregator->getSettings());
+  connect(frame_aggregator->multicast_port,
+          SIGNAL(wasEdited(VarType *)),
+          this,
+          SLOT(RefreshAggregatedNetworkOutput()));
+  connect(frame_aggregator->multicast_address,
+          SIGNAL(wasEdited(VarType *)),
+          this,
+          SLOT(RefreshAggregatedNetworkOutput()));
+  connect(frame_aggregator->multicast_interface,
+          SIGNAL(wasEdited(VarType *)),
+          this,
+          SLOT(RefreshAggregatedNetworkOutput()));
+
+  stream_server = new RoboCupSSLStreamServer();
+  stream_output_settings = new PluginSSLStreamOutputSettings();
+  settings->addChild(stream_output_settings->getSettings());
+  connect(stream_output_settings->tcp_enable,
+          SIGNAL(wasEdited(VarType *)),
+          this,
+          SLOT(RefreshStreamOutput()));
+  connect(stream_output_settings->tcp_port,
+          SIGNAL(wasEdited(VarType *)),
+          this,
+          SLOT(RefreshStreamOutput()));
+  connect(stream_output_settings->unix_enable,
+          SIGNAL(wasEdited(VarType *)),
+          this,
+          SLOT(RefreshStreamOutput()));
+  connect(stream_output_settings->unix_path,
+          SIGNAL(wasEdited(VarType *)),
+          this,
+          SLOT(RefreshStreamOutput()));
+  connect(stream_output_settings->queue_limit,
+          SIGNAL(wasEdited(VarType *)),
+          this,
+          SLOT(RefreshStreamOutputLimits()));
+  connect(stream_output_settings->stall_timeout,
+          SIGNAL(wasEdited(VarType *)),
+          this,
+          SLOT(RefreshStreamOutputLimits()));
 
   global_plugin_publish_geometry = new  PluginPublishGeometry(
       0,
@@ -82,6 +130,9 @@ MultiStackRoboCupSSL::MultiStackRoboCupSSL(RenderOptions * _opts, int cameras) :
       0,
       ds_udp_server_old,
       *global_field);
+  global_plugin_publish_geometry->setStreamServer(stream_server);
+  global_plugin_publish_geometry->startPublisher();
+  legacy_plugin_publish_geometry->startPublisher();
 
   //add parameter for number of cameras
   createThreads(cameras);
@@ -100,6 +151,9 @@ MultiStackRoboCupSSL::MultiStackRoboCupSSL(RenderOptions * _opts, int cameras) :
             global_team_selector_yellow,
             ds_udp_server_new,
             ds_udp_server_old,
+            frame_aggregator,
+            stream_server,
+            stream_output_settings,
             "robocup-ssl-cam-" + QString::number(i).toStdString()));
   }
   //TODO: make LUT widgets aware of each other for easy data-sharing
@@ -110,10 +164,18 @@ string MultiStackRoboCupSSL::getSettingsFileName() {
 }
 
 MultiStackRoboCupSSL::~MultiStackRoboCupSSL() {
+  //the geometry publishers send from their own threads:
+  global_plugin_publish_geometry->stopPublisher();
+  legacy_plugin_publish_geometry->stopPublisher();
   stop();
   delete ds_udp_server_new;
   delete ds_udp_server_old;
+  delete frame_aggregator;
+  delete aggregated_udp_server;
+  delete stream_server;
+  delete stream_output_settings;
   delete global_plugin_publish_geometry;
+  delete legacy_plugin_publish_geometry;
   delete global_field;
   delete global_ball_settings;
 }
@@ -161,3 +223,39 @@ void MultiStackRoboCupSSL::RefreshNetworkOutput()
       ds_udp_server_new
   );
 }
+
+void MultiStackRoboCupSSL::RefreshAggregatedNetworkOutput()
+{
+  UpdateServerSettings(
+      frame_aggregator->multicast_port->getInt(),
+      frame_aggregator->multicast_address->getString(),
+      frame_aggregator->multicast_interface->getString(),
+      "FRAME AGGREGATION",
+      aggregated_udp_server
+  );
+}
+
+void MultiStackRoboCupSSL::RefreshStreamOutputLimits()
+{
+  stream_server->setQueueLimit(stream_output_settings->queue_limit->getInt() * 1024);
+  stream_server->setStallTimeout(stream_output_settings->stall_timeout->getDouble());
+}
+
+void MultiStackRoboCupSSL::RefreshStreamOutput()
+{
+  RefreshStreamOutputLimits();
+  int port = 0;
+  string path = "";
+  if (stream_output_settings->tcp_enable->getBool()) {
+    port = stream_output_settings->tcp_port->getInt();
+  }
+  if (stream_output_settings->unix_enable->getBool()) {
+    path = stream_output_settings->unix_path->getString();
+  }
+  if (port == 0 && path.length() == 0) {
+    stream_server->close();
+  } else if (stream_server->open(port, path) == false) {
+    fprintf(stderr, "ERROR WHEN TRYING TO OPEN STREAM OUTPUT SERVER!\n");
+    fflush(stderr);
+  }
+}
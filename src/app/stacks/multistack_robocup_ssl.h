@@ -26,6 +26,8 @@
 #include "stack_robocup_ssl.h"
 #include "plugin_detect_balls.h"
 #include "plugin_publishgeometry.h"
+#include "plugin_frameaggregator.h"
+#include "plugin_sslstreamoutput.h"
 #include "cmpattern_teamdetector.h"
 #include "robocup_ssl_server.h"
 #include "field.h"
@@ -53,6 +55,12 @@ class MultiStackRoboCupSSL : public QObject, public MultiVisionStack {
   RoboCupSSLServer * ds_udp_server_new;
   // UDP Server for Double-Sized field, old protobuf format.
   RoboCupSSLServer * ds_udp_server_old;
+  // UDP Server for the frame-synchronous, multi-camera output.
+  RoboCupSSLServer * aggregated_udp_server;
+  FrameAggregator * frame_aggregator;
+  // TCP / Unix domain socket stream output.
+  RoboCupSSLStreamServer * stream_server;
+  PluginSSLStreamOutputSettings * stream_output_settings;
   public:
   MultiStackRoboCupSSL(RenderOptions * _opts, int cameras);
   virtual string getSettingsFileName();
@@ -60,6 +68,9 @@ class MultiStackRoboCupSSL : public QObject, public MultiVisionStack {
   public slots:
   void RefreshNetworkOutput();
   void RefreshLegacyNetworkOutput();
+  void RefreshAggregatedNetworkOutput();
+  void RefreshStreamOutput();
+  void RefreshStreamOutputLimits();
   private:
   void UpdateServerSettings(const int port,
                             const string& address,
@@ -32,6 +32,9 @@ StackRoboCupSSL::StackRoboCupSSL(
     CMPattern::TeamSelector * _global_team_selector_yellow,
     RoboCupSSLServer * ds_udp_server_new,
     RoboCupSSLServer * ds_udp_server_old,
+    FrameAggregator * frame_aggregator,
+    RoboCupSSLStreamServer * stream_server,
+    PluginSSLStreamOutputSettings * stream_settings,
     string cam_settings_filename) :
     VisionStack("RoboCup Image Processing",_opts),
     _camera_id(camera_id),
@@ -62,6 +65,10 @@ StackRoboCupSSL::StackRoboCupSSL(
 
   stack.push_back(new PluginCameraCalibration(_fb,*camera_parameters, *global_field));
 
+  //restricts segmentation to windows around the last frame's detections:
+  roi_tracker = new ROITracker();
+  stack.push_back(new PluginROIPrediction(_fb,roi_tracker));
+
   stack.push_back(new PluginColorThreshold(_fb,lut_yuv));
 
   //initialize the runlength encoder...
@@ -74,8 +81,16 @@ StackRoboCupSSL::StackRoboCupSSL(
 
   stack.push_back(new PluginDetectRobots(_fb,lut_yuv,*camera_parameters,*global_field,global_team_selector_blue,global_team_selector_yellow));
 
+  //predicts the ball's search window from the previous frames' balls:
+  ball_tracker = new BallTracker();
+  stack.push_back(new PluginBallPrediction(_fb,ball_tracker,*camera_parameters,global_ball_settings));
+
   stack.push_back(new PluginDetectBalls(_fb,lut_yuv,*camera_parameters,*global_field,global_ball_settings));
 
+  stack.push_back(new PluginBallTracking(_fb,ball_tracker));
+
+  stack.push_back(new PluginROIUpdate(_fb,roi_tracker));
+
   stack.push_back(new PluginSSLNetworkOutput(
       _fb,
       _ds_udp_server_new,
@@ -88,6 +103,10 @@ StackRoboCupSSL::StackRoboCupSSL(
       *camera_parameters,
       *global_field));
 
+  stack.push_back(new PluginFrameAggregator(_fb, frame_aggregator));
+
+  stack.push_back(new PluginSSLStreamOutput(_fb, stream_server, stream_settings));
+
   stack.push_back(_global_plugin_publish_geometry);
   stack.push_back(_legacy_plugin_publish_geometry);
 
@@ -98,8 +117,19 @@ StackRoboCupSSL::StackRoboCupSSL(
 string StackRoboCupSSL::getSettingsFileName() {
   return _cam_settings_filename;
 }
+YUVLUT * StackRoboCupSSL::getLUT() const {
+  return lut_yuv;
+}
+ROITracker * StackRoboCupSSL::getROITracker() const {
+  return roi_tracker;
+}
+BallTracker * StackRoboCupSSL::getBallTracker() const {
+  return ball_tracker;
+}
 StackRoboCupSSL::~StackRoboCupSSL() {
   delete lut_yuv;
   delete camera_parameters;
+  delete roi_tracker;
+  delete ball_tracker;
 }
 
@@ -38,6 +38,10 @@
 #include "plugin_publishgeometry.h"
 #include "plugin_legacysslnetworkoutput.h"
 #include "plugin_legacypublishgeometry.h"
+#include "plugin_frameaggregator.h"
+#include "plugin_sslstreamoutput.h"
+#include "plugin_roi_tracking.h"
+#include "plugin_ball_tracking.h"
 #include "plugin_dvr.h"
 #include "cmpattern_teamdetector.h"
 #include "robocup_ssl_server.h"
@@ -68,6 +72,8 @@ class StackRoboCupSSL : public VisionStack {
   RoboCupSSLServer * _ds_udp_server_new;
   // UDP Server for Double-Sized field, old protobuf format.
   RoboCupSSLServer * _ds_udp_server_old;
+  ROITracker * roi_tracker;
+  BallTracker * ball_tracker;
   public:
   StackRoboCupSSL(RenderOptions* _opts,
                   FrameBuffer* _fb,
@@ -80,8 +86,14 @@ class StackRoboCupSSL : public VisionStack {
                   CMPattern::TeamSelector* _global_team_selector_yellow,
                   RoboCupSSLServer* ds_udp_server_new,
                   RoboCupSSLServer* ds_udp_server_old,
+                  FrameAggregator* frame_aggregator,
+                  RoboCupSSLStreamServer* stream_server,
+                  PluginSSLStreamOutputSettings* stream_settings,
                   string cam_settings_filename);
   virtual string getSettingsFileName();
+  YUVLUT * getLUT() const;
+  ROITracker * getROITracker() const;
+  BallTracker * getBallTracker() const;
   virtual ~StackRoboCupSSL();
 };
 
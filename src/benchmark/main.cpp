@@ -0,0 +1,1489 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    main.cpp
+  \brief   End-to-end latency benchmark: runs the full RoboCup SSL
+           multi-camera stack on generated or recorded frames and
+           receives its output on loopback.
+  \author  Author Name, 2026
+*/
+//========================================================================
+
+#include <QApplication>
+#include <QString>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include <map>
+#include "qgetopt.h"
+#include <QFileInfo>
+#include <math.h>
+#include "timer.h"
+#include "robocup_ssl_client.h"
+#include "robocup_ssl_server.h"
+#include "multistack_robocup_ssl.h"
+#include "conversions.h"
+#include "bayer.h"
+#include "cmvision_regiongrid.h"
+#include "cmvision_histogram.h"
+#include "cmvision_threshold.h"
+#include "cmvision_roi.h"
+#include "raw_video_file.h"
+#include "capture_videofile.h"
+#include <unistd.h>
+#include "plugin_detect_balls.h"
+
+struct BenchmarkResult {
+  int cameras;
+  double duration;
+  vector<double> latencies;
+  map<int,int> frames_per_camera;
+  int lost_frames;
+  //detection accuracy against the generator's ground truth:
+  int compared_frames;
+  int robots_expected;
+  int robots_found;
+  int robots_false;
+  double robot_error_sum;
+  double robot_error_max;
+  double orientation_error_sum;
+  int balls_expected;
+  int balls_found;
+  double ball_error_sum;
+  //ROI tracking, summed over all cameras:
+  long long roi_frames;
+  long long roi_full_scans;
+  long long roi_hits;
+  long long roi_misses;
+  double roi_coverage_sum;
+  //ball tracking, summed over all cameras:
+  long long ball_frames;
+  long long ball_windowed_frames;
+  long long ball_corrections;
+  long long ball_restarts;
+  long long ball_lost_tracks;
+  long long ball_dropped_tracks;
+};
+
+/// sets the string or number of a setting by its path below \p root,
+/// e.g. "Capture Control/Capture Module".
+static bool setSetting(VarType * root, const string & path, const string & value) {
+  VarType * item = root;
+  size_t start = 0;
+  while (item != 0 && start <= path.length()) {
+    size_t end = path.find('/',start);
+    if (end == string::npos) end = path.length();
+    item = item->findChild(path.substr(start,end-start));
+    start = end + 1;
+  }
+  if (item == 0) {
+    fprintf(stderr,"Unknown setting: %s\n",path.c_str());
+    return false;
+  }
+  item->setString(value);
+  return true;
+}
+
+/// sets a capture setting by its path below the capture thread's settings
+static bool setCaptureSetting(CaptureThread * thread, const string & path, const string & value) {
+  return setSetting(thread->getSettings(),path,value);
+}
+
+static const SSL_DetectionRobot * findRobot(const google::protobuf::RepeatedPtrField<SSL_DetectionRobot> & robots,
+                                            int id, double x, double y) {
+  const SSL_DetectionRobot * best = 0;
+  for (int i = 0; i < robots.size(); i++) {
+    const SSL_DetectionRobot & r = robots.Get(i);
+    if (!r.has_robot_id() || (int)r.robot_id() != id) continue;
+    if (best == 0 || hypot(r.x() - x, r.y() - y) < hypot(best->x() - x, best->y() - y)) best = &r;
+  }
+  return best;
+}
+
+/// matches the detected robots by team and id and the detected balls
+/// by distance against the poses the generator rendered.
+static void compareToGroundTruth(const SSL_DetectionFrame & detection,
+                                 const GeneratorScene::GroundTruth & truth,
+                                 BenchmarkResult & result) {
+  static const double max_ball_distance = 200.0;
+  result.compared_frames++;
+  int expected[2] = { 0, 0 };
+  for (unsigned int i = 0; i < truth.robots.size(); i++) {
+    const GeneratorScene::RobotPose & robot = truth.robots[i];
+    expected[robot.team]++;
+    result.robots_expected++;
+    const SSL_DetectionRobot * found = findRobot(
+      robot.team == GeneratorScene::TEAM_BLUE ? detection.robots_blue() : detection.robots_yellow(),
+      robot.id, robot.x, robot.y);
+    if (found == 0) continue;
+    result.robots_found++;
+    double error = hypot(found->x() - robot.x, found->y() - robot.y);
+    result.robot_error_sum += error;
+    result.robot_error_max = max(result.robot_error_max, error);
+    if (found->has_orientation()) {
+      result.orientation_error_sum += fabs(angle_diff((double)found->orientation(), robot.orientation));
+    }
+  }
+  result.robots_false += max(0, detection.robots_blue_size() - expected[GeneratorScene::TEAM_BLUE]);
+  result.robots_false += max(0, detection.robots_yellow_size() - expected[GeneratorScene::TEAM_YELLOW]);
+
+  for (unsigned int i = 0; i < truth.balls.size(); i++) {
+    const GeneratorScene::BallPose & ball = truth.balls[i];
+    result.balls_expected++;
+    double best = max_ball_distance;
+    for (int j = 0; j < detection.balls_size(); j++) {
+      best = min(best, (double)hypot(detection.balls(j).x() - ball.x, detection.balls(j).y() - ball.y));
+    }
+    if (best < max_ball_distance) {
+      result.balls_found++;
+      result.ball_error_sum += best;
+    }
+  }
+}
+
+static double percentile(const vector<double> & sorted, double p) {
+  if (sorted.empty()) return 0.0;
+  size_t idx = (size_t)(p * (sorted.size() - 1) + 0.5);
+  return sorted[min(idx,sorted.size()-1)];
+}
+
+static bool runBenchmark(int cameras, double fps, double duration, double warmup,
+                         const QString & source_dir, const QString & replay, int width, int height,
+                         int scene_robots, bool roi_tracking, bool ball_tracking, BenchmarkResult & result) {
+  RenderOptions opts;
+  MultiStackRoboCupSSL * multi_stack = new MultiStackRoboCupSSL(&opts, cameras);
+  multi_stack->RefreshNetworkOutput();
+  multi_stack->RefreshLegacyNetworkOutput();
+  multi_stack->RefreshAggregatedNetworkOutput();
+  multi_stack->RefreshStreamOutput();
+
+  char buf[64];
+  snprintf(buf,sizeof(buf),"%f",fps);
+  string replay_fps = (replay == "fast") ? "0" : buf;
+  for (unsigned int i = 0; i < multi_stack->threads.size(); i++) {
+    CaptureThread * ct = multi_stack->threads[i];
+    StackRoboCupSSL * ssl_stack = dynamic_cast<StackRoboCupSSL *>(ct->getStack());
+    if (roi_tracking && ssl_stack != 0) {
+      ssl_stack->getROITracker()->getSettings()->findChild("enable")->setString("true");
+    }
+    if (ball_tracking && ssl_stack != 0) {
+      ssl_stack->getBallTracker()->getSettings()->findChild("enable")->setString("true");
+    }
+    if (source_dir.isEmpty()) {
+      setCaptureSetting(ct,"Capture Control/Capture Module","Generator");
+      snprintf(buf,sizeof(buf),"%f",fps);
+      setCaptureSetting(ct,"Generator/Capture Settings/Framerate (FPS)",buf);
+      snprintf(buf,sizeof(buf),"%d",width);
+      setCaptureSetting(ct,"Generator/Capture Settings/Width (pixels)",buf);
+      snprintf(buf,sizeof(buf),"%d",height);
+      setCaptureSetting(ct,"Generator/Capture Settings/Height (pixels)",buf);
+      if (scene_robots >= 0) {
+        //the scene's camera and the stack's calibration both start from the
+        //CameraParameters defaults, so detections map back onto the scene.
+        setCaptureSetting(ct,"Generator/Scene/enable scene","true");
+        snprintf(buf,sizeof(buf),"%d",scene_robots);
+        setCaptureSetting(ct,"Generator/Scene/robots per team",buf);
+        StackRoboCupSSL * stack = dynamic_cast<StackRoboCupSSL *>(ct->getStack());
+        if (stack != 0) stack->getLUT()->computeLUTfromLabels();
+      }
+    } else if (QFileInfo(source_dir).isFile()) {
+      //raw video recording. t_capture stays the wall clock time, so that
+      //the latency is measured the same way as for the generator:
+      setCaptureSetting(ct,"Capture Control/Capture Module","Read from video file");
+      setCaptureSetting(ct,"Read from video file/Capture Settings/file",source_dir.toStdString());
+      if (replay == "fast") {
+        setCaptureSetting(ct,"Read from video file/Capture Settings/playback speed","as fast as possible");
+      } else if (replay == "recorded") {
+        setCaptureSetting(ct,"Read from video file/Capture Settings/playback speed","recorded timestamps");
+      } else {
+        setCaptureSetting(ct,"Read from video file/Capture Settings/playback speed","fixed framerate");
+        setCaptureSetting(ct,"Read from video file/Capture Settings/framerate (fixed)",replay_fps);
+      }
+      setCaptureSetting(ct,"Read from video file/Capture Settings/use recorded timestamps","false");
+    } else {
+      setCaptureSetting(ct,"Capture Control/Capture Module","Read from files");
+      setCaptureSetting(ct,"Read from files/Capture Settings/directory",source_dir.toStdString());
+      setCaptureSetting(ct,"Read from files/Capture Settings/framerate (0 = as fast as possible)",replay_fps);
+    }
+  }
+
+  RoboCupSSLClient client;
+  if (client.open(false) == false) {
+    fprintf(stderr,"Unable to open the benchmark client.\n");
+    delete multi_stack;
+    return false;
+  }
+
+  multi_stack->start();
+  for (unsigned int i = 0; i < multi_stack->threads.size(); i++) {
+    multi_stack->threads[i]->init();
+  }
+
+  result.cameras = cameras;
+  result.duration = duration;
+  result.latencies.clear();
+  result.frames_per_camera.clear();
+  result.lost_frames = 0;
+  result.compared_frames = 0;
+  result.robots_expected = result.robots_found = result.robots_false = 0;
+  result.robot_error_sum = result.robot_error_max = result.orientation_error_sum = 0.0;
+  result.balls_expected = result.balls_found = 0;
+  result.ball_error_sum = 0.0;
+  map<int,int> last_frame_number;
+
+  double t_start = GetTimeSec();
+  double t_measure = t_start + warmup;
+  double t_end = t_measure + duration;
+  double t_now;
+  while ((t_now = GetTimeSec()) < t_end) {
+    if (!client.wait(10)) continue;
+    int n;
+    while ((n = client.receiveBatch()) > 0) {
+      t_now = GetTimeSec();
+      if (t_now < t_measure) continue;
+      for (int i = 0; i < n; i++) {
+        if (!client.isBatchPacketValid(i)) continue;
+        const SSL_WrapperPacket & packet = client.getBatchPacket(i);
+        if (!packet.has_detection()) continue;
+        const SSL_DetectionFrame & detection = packet.detection();
+        result.latencies.push_back(t_now - detection.t_capture());
+        result.frames_per_camera[detection.camera_id()]++;
+        map<int,int>::iterator last = last_frame_number.find(detection.camera_id());
+        if (last != last_frame_number.end() && (int)detection.frame_number() > last->second + 1) {
+          result.lost_frames += detection.frame_number() - last->second - 1;
+        }
+        last_frame_number[detection.camera_id()] = detection.frame_number();
+        if (scene_robots >= 0 && detection.camera_id() < multi_stack->threads.size()) {
+          GeneratorScene::GroundTruth truth;
+          if (multi_stack->threads[detection.camera_id()]->getCaptureGenerator()->getGroundTruth(detection.t_capture(),truth)) {
+            compareToGroundTruth(detection,truth,result);
+          }
+        }
+      }
+    }
+  }
+
+  multi_stack->stop();
+  result.roi_frames = result.roi_full_scans = result.roi_hits = result.roi_misses = 0;
+  result.roi_coverage_sum = 0.0;
+  if (roi_tracking) {
+    for (unsigned int i = 0; i < multi_stack->threads.size(); i++) {
+      StackRoboCupSSL * ssl_stack = dynamic_cast<StackRoboCupSSL *>(multi_stack->threads[i]->getStack());
+      if (ssl_stack == 0) continue;
+      const ROITracker * tracker = ssl_stack->getROITracker();
+      result.roi_frames += tracker->getFrames();
+      result.roi_full_scans += tracker->getFullScans();
+      result.roi_hits += tracker->getHits();
+      result.roi_misses += tracker->getMisses();
+      result.roi_coverage_sum += tracker->getMeanCoverage() * tracker->getFrames();
+    }
+  }
+  result.ball_frames = result.ball_windowed_frames = result.ball_corrections = 0;
+  result.ball_restarts = result.ball_lost_tracks = result.ball_dropped_tracks = 0;
+  if (ball_tracking) {
+    for (unsigned int i = 0; i < multi_stack->threads.size(); i++) {
+      StackRoboCupSSL * ssl_stack = dynamic_cast<StackRoboCupSSL *>(multi_stack->threads[i]->getStack());
+      if (ssl_stack == 0) continue;
+      const BallTracker * tracker = ssl_stack->getBallTracker();
+      result.ball_frames += tracker->getFrames();
+      result.ball_windowed_frames += tracker->getWindowedFrames();
+      result.ball_corrections += tracker->getCorrections();
+      result.ball_restarts += tracker->getRestarts();
+      result.ball_lost_tracks += tracker->getLostTracks();
+      result.ball_dropped_tracks += tracker->getDroppedTracks();
+    }
+  }
+  delete multi_stack;
+  client.close();
+  sort(result.latencies.begin(),result.latencies.end());
+  return true;
+}
+
+static void printResult(const BenchmarkResult & result, double fps) {
+  const vector<double> & l = result.latencies;
+  int received = l.size();
+  printf("cameras=%2d received=%6d lost=%5d rate=%7.1f/s (target %7.1f/s) ",
+         result.cameras, received, result.lost_frames,
+         received / result.duration, fps * result.cameras);
+  printf("latency ms: min=%7.3f p50=%7.3f p90=%7.3f p99=%7.3f max=%7.3f\n",
+         percentile(l,0.0)*1000.0, percentile(l,0.5)*1000.0, percentile(l,0.9)*1000.0,
+         percentile(l,0.99)*1000.0, percentile(l,1.0)*1000.0);
+  if (result.compared_frames > 0) {
+    printf("accuracy over %d frames: robots found=%5.1f%% false=%d error mm: mean=%6.1f max=%6.1f orientation deg: mean=%5.2f ",
+           result.compared_frames,
+           100.0 * result.robots_found / max(result.robots_expected,1), result.robots_false,
+           result.robot_error_sum / max(result.robots_found,1), result.robot_error_max,
+           result.orientation_error_sum / max(result.robots_found,1) * 180.0 / M_PI);
+    printf("balls found=%5.1f%% error mm: mean=%6.1f\n",
+           100.0 * result.balls_found / max(result.balls_expected,1),
+           result.ball_error_sum / max(result.balls_found,1));
+  }
+  if (result.roi_frames > 0) {
+    printf("ROI tracking over %lld frames: full scans=%5.1f%% hits=%lld misses=%lld hit rate=%5.1f%% image coverage=%5.1f%%\n",
+           result.roi_frames, 100.0 * result.roi_full_scans / result.roi_frames,
+           result.roi_hits, result.roi_misses,
+           100.0 * result.roi_hits / max(result.roi_hits + result.roi_misses,1LL),
+           100.0 * result.roi_coverage_sum / result.roi_frames);
+  }
+  if (result.ball_frames > 0) {
+    printf("ball tracking over %lld frames: windowed=%5.1f%% corrections=%lld restarts=%lld lost tracks=%lld dropped tracks=%lld\n",
+           result.ball_frames, 100.0 * result.ball_windowed_frames / result.ball_frames,
+           result.ball_corrections, result.ball_restarts, result.ball_lost_tracks,
+           result.ball_dropped_tracks);
+  }
+  fflush(stdout);
+}
+
+/// a camera count is sustained if every camera delivers at least
+/// min_ratio of the target frame rate.
+static bool isSustained(const BenchmarkResult & result, double fps, double min_ratio) {
+  for (int cam = 0; cam < result.cameras; cam++) {
+    map<int,int>::const_iterator it = result.frames_per_camera.find(cam);
+    int frames = (it == result.frames_per_camera.end()) ? 0 : it->second;
+    if (frames < min_ratio * fps * result.duration) return false;
+  }
+  return true;
+}
+
+typedef void (*ConversionFunction)(unsigned char *src, unsigned char *dest, int width, int height);
+
+struct ConversionBenchmark {
+  const char * name;
+  ConversionFunction function;
+  int src_bytes_per_pixel;
+  int dest_bytes_per_pixel;
+};
+
+//the demosaic follows the conversions' implementation selection:
+static void rggb2rgb(unsigned char *src, unsigned char *dest, int width, int height) {
+  Bayer::demosaic(src, dest, width, height, Bayer::PATTERN_RGGB, COLOR_RGB8);
+}
+
+static void grbg2uyvy(unsigned char *src, unsigned char *dest, int width, int height) {
+  Bayer::demosaic(src, dest, width, height, Bayer::PATTERN_GRBG, COLOR_YUV422_UYVY);
+}
+
+static void bggr2yuv444(unsigned char *src, unsigned char *dest, int width, int height) {
+  Bayer::demosaic(src, dest, width, height, Bayer::PATTERN_BGGR, COLOR_YUV444);
+}
+
+/// checks every available implementation of the accelerated color
+/// conversions and of the Bayer demosaic against the scalar reference (including odd image sizes
+/// which exercise the scalar tails) and measures their throughput.
+/// Returns false if any output differs from the reference.
+static bool runConversionBenchmark(int width, int height, double duration) {
+  const ConversionBenchmark conversions[] = {
+    { "uyvy2rgb",  Conversions::uyvy2rgb,  2, 3 },
+    { "yuyv2rgb",  Conversions::yuyv2rgb,  2, 3 },
+    { "uyvy2bgr",  Conversions::uyvy2bgr,  2, 3 },
+    { "rgb2uyvy",  Conversions::rgb2uyvy,  3, 2 },
+    { "rgb2yuyv",  Conversions::rgb2yuyv,  3, 2 },
+    { "yuyv2uyvy", Conversions::yuyv2uyvy, 2, 2 },
+    { "rggb2rgb",  rggb2rgb,    1, 3 },
+    { "grbg2uyvy", grbg2uyvy,   1, 2 },
+    { "bggr2yuv444", bggr2yuv444, 1, 3 }
+  };
+  const int n_conversions = sizeof(conversions) / sizeof(conversions[0]);
+  const int check_widths[] = { 2, 6, 14, 30, 34, 62, 66, width };
+  const int n_check_widths = sizeof(check_widths) / sizeof(check_widths[0]);
+  Conversions::Implementation best = Conversions::getBestImplementation();
+  bool exact = true;
+
+  for (int c = 0; c < n_conversions; c++) {
+    const ConversionBenchmark & conv = conversions[c];
+    for (int w = 0; w < n_check_widths; w++) {
+      int pixels = check_widths[w] * 3;
+      vector<unsigned char> src(pixels * conv.src_bytes_per_pixel);
+      vector<unsigned char> reference(pixels * conv.dest_bytes_per_pixel);
+      vector<unsigned char> result(pixels * conv.dest_bytes_per_pixel);
+      for (unsigned int i = 0; i < src.size(); i++) src[i] = rand() & 0xff;
+      Conversions::setImplementation(Conversions::IMPL_SCALAR);
+      conv.function(&src[0], &reference[0], check_widths[w], 3);
+      for (int impl = Conversions::IMPL_SCALAR + 1; impl <= best; impl++) {
+        Conversions::setImplementation((Conversions::Implementation)impl);
+        conv.function(&src[0], &result[0], check_widths[w], 3);
+        int max_error = 0;
+        for (unsigned int i = 0; i < result.size(); i++) {
+          max_error = max(max_error, abs((int)result[i] - (int)reference[i]));
+        }
+        if (max_error != 0) {
+          printf("%-10s %-6s width %4d: max error %d\n", conv.name,
+                 Conversions::implementationName((Conversions::Implementation)impl),
+                 check_widths[w], max_error);
+          exact = false;
+        }
+      }
+    }
+
+    int pixels = width * height;
+    vector<unsigned char> src(pixels * conv.src_bytes_per_pixel);
+    vector<unsigned char> dest(pixels * conv.dest_bytes_per_pixel);
+    for (unsigned int i = 0; i < src.size(); i++) src[i] = rand() & 0xff;
+    for (int impl = Conversions::IMPL_SCALAR; impl <= best; impl++) {
+      Conversions::setImplementation((Conversions::Implementation)impl);
+      int frames = 0;
+      double t_start = GetTimeSec();
+      double t;
+      do {
+        conv.function(&src[0], &dest[0], width, height);
+        frames++;
+      } while ((t = GetTimeSec() - t_start) < duration);
+      printf("%-10s %-6s %8.1f Mpix/s\n", conv.name,
+             Conversions::implementationName((Conversions::Implementation)impl),
+             frames * (double)pixels / t * 1.0E-6);
+    }
+  }
+  Conversions::setImplementation(best);
+  printf("Conversions are %s\n", exact ? "bit-exact" : "NOT bit-exact");
+  fflush(stdout);
+  return exact;
+}
+
+struct ProjectionSetup {
+  const char * name;
+  double distortion;
+  double q2;
+  double q3;
+};
+
+/// compares the image2field lookup grid of the CameraModel against the
+/// exact projection for every pixel (at a sub-pixel offset) of a W x H
+/// image, at the ground, ball and robot heights, and measures the time per
+/// call of the lookup, the exact snapshot and the live CameraParameters.
+static void runProjectionBenchmark(int width, int height) {
+  const ProjectionSetup setups[] = {
+    { "top-down",            0.0, 0.0, 0.0 },
+    { "top-down distorted",  0.2, 0.0, 0.0 },
+    { "tilted",              0.0, 0.2, 0.1 },
+    { "tilted distorted",    0.2, 0.2, 0.1 }
+  };
+  const int n_setups = sizeof(setups) / sizeof(setups[0]);
+  const double heights[] = { 0.0, 21.5, 140.0 };
+  const int n_heights = sizeof(heights) / sizeof(heights[0]);
+
+  for (int i = 0; i < n_setups; i++) {
+    CameraParameters camera(0);
+    camera.distortion->setDouble(setups[i].distortion);
+    camera.q2->setDouble(setups[i].q2);
+    camera.q3->setDouble(setups[i].q3);
+    CameraModel model;
+    model.update(camera,width,height);
+    GVector::vector3d<double> lut, exact, live;
+    GVector::vector2d<double> p_model, p_live;
+    double max_snapshot_error = 0.0;
+    for (int h = 0; h < n_heights; h++) {
+      double max_error = 0.0;
+      double error_sum = 0.0;
+      int n = 0;
+      for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+          GVector::vector2d<double> p_i(x + 0.37, y + 0.61);
+          model.image2field(lut,p_i,heights[h]);
+          model.image2fieldExact(exact,p_i,heights[h]);
+          double error = (lut - exact).length();
+          max_error = max(max_error,error);
+          error_sum += error;
+          n++;
+          if ((x % 16) == 0 && (y % 16) == 0) {
+            //the snapshot itself has to match the live parameters:
+            camera.image2field(live,p_i,heights[h]);
+            max_snapshot_error = max(max_snapshot_error,(exact - live).length());
+            model.field2image(live,p_model);
+            camera.field2image(live,p_live);
+            max_snapshot_error = max(max_snapshot_error,(p_model - p_live).length());
+          }
+        }
+      }
+      printf("%-20s z=%6.1f error mm: mean=%8.5f max=%8.5f\n",
+             setups[i].name, heights[h], error_sum / max(n,1), max_error);
+    }
+    printf("%-20s snapshot vs. live parameters: max deviation=%g\n",
+           setups[i].name, max_snapshot_error);
+    const int calls = 1000000;
+    double t_start = GetTimeSec();
+    for (int c = 0; c < calls; c++) {
+      model.image2field(lut,GVector::vector2d<double>(c % width + 0.5,(c / width) % height + 0.5),140.0);
+    }
+    double t_lut = GetTimeSec() - t_start;
+    t_start = GetTimeSec();
+    for (int c = 0; c < calls; c++) {
+      model.image2fieldExact(exact,GVector::vector2d<double>(c % width + 0.5,(c / width) % height + 0.5),140.0);
+    }
+    double t_exact = GetTimeSec() - t_start;
+    t_start = GetTimeSec();
+    for (int c = 0; c < calls; c++) {
+      camera.image2field(live,GVector::vector2d<double>(c % width + 0.5,(c / width) % height + 0.5),140.0);
+    }
+    double t_live = GetTimeSec() - t_start;
+    t_start = GetTimeSec();
+    for (int c = 0; c < calls; c++) {
+      model.field2image(GVector::vector3d<double>(c % 4000 - 2000.0,(c / 4000) % 3000 - 1500.0,140.0),p_model);
+    }
+    double t_f2i_model = GetTimeSec() - t_start;
+    t_start = GetTimeSec();
+    for (int c = 0; c < calls; c++) {
+      camera.field2image(GVector::vector3d<double>(c % 4000 - 2000.0,(c / 4000) % 3000 - 1500.0,140.0),p_live);
+    }
+    double t_f2i_live = GetTimeSec() - t_start;
+    printf("%-20s image2field ns/call: lookup=%7.1f snapshot=%7.1f live=%7.1f\n", setups[i].name,
+           t_lut / calls * 1.0E9, t_exact / calls * 1.0E9, t_live / calls * 1.0E9);
+    printf("%-20s field2image ns/call: snapshot=%7.1f live=%7.1f\n", setups[i].name,
+           t_f2i_model / calls * 1.0E9, t_f2i_live / calls * 1.0E9);
+  }
+  fflush(stdout);
+}
+
+/// compares the RegionGrid marker lookup against the RegionTree it
+/// replaced: 16 robots of 5 markers each plus \p noise random blobs on a
+/// W x H image. Both index all regions and are queried around every
+/// team-colored region, as the TeamDetector does. Returns false if the
+/// query results differ.
+static bool runSpatialIndexBenchmark(int width, int height, int noise, double duration) {
+  const int robots = 16;
+  const int team_color = 1;
+  const float query_dist = 20.0f;
+  const int n = robots * 5 + noise;
+  vector<CMVision::Region> regs(n);
+  srand(1);
+  for (int i = 0; i < n; i++) {
+    CMVision::Region & reg = regs[i];
+    if (i < robots * 5) {
+      //robots on a grid, with the four markers around the team marker
+      int r = i / 5;
+      int m = i % 5;
+      float x = (r % 4 + 0.5f) * width / 4.0f;
+      float y = (r / 4 + 0.5f) * height / 4.0f;
+      if (m > 0) {
+        double a = m * M_PI / 2.0 + 0.6;
+        x += 12.0f * cos(a);
+        y += 12.0f * sin(a);
+      }
+      reg.cen_x = x;
+      reg.cen_y = y;
+      reg.color.v = (m == 0) ? team_color : 2 + m % 2;
+    } else {
+      reg.cen_x = (float)(rand() % (width * 16)) / 16.0f;
+      reg.cen_y = (float)(rand() % (height * 16)) / 16.0f;
+      reg.color.v = 1 + rand() % 4;
+    }
+    reg.area = 1;
+    reg.next = 0;
+  }
+
+  CMVision::RegionTree tree;
+  CMVision::RegionGrid grid;
+  vector<CMVision::RegionGrid::Neighbor> neighbors;
+  vector<vector<CMVision::Region *> > tree_results;
+  bool ok = true;
+  long tree_hits = 0;
+  long grid_hits = 0;
+  int tree_iterations = 0;
+  int grid_iterations = 0;
+  double t_tree = 0.0;
+  double t_grid = 0.0;
+  double t_end = GetTimeSec() + duration;
+  while (GetTimeSec() < t_end) {
+    double t_start = GetTimeSec();
+    tree.clear();
+    for (int i = 0; i < n; i++) tree.add(&regs[i]);
+    tree.build();
+    unsigned int q = 0;
+    for (int i = 0; i < n; i++) {
+      if (regs[i].color.v != team_color) continue;
+      if (tree_results.size() <= q) tree_results.resize(q + 1);
+      vector<CMVision::Region *> & found = tree_results[q++];
+      found.clear();
+      tree.startQuery(regs[i],query_dist);
+      double d;
+      CMVision::Region * reg;
+      while ((reg = tree.getNextNearest(d)) != 0) {
+        found.push_back(reg);
+        tree_hits++;
+      }
+      tree.endQuery();
+    }
+    t_tree += GetTimeSec() - t_start;
+    tree_iterations++;
+
+    t_start = GetTimeSec();
+    grid.clear();
+    for (int i = 0; i < n; i++) grid.add(&regs[i]);
+    grid.build(query_dist);
+    q = 0;
+    for (int i = 0; i < n; i++) {
+      if (regs[i].color.v != team_color) continue;
+      grid.query(regs[i].cen_x,regs[i].cen_y,query_dist,neighbors);
+      grid_hits += neighbors.size();
+      //both have to find the same regions, nearest first:
+      const vector<CMVision::Region *> & expected = tree_results[q++];
+      if (neighbors.size() != expected.size()) {
+        ok = false;
+      } else {
+        for (unsigned int k = 0; k < neighbors.size(); k++) {
+          if (neighbors[k].reg != expected[k] &&
+              fabs(dist(vector2f(neighbors[k].reg->cen_x,neighbors[k].reg->cen_y),vector2f(regs[i].cen_x,regs[i].cen_y)) -
+                   dist(vector2f(expected[k]->cen_x,expected[k]->cen_y),vector2f(regs[i].cen_x,regs[i].cen_y))) > 1e-4) {
+            ok = false;
+          }
+        }
+      }
+    }
+    t_grid += GetTimeSec() - t_start;
+    grid_iterations++;
+  }
+  printf("%d robots, %d noise blobs, query distance %.0f px: %ld markers found per frame\n",
+         robots, noise, query_dist, tree_hits / max(tree_iterations,1));
+  printf("  region tree: %8.1f us per frame\n", t_tree / max(tree_iterations,1) * 1.0E6);
+  printf("  region grid: %8.1f us per frame%s\n", t_grid / max(grid_iterations,1) * 1.0E6,
+         ok ? "" : "  RESULTS DIFFER");
+  fflush(stdout);
+  return ok;
+}
+
+/// compares the box histograms of the integral histogram against scanning
+/// the boxes of a W x H label image, for a team marker check's box size.
+static bool runHistogramBenchmark(int width, int height, double duration) {
+  const int num_channels = 11;
+  const int boxes = 200;
+  const int radius = 16;
+  Image<raw8> image;
+  image.allocate(width,height);
+  raw8 * data = image.getPixelData();
+  srand(1);
+  //runs of equal labels, roughly like a thresholded frame:
+  for (int i = 0; i < width * height; ) {
+    int label = rand() % num_channels;
+    int run = 1 + rand() % 16;
+    for (int k = 0; k < run && i < width * height; k++) data[i++].v = label;
+  }
+  vector<int> xs(boxes), ys(boxes);
+  for (int i = 0; i < boxes; i++) {
+    xs[i] = rand() % width;
+    ys[i] = rand() % height;
+  }
+
+  CMVision::IntegralHistogram integral;
+  CMVision::Histogram scanned(num_channels);
+  CMVision::Histogram looked_up(num_channels);
+  bool ok = true;
+  int iterations = 0;
+  double t_build = 0.0;
+  double t_scan = 0.0;
+  double t_lookup = 0.0;
+  double t_end = GetTimeSec() + duration;
+  while (GetTimeSec() < t_end) {
+    double t_start = GetTimeSec();
+    integral.build(&image,num_channels);
+    t_build += GetTimeSec() - t_start;
+
+    for (int i = 0; i < boxes; i++) {
+      t_start = GetTimeSec();
+      scanned.clear();
+      int n_scanned = scanned.addBox(&image,xs[i]-radius,ys[i]-radius,xs[i]+radius,ys[i]+radius);
+      t_scan += GetTimeSec() - t_start;
+
+      t_start = GetTimeSec();
+      looked_up.clear();
+      int n_looked_up = looked_up.addBox(integral,xs[i]-radius,ys[i]-radius,xs[i]+radius,ys[i]+radius);
+      t_lookup += GetTimeSec() - t_start;
+
+      if (n_scanned != n_looked_up) ok = false;
+      for (int c = 0; c < num_channels; c++) {
+        if (scanned.getChannel(c) != looked_up.getChannel(c)) ok = false;
+      }
+    }
+    iterations++;
+  }
+  iterations = max(iterations,1);
+  double scan_per_box = t_scan / (iterations * boxes);
+  double lookup_per_box = t_lookup / (iterations * boxes);
+  printf("%d labels, %dx%d boxes on %dx%d:\n", num_channels, 2*radius+1, 2*radius+1, width, height);
+  printf("  build:   %8.1f us per frame\n", t_build / iterations * 1.0E6);
+  printf("  scan:    %8.3f us per box\n", scan_per_box * 1.0E6);
+  printf("  lookup:  %8.3f us per box%s\n", lookup_per_box * 1.0E6, ok ? "" : "  RESULTS DIFFER");
+  if (scan_per_box > lookup_per_box) {
+    printf("  break-even at %.0f boxes per frame\n", (t_build / iterations) / (scan_per_box - lookup_per_box));
+  }
+  fflush(stdout);
+  return ok;
+}
+
+/// labels of \p full inside the ROI windows, clear elsewhere: what an
+/// ROI thresholding pass has to produce.
+static void maskToWindows(const Image<raw8> & full, const CMVision::ROIList & rois, Image<raw8> & masked) {
+  masked.allocate(full.getWidth(),full.getHeight());
+  masked.fillBlack();
+  const vector<CMVision::ImageROI> & windows = rois.getWindows();
+  for (unsigned int k = 0; k < windows.size(); k++) {
+    const CMVision::ImageROI & w = windows[k];
+    for (int y = w.y1; y <= w.y2; y++) {
+      for (int x = w.x1; x <= w.x2; x++) masked.setPixel(x,y,full.getPixel(x,y));
+    }
+  }
+}
+
+static bool sameRuns(CMVision::RunList & a, CMVision::RunList & b) {
+  if (a.getUsedRuns() != b.getUsedRuns()) return false;
+  const CMVision::Run * ra = a.getRunArrayPointer();
+  const CMVision::Run * rb = b.getRunArrayPointer();
+  for (int i = 0; i < a.getUsedRuns(); i++) {
+    if (ra[i].x != rb[i].x || ra[i].y != rb[i].y || ra[i].width != rb[i].width ||
+        ra[i].color.v != rb[i].color.v || ra[i].parent != rb[i].parent) return false;
+  }
+  return true;
+}
+
+static bool runROIBenchmark(int width, int height, double duration) {
+  const int windows = 16;
+  const int window_size = 60; //video pixels, about a robot with margin
+  const ColorFormat formats[3] = { COLOR_YUV422_UYVY, COLOR_YUV444, COLOR_RAW8 };
+  const Bayer::Pattern pattern = Bayer::PATTERN_RGGB;
+
+  YUVLUT lut(4,6,6,"");
+  lut.loadRoboCupChannels(LUTChannelMode_Numeric);
+  srand(1);
+  //a quarter of the color space is labeled:
+  for (int y = 0; y < 256; y += 16) {
+    for (int u = 0; u < 256; u += 4) {
+      for (int v = 0; v < 256; v += 4) {
+        lut.set(y,u,v,(rand() % 4 == 0) ? 1 + rand() % (lut.getChannelCount() - 1) : 0);
+      }
+    }
+  }
+
+  bool ok = true;
+  printf("%d windows of %dx%d on %dx%d frames:\n", windows, window_size, window_size, width, height);
+  for (int f = 0; f < 3; f++) {
+    ColorFormat format = formats[f];
+    int scale = (format == COLOR_RAW8) ? 2 : 1;
+    RawImage video;
+    video.allocate(format,width,height);
+    //blocks of equal bytes, so that the labels form runs:
+    unsigned char * data = video.getData();
+    for (int i = 0; i < video.getNumBytes(); ) {
+      unsigned char value = rand();
+      for (int k = 0; k < 8 && i < video.getNumBytes(); k++) data[i++] = value + rand() % 3;
+    }
+
+    Image<raw8> full, masked, roi;
+    full.allocate(width / scale,height / scale);
+    roi.allocate(width / scale,height / scale);
+    CMVision::RunList full_runs(width * height / scale);
+    CMVision::RunList roi_runs(width * height / scale);
+    CMVision::ROIList rois;
+    int iterations = 0;
+    double t_full = 0.0;
+    double t_roi = 0.0;
+    bool format_ok = true;
+    double t_end = GetTimeSec() + duration / 3.0;
+    while (GetTimeSec() < t_end) {
+      //windows anywhere, also across the image borders:
+      rois.clear();
+      for (int k = 0; k < windows; k++) {
+        int x = rand() % (width + window_size) - window_size;
+        int y = rand() % (height + window_size) - window_size;
+        rois.add(x,y,x + window_size - 1,y + window_size - 1);
+      }
+      rois.mapToImage(full.getWidth(),full.getHeight(),scale);
+
+      double t_start = GetTimeSec();
+      if (format == COLOR_YUV422_UYVY) {
+        CMVisionThreshold::thresholdImageYUV422_UYVY(&full,&video,&lut);
+      } else if (format == COLOR_YUV444) {
+        CMVisionThreshold::thresholdImageYUV444(&full,&video,&lut);
+      } else {
+        CMVisionThreshold::thresholdImageBayerQuads(&full,&video,&lut,pattern);
+      }
+      CMVision::RegionProcessing::encodeRuns(&full,&full_runs);
+      t_full += GetTimeSec() - t_start;
+
+      t_start = GetTimeSec();
+      CMVisionThreshold::thresholdImageROIs(&roi,&video,&lut,pattern,rois);
+      CMVision::RegionProcessing::encodeRuns(&roi,&roi_runs,&rois);
+      t_roi += GetTimeSec() - t_start;
+
+      //the ROI pass has to match a full scan of the masked labels:
+      maskToWindows(full,rois,masked);
+      CMVision::RegionProcessing::encodeRuns(&masked,&full_runs);
+      if (memcmp(roi.getData(),masked.getData(),masked.getNumBytes()) != 0 ||
+          !sameRuns(roi_runs,full_runs)) format_ok = false;
+      iterations++;
+    }
+    iterations = max(iterations,1);
+    printf("  %-12s full scan: %8.1f us  windows: %8.1f us per frame%s\n",
+           Colors::colorFormatToString(format).c_str(),
+           t_full / iterations * 1.0E6, t_roi / iterations * 1.0E6,
+           format_ok ? "" : "  RESULTS DIFFER");
+    ok = ok && format_ok;
+  }
+  fflush(stdout);
+  return ok;
+}
+
+/// the bytes of frame \p i in the round-trip check
+static unsigned char rawVideoTestByte(int frame, int i) {
+  return (unsigned char)(frame * 31 + i * 7 + (i >> 8));
+}
+
+static bool checkRawVideoFrame(const unsigned char * data, int bytes, int frame) {
+  if (data == 0) return false;
+  for (int i = 0; i < bytes; i++) {
+    if (data[i] != rawVideoTestByte(frame,i)) return false;
+  }
+  return true;
+}
+
+/// writes a raw video file for each stored color format, then reads it back
+/// with RawVideoReader and replays it through CaptureVideoFile, checking the
+/// frame data, the timestamps, seeking and looping.
+static bool runRawVideoCheck(int width, int height) {
+  const int frames = 12;
+  const ColorFormat formats[3] = { COLOR_YUV422_UYVY, COLOR_RGB8, COLOR_RAW8 };
+  char filename[64];
+  snprintf(filename,sizeof(filename),"/tmp/ssl-vision-benchmark-%d.raw",(int)getpid());
+  bool ok = true;
+  printf("raw video round trip, %d frames of %dx%d:\n", frames, width, height);
+  for (int f = 0; f < 3; f++) {
+    ColorFormat format = formats[f];
+    int bytes = RawImage::computeImageSize(format,width * height);
+    vector<unsigned char> data(bytes);
+    vector<double> times(frames);
+    const char * failed = 0;
+
+    RawVideoWriter writer;
+    double t_start = GetTimeSec();
+    if (!writer.open(filename,format,width,height,Bayer::PATTERN_GRBG)) {
+      failed = "open for writing";
+    }
+    for (int i = 0; i < frames && failed == 0; i++) {
+      for (int k = 0; k < bytes; k++) data[k] = rawVideoTestByte(i,k);
+      //irregular capture times, like a camera with jitter and a dropped frame:
+      times[i] = 1000.0 + i / 60.0 + ((i * 7) % 5) * 1.0E-4 + (i > frames / 2 ? 1.0 / 60.0 : 0.0);
+      if (!writer.appendFrame(&data[0],times[i])) failed = "append";
+    }
+    if (failed == 0 && !writer.close()) failed = "close";
+    double t_write = GetTimeSec() - t_start;
+
+    RawVideoReader reader;
+    if (failed == 0 && !reader.open(filename)) failed = "open for reading";
+    if (failed == 0 && (reader.getFrameCount() != frames || reader.getWidth() != width ||
+                        reader.getHeight() != height || reader.getColorFormat() != format ||
+                        reader.getBayerPattern() != Bayer::PATTERN_GRBG)) {
+      failed = "header";
+    }
+    for (int i = 0; i < frames && failed == 0; i++) {
+      if (((size_t)reader.getFrameData(i)) % RawVideoFile::alignment != 0) failed = "alignment";
+      if (!checkRawVideoFrame(reader.getFrameData(i),bytes,i)) failed = "frame data";
+      if (reader.getFrameTime(i) != times[i]) failed = "timestamps";
+    }
+    reader.close();
+
+    //replay: all frames in order, wrapping around, then a seek, then the end
+    VarList * settings = new VarList("Read from video file"); //owned by the capture
+    CaptureVideoFile capture(settings);
+    setSetting(settings,"Capture Settings/file",filename);
+    setSetting(settings,"Capture Settings/playback speed","as fast as possible");
+    setSetting(settings,"Capture Settings/use recorded timestamps","true");
+    setSetting(settings,"Capture Settings/loop","true");
+    if (failed == 0 && !capture.startCapture()) failed = "start capture";
+    for (int i = 0; i < frames + frames / 2 && failed == 0; i++) {
+      RawImage img = capture.getFrame();
+      int expected = i % frames;
+      if (!checkRawVideoFrame(img.getData(),bytes,expected)) failed = "replayed frame data";
+      else if (img.getTime() != times[expected]) failed = "replayed timestamps";
+      else if (img.getColorFormat() != format) failed = "replayed format";
+      capture.releaseFrame();
+    }
+    if (failed == 0) {
+      capture.seek(frames / 3);
+      RawImage img = capture.getFrame();
+      if (!checkRawVideoFrame(img.getData(),bytes,frames / 3) || img.getTime() != times[frames / 3]) {
+        failed = "seek";
+      }
+      capture.releaseFrame();
+    }
+    if (failed == 0) {
+      setSetting(settings,"Capture Settings/loop","false");
+      capture.seek(frames - 1);
+      RawImage last = capture.getFrame();
+      capture.releaseFrame();
+      RawImage end = capture.getFrame();
+      if (!checkRawVideoFrame(last.getData(),bytes,frames - 1) || end.getData() != 0 || capture.isCapturing()) {
+        failed = "end of file without looping";
+      }
+    }
+    capture.stopCapture();
+    unlink(filename);
+
+    printf("  %-12s write: %8.1f MB/s%s%s\n", Colors::colorFormatToString(format).c_str(),
+           frames * (double)bytes / max(t_write,1.0E-9) / 1.0E6,
+           failed ? "  FAILED: " : "", failed ? failed : "");
+    ok = ok && failed == 0;
+  }
+  fflush(stdout);
+  return ok;
+}
+
+/// the sorted insertion that TeamDetector used before RobotCandidateList:
+/// shifts all less confident robots down, then strips and cuts the list.
+static SSL_DetectionRobot * addRobotByInsertion(google::protobuf::RepeatedPtrField<SSL_DetectionRobot> * robots,
+                                                double conf, int max_robots) {
+  int size = robots->size();
+  for (int i = 0; i < size; i++) {
+    if (robots->Get(i).confidence() < conf) {
+      if (size < max_robots) {
+        robots->Add();
+        size++;
+      }
+      for (int j = size - 1; j > i; j--) {
+        *(robots->Mutable(j)) = robots->Get(j - 1);
+      }
+      SSL_DetectionRobot * robot = robots->Mutable(i);
+      robot->Clear();
+      robot->set_confidence(conf);
+      return robot;
+    }
+  }
+  if (size < max_robots) {
+    SSL_DetectionRobot * robot = robots->Add();
+    robot->set_confidence(conf);
+    return robot;
+  }
+  return 0;
+}
+
+/// selects the robots of 500 candidate blobs with the sorted insertion
+/// and with the bounded heap, for a small and a large team size.
+static bool runCandidateBenchmark(double duration) {
+  const int num_candidates = 500;
+  vector<CMPattern::RobotCandidate> input(num_candidates);
+  srand(1);
+  for (int i = 0; i < num_candidates; i++) {
+    //coarse confidences, so there are ties and zeros:
+    input[i].conf = (rand() % 64) / 63.0;
+    input[i].x = (float)(rand() % 6000 - 3000);
+    input[i].y = (float)(rand() % 4000 - 2000);
+    input[i].pixel_x = (float)i;
+    input[i].id = i % 12;
+  }
+
+  const int team_sizes[] = { 6, 250 };
+  bool ok = true;
+  for (int t = 0; t < 2; t++) {
+    int max_robots = team_sizes[t];
+    google::protobuf::RepeatedPtrField<SSL_DetectionRobot> inserted;
+    google::protobuf::RepeatedPtrField<SSL_DetectionRobot> heaped;
+    CMPattern::RobotCandidateList candidates;
+    int iterations = 0;
+    double t_insert = 0.0;
+    double t_heap = 0.0;
+    double t_end = GetTimeSec() + duration / 2.0;
+    while (GetTimeSec() < t_end) {
+      double t_start = GetTimeSec();
+      inserted.Clear();
+      for (int i = 0; i < num_candidates; i++) {
+        SSL_DetectionRobot * robot = addRobotByInsertion(&inserted,input[i].conf,max_robots * 2);
+        if (robot != 0) {
+          robot->set_x(input[i].x);
+          robot->set_y(input[i].y);
+          robot->set_robot_id(input[i].id);
+          robot->set_pixel_x(input[i].pixel_x);
+          robot->set_pixel_y(input[i].pixel_y);
+          robot->set_height(input[i].height);
+        }
+      }
+      int tgt = 0;
+      for (int src = 0; src < inserted.size(); src++) {
+        if (inserted.Get(src).confidence() != 0.0) {
+          if (tgt != src) *(inserted.Mutable(tgt)) = inserted.Get(src);
+          tgt++;
+        }
+      }
+      while (inserted.size() > tgt) inserted.RemoveLast();
+      while (inserted.size() > max_robots) inserted.RemoveLast();
+      t_insert += GetTimeSec() - t_start;
+
+      t_start = GetTimeSec();
+      heaped.Clear();
+      candidates.clear(max_robots * 2);
+      for (int i = 0; i < num_candidates; i++) candidates.add(input[i]);
+      candidates.sort();
+      candidates.write(&heaped,max_robots);
+      t_heap += GetTimeSec() - t_start;
+      iterations++;
+    }
+
+    bool same = (inserted.size() == heaped.size());
+    for (int i = 0; same && i < inserted.size(); i++) {
+      same = inserted.Get(i).SerializeAsString() == heaped.Get(i).SerializeAsString();
+    }
+    ok = ok && same;
+    iterations = max(iterations,1);
+    printf("%d candidates, %3d robots per team: insertion %8.1f us  heap %8.1f us%s\n",
+           num_candidates, max_robots, t_insert / iterations * 1.0E6, t_heap / iterations * 1.0E6,
+           same ? "" : "  RESULTS DIFFER");
+  }
+  fflush(stdout);
+  return ok;
+}
+
+/// the near-robot test that PluginDetectBalls used before RobotPositionIndex:
+/// every candidate checks all robots of both teams.
+static bool isNearRobotLinear(const SSL_DetectionFrame & frame, double x, double y, double dist) {
+  double dist_sq = sq(dist);
+  for (int team = 0; team < 2; team++) {
+    const google::protobuf::RepeatedPtrField<SSL_DetectionRobot> & robots =
+      (team == 0) ? frame.robots_blue() : frame.robots_yellow();
+    for (int r = 0; r < robots.size(); r++) {
+      const SSL_DetectionRobot & robot = robots.Get(r);
+      if (robot.confidence() > 0.0 &&
+          (sq((double)robot.x() - x) + sq((double)robot.y() - y)) < dist_sq) return true;
+    }
+  }
+  return false;
+}
+
+/// runs the ball detection on 200 orange false positives around one real
+/// ball on a W x H frame: 80 blobs on the 12 robots, 60 surrounded by pink
+/// marker color and 60 too small ones. Only the real ball may be reported.
+/// Also compares the robot position index against the linear robot scan
+/// for all blob positions. Returns false if either check fails.
+static bool runBallBenchmark(int width, int height, double duration) {
+  const int num_robots = 12;
+  const int near_robot = 80;
+  const int marker_colored = 60;
+  const int too_small = 60;
+  const int num_regions = 1 + near_robot + marker_colored + too_small;
+  const double z_height = 30.0; //the plugin's default ball height
+  const double near_robot_dist = 70.0; //and near-robot distance
+  if (width < 640 || height < 500) {
+    fprintf(stderr,"--balls needs frames of at least 640x500.\n");
+    return false;
+  }
+
+  YUVLUT lut(4,6,6,"");
+  lut.loadRoboCupChannels(LUTChannelMode_Numeric);
+  int color_id_orange = lut.getChannelID("Orange");
+  int color_id_pink = lut.getChannelID("Pink");
+  int color_id_field = lut.getChannelID("Field Green");
+  CameraParameters camera(0);
+  RoboCupField field;
+  PluginDetectBalls plugin(0,&lut,camera,field);
+  CameraModel model;
+  model.update(camera,width,height);
+
+  FrameData data;
+  data.video.allocate(COLOR_YUV422_UYVY,width,height);
+  Image<raw8> threshold;
+  threshold.allocate(width,height);
+  raw8 * labels = threshold.getPixelData();
+  for (int i = 0; i < width * height; i++) labels[i].v = color_id_field;
+  CMVision::ColorRegionList colorlist(lut.getChannelCount());
+  SSL_DetectionFrame detection;
+  data.map.insert("cmv_threshold",&threshold);
+  data.map.insert("cmv_colorlist",&colorlist);
+  data.map.insert("ssl_detection_frame",&detection);
+
+  //12 robots on two rows, the real ball in between:
+  vector<CMVision::Region> regs(num_regions);
+  vector<vector2d> pixels(num_regions);
+  int ball_x = width / 2;
+  int ball_y = height / 2;
+  pixels[0] = vector2d(ball_x,ball_y);
+  srand(1);
+  for (int i = 0; i < near_robot; i++) {
+    int r = i % num_robots;
+    pixels[1 + i] = vector2d(ball_x - 250 + 100 * (r % 6) + rand() % 9 - 4,
+                             ball_y - 100 + 200 * (r / 6) + rand() % 9 - 4);
+  }
+  for (int i = 0; i < marker_colored; i++) {
+    pixels[1 + near_robot + i] = vector2d(ball_x - 240 + 16 * (i % 30),ball_y - 190 + 380 * (i / 30));
+  }
+  for (int i = 0; i < too_small; i++) {
+    pixels[1 + near_robot + marker_colored + i] = vector2d(rand() % width,rand() % height);
+  }
+  for (int r = 0; r < num_robots; r++) {
+    vector3d p_f;
+    model.image2field(p_f,vector2d(ball_x - 250 + 100 * (r % 6),ball_y - 100 + 200 * (r / 6)),z_height);
+    SSL_DetectionRobot * robot = (r < num_robots / 2) ? detection.add_robots_blue() : detection.add_robots_yellow();
+    robot->set_confidence(1.0);
+    robot->set_x(p_f.x);
+    robot->set_y(p_f.y);
+  }
+  CMVision::RegionLinkedList & orange = colorlist.getColorRegionArrayPointer()[color_id_orange];
+  for (int i = num_regions - 1; i >= 0; i--) {
+    CMVision::Region & reg = regs[i];
+    int x = (int)pixels[i].x;
+    int y = (int)pixels[i].y;
+    int size = (i < 1 + near_robot + marker_colored) ? 6 : 1;
+    reg.color.v = color_id_orange;
+    reg.x1 = x - size / 2;
+    reg.y1 = y - size / 2;
+    reg.x2 = reg.x1 + size - 1;
+    reg.y2 = reg.y1 + size - 1;
+    reg.cen_x = (reg.x1 + reg.x2) / 2.0f;
+    reg.cen_y = (reg.y1 + reg.y2) / 2.0f;
+    reg.area = size * size;
+    if (i > near_robot && i <= near_robot + marker_colored) {
+      for (int py = reg.y1 - 4; py <= reg.y2 + 4; py++) {
+        for (int px = reg.x1 - 4; px <= reg.x2 + 4; px++) threshold.setPixel(px,py,color_id_pink);
+      }
+    }
+    for (int py = reg.y1; py <= reg.y2; py++) {
+      for (int px = reg.x1; px <= reg.x2; px++) threshold.setPixel(px,py,color_id_orange);
+    }
+    orange.insertFront(&reg);
+  }
+
+  //the index has to agree with the linear scan on every blob:
+  RobotPositionIndex index;
+  index.add(detection.robots_blue());
+  index.add(detection.robots_yellow());
+  index.build();
+  vector<vector2d> positions(num_regions);
+  bool same = true;
+  for (int i = 0; i < num_regions; i++) {
+    vector3d p_f;
+    model.image2field(p_f,vector2d(regs[i].cen_x,regs[i].cen_y),z_height);
+    positions[i] = vector2d(p_f.x,p_f.y);
+    if (index.isNear(p_f.x,p_f.y,near_robot_dist) != isNearRobotLinear(detection,p_f.x,p_f.y,near_robot_dist)) same = false;
+  }
+  int iterations = 0;
+  int near_found = 0;
+  double t_linear = 0.0;
+  double t_index = 0.0;
+  double t_end = GetTimeSec() + duration / 2.0;
+  while (GetTimeSec() < t_end) {
+    double t_start = GetTimeSec();
+    for (int i = 0; i < num_regions; i++) near_found += isNearRobotLinear(detection,positions[i].x,positions[i].y,near_robot_dist);
+    t_linear += GetTimeSec() - t_start;
+    t_start = GetTimeSec();
+    index.clear();
+    index.add(detection.robots_blue());
+    index.add(detection.robots_yellow());
+    index.build();
+    for (int i = 0; i < num_regions; i++) near_found -= index.isNear(positions[i].x,positions[i].y,near_robot_dist);
+    t_index += GetTimeSec() - t_start;
+    iterations++;
+  }
+  if (near_found != 0) same = false;
+  iterations = max(iterations,1);
+  printf("%d orange blobs, %d robots:\n", num_regions, num_robots);
+  printf("  near-robot test, linear scan: %8.2f us per frame\n", t_linear / iterations * 1.0E6);
+  printf("  near-robot test, index:       %8.2f us per frame%s\n", t_index / iterations * 1.0E6,
+         same ? "" : "  RESULTS DIFFER");
+
+  //the full plugin, which may only report the real ball:
+  bool found = true;
+  iterations = 0;
+  double t_process = 0.0;
+  t_end = GetTimeSec() + duration / 2.0;
+  while (GetTimeSec() < t_end) {
+    double t_start = GetTimeSec();
+    plugin.process(&data,0);
+    t_process += GetTimeSec() - t_start;
+    iterations++;
+    if (detection.balls_size() != 1 || detection.balls(0).pixel_x() != regs[0].cen_x ||
+        detection.balls(0).pixel_y() != regs[0].cen_y) found = false;
+  }
+  iterations = max(iterations,1);
+  printf("  ball detection:               %8.2f us per frame, %d ball(s) reported%s\n",
+         t_process / iterations * 1.0E6, detection.balls_size(), found ? "" : "  WRONG BALLS");
+  fflush(stdout);
+  return same && found;
+}
+
+/// sends a full-field detection per camera and frame on the current and the
+/// legacy port, and receives both through one client group, as a client of
+/// a multi-camera setup would.
+static bool runReceiveBenchmark(int cameras, double fps, double duration) {
+  RoboCupSSLServer server(10006,"224.5.23.2");
+  RoboCupSSLServer legacy_server(10005,"224.5.23.2");
+  RoboCupSSLClient client(10006);
+  RoboCupSSLClient legacy_client(10005);
+  RoboCupSSLClientGroup group;
+  if (!server.open() || !legacy_server.open() || !client.open(false) || !legacy_client.open(false) ||
+      !group.add(&client) || !group.add(&legacy_client)) {
+    fprintf(stderr,"Unable to open the benchmark ports.\n");
+    return false;
+  }
+
+  //11 robots per team and a ball in every camera:
+  vector<SSL_DetectionFrame> frames(cameras);
+  for (int c = 0; c < cameras; c++) {
+    SSL_DetectionFrame & frame = frames[c];
+    frame.set_camera_id(c);
+    frame.set_frame_number(0);
+    frame.set_t_capture(0.0);
+    frame.set_t_sent(0.0);
+    SSL_DetectionBall * ball = frame.add_balls();
+    ball->set_confidence(0.9f);
+    ball->set_x(100.0f * c);
+    ball->set_y(-50.0f);
+    ball->set_pixel_x(390.0f);
+    ball->set_pixel_y(290.0f);
+    for (int i = 0; i < 22; i++) {
+      SSL_DetectionRobot * robot = (i < 11) ? frame.add_robots_blue() : frame.add_robots_yellow();
+      robot->set_confidence(0.95f);
+      robot->set_robot_id(i % 11);
+      robot->set_x(400.0f * (i % 11) - 2000.0f);
+      robot->set_y((i < 11) ? -1000.0f : 1000.0f);
+      robot->set_orientation(0.1f * i);
+      robot->set_pixel_x(30.0f * (i % 11) + 50.0f);
+      robot->set_pixel_y((i < 11) ? 150.0f : 430.0f);
+      robot->set_height(140.0f);
+    }
+  }
+
+  RoboCup2014Legacy::Wrapper::SSL_WrapperPacket legacy_packet;
+  long long sent = 0;
+  long long received = 0;
+  long long legacy_received = 0;
+  long long datagrams = 0;
+  long long batches = 0;
+  double t_receive = 0.0;
+  double latency_sum = 0.0;
+  //send all cameras at once per frame, as synchronized cameras do, and
+  //receive in between. The last 100ms drain what is still queued:
+  double t_start = GetTimeSec();
+  double t_stop = t_start + duration;
+  double t_end = t_stop + 0.1;
+  int frame_number = 0;
+  double t_next = t_start;
+  double t_now;
+  while ((t_now = GetTimeSec()) < t_end) {
+    if (t_now >= t_next && t_now < t_stop) {
+      for (int c = 0; c < cameras; c++) {
+        frames[c].set_frame_number(frame_number);
+        frames[c].set_t_capture(t_now);
+        if (server.send(frames[c])) sent++;
+        legacy_server.sendLegacyMessage(frames[c]);
+      }
+      frame_number++;
+      t_next = t_start + frame_number / fps;
+      continue;
+    }
+    double t_wait = (t_next < t_stop) ? t_next : t_end;
+    int timeout_ms = (int)ceil((t_wait - t_now) * 1000.0);
+    int ready = group.wait(max(timeout_ms,0));
+    double t_batch = GetTimeSec();
+    for (int r = 0; r < ready; r++) {
+      RoboCupSSLClient * c = group.getReady(r);
+      int n;
+      while ((n = c->receiveBatch()) > 0) {
+        batches++;
+        datagrams += n;
+        for (int i = 0; i < n; i++) {
+          if (c == &legacy_client) {
+            if (c->parseBatchData(i,legacy_packet) && legacy_packet.has_detection()) legacy_received++;
+          } else if (c->isBatchPacketValid(i) && c->getBatchPacket(i).has_detection()) {
+            received++;
+            latency_sum += t_batch - c->getBatchPacket(i).detection().t_sent();
+          }
+        }
+      }
+    }
+    t_receive += GetTimeSec() - t_batch;
+  }
+
+  printf("receive throughput, %d cameras at %.1f fps for %.1f s on the current and legacy port:\n",
+         cameras, fps, duration);
+  printf("  sent=%lld received=%lld (%5.1f%%) legacy received=%lld (%5.1f%%)\n",
+         sent, received, 100.0 * received / max(sent,1LL),
+         legacy_received, 100.0 * legacy_received / max(sent,1LL));
+  printf("  %lld datagrams in %lld batches (%.1f per batch), %.2f us receive time per datagram, latency=%.3f ms\n",
+         datagrams, batches, (double)datagrams / max(batches,1LL),
+         t_receive / max(datagrams,1LL) * 1.0E6, latency_sum / max(received,1LL) * 1000.0);
+  fflush(stdout);
+  return received >= sent * 0.99 && legacy_received >= sent * 0.99;
+}
+
+int main(int argc, char *argv[])
+{
+  QApplication app(argc, argv, false);
+
+  GetOpt opts(argc, argv);
+  bool help=false;
+  bool conversions=false;
+  bool projection=false;
+  bool spatial_index=false;
+  bool histogram=false;
+  bool roi_tracking=false;
+  bool ball_tracking=false;
+  bool candidates=false;
+  bool balls=false;
+  bool rois=false;
+  bool raw_video=false;
+  bool receive=false;
+  QString s_cameras="1", s_max_cameras="", s_fps="60", s_duration="10", s_warmup="2";
+  QString s_width="780", s_height="580", s_dir="", s_robots="", s_noise="2000", s_replay="fps";
+  opts.addSwitch("help",&help);
+  opts.addSwitch("conversions",&conversions);
+  opts.addSwitch("projection",&projection);
+  opts.addSwitch("spatial-index",&spatial_index);
+  opts.addSwitch("histogram",&histogram);
+  opts.addSwitch("roi-tracking",&roi_tracking);
+  opts.addSwitch("ball-tracking",&ball_tracking);
+  opts.addSwitch("candidates",&candidates);
+  opts.addSwitch("balls",&balls);
+  opts.addSwitch("rois",&rois);
+  opts.addSwitch("raw-video",&raw_video);
+  opts.addSwitch("receive",&receive);
+  opts.addOption('n',"noise",&s_noise);
+  opts.addOption('c',"cameras",&s_cameras);
+  opts.addOption('m',"max-cameras",&s_max_cameras);
+  opts.addOption('f',"fps",&s_fps);
+  opts.addOption('d',"duration",&s_duration);
+  opts.addOption('W',"warmup",&s_warmup);
+  opts.addOption('x',"width",&s_width);
+  opts.addOption('y',"height",&s_height);
+  opts.addOption('i',"input",&s_dir);
+  opts.addOption('r',"robots",&s_robots);
+  opts.addOption('p',"replay",&s_replay);
+  int ecode=0;
+  if (!opts.parse()) {
+    fprintf(stderr,"Invalid command line parameters!\n");
+    help=true;
+    ecode=1;
+  }
+
+  if (help) {
+    printf("SSL-Vision end-to-end benchmark options:\n");
+    printf(" -c N      Number of cameras to run (default 1)\n");
+    printf(" -m N      Find the maximum sustained camera count, trying 1..N cameras\n");
+    printf(" -f FPS    Frame rate of each generated camera and the rate every\n");
+    printf("           camera has to sustain (default 60)\n");
+    printf(" -d SEC    Measurement duration per run (default 10)\n");
+    printf(" -W SEC    Warm-up time per run that is not measured (default 2)\n");
+    printf(" -x W      Width of generated frames (default 780)\n");
+    printf(" -y H      Height of generated frames (default 580)\n");
+    printf(" -i DIR    Replay images from DIR instead of using the generator\n");
+    printf(" -i FILE   Replay a raw video file instead of using the generator\n");
+    printf(" -p MODE   Pacing of replayed input: 'fps' replays at -f (default),\n");
+    printf("           'recorded' follows the timestamps of a raw video file,\n");
+    printf("           'fast' replays as fast as possible\n");
+    printf(" -r N      Let the generator render a scene with N robots per team and\n");
+    printf("           report the detection accuracy against its ground truth\n");
+    printf(" --roi-tracking  Restrict segmentation to windows around tracked\n");
+    printf("           objects and report the tracking statistics\n");
+    printf(" --ball-tracking  Track the ball of every camera and search it in the\n");
+    printf("           predicted window first, and report the tracking statistics\n");
+    printf(" --conversions  Check and measure the color conversions on W x H\n");
+    printf("           images for 1/10 of the duration each, instead\n");
+    printf(" --projection  Compare the camera model's lookup grid and snapshot\n");
+    printf("           against the exact projection and the live camera\n");
+    printf("           parameters on W x H images, instead\n");
+    printf(" --spatial-index  Compare the marker region grid against the\n");
+    printf("           region tree for 16 robots on W x H images, for 1/10\n");
+    printf("           of the duration, instead\n");
+    printf(" --histogram  Compare the integral histogram against scanning\n");
+    printf("           the boxes of a W x H label image, for 1/10 of the\n");
+    printf("           duration, instead\n");
+    printf(" --candidates  Compare the robot candidate selection against\n");
+    printf("           sorted insertion for 500 team marker blobs, for 1/10\n");
+    printf("           of the duration, instead\n");
+    printf(" --balls   Run the ball detection on 200 orange false positives\n");
+    printf("           around a real ball on W x H frames, for 1/10 of the\n");
+    printf("           duration, instead\n");
+    printf(" --rois    Compare ROI thresholding and runlength encoding of 16\n");
+    printf("           windows against a full scan of W x H frames in UYVY,\n");
+    printf("           YUV444 and RAW8, for 1/10 of the duration, instead\n");
+    printf(" --raw-video  Write raw video files of W x H frames, read them back\n");
+    printf("           and replay them with seeking and looping, instead\n");
+    printf(" --receive  Send detections of C cameras at -f FPS on the current\n");
+    printf("           and legacy ports and receive them with one client group,\n");
+    printf("           for the duration, instead (e.g. --receive -c 8 -f 120)\n");
+    printf(" -n N      Number of noise blobs for --spatial-index (default 2000)\n");
+    printf(" --help    Show this help\n");
+    printf("Output is received on 224.5.23.2:10006, make sure no other\n");
+    printf("vision instance is publishing there.\n");
+    exit(ecode);
+  }
+
+  double fps = s_fps.toDouble();
+  double duration = s_duration.toDouble();
+  double warmup = s_warmup.toDouble();
+  int width = s_width.toInt();
+  int height = s_height.toInt();
+  int scene_robots = s_robots.isEmpty() ? -1 : s_robots.toInt();
+  if (scene_robots >= 0 && !s_dir.isEmpty()) {
+    fprintf(stderr,"-r only applies to the generator, not to replayed input.\n");
+    return 1;
+  }
+  if (s_replay != "fps" && s_replay != "recorded" && s_replay != "fast") {
+    fprintf(stderr,"Unknown replay mode '%s'.\n",s_replay.toStdString().c_str());
+    return 1;
+  }
+  if (s_replay == "recorded" && !QFileInfo(s_dir).isFile()) {
+    fprintf(stderr,"-p recorded needs a raw video file as input.\n");
+    return 1;
+  }
+
+  if (conversions) {
+    return runConversionBenchmark(width,height,duration/10.0) ? 0 : 1;
+  }
+
+  if (projection) {
+    runProjectionBenchmark(width,height);
+    return 0;
+  }
+
+  if (spatial_index) {
+    return runSpatialIndexBenchmark(width,height,s_noise.toInt(),duration/10.0) ? 0 : 1;
+  }
+
+  if (candidates) {
+    return runCandidateBenchmark(duration/10.0) ? 0 : 1;
+  }
+
+  if (balls) {
+    return runBallBenchmark(width,height,duration/10.0) ? 0 : 1;
+  }
+
+  if (histogram) {
+    return runHistogramBenchmark(width,height,duration/10.0) ? 0 : 1;
+  }
+
+  if (rois) {
+    return runROIBenchmark(width,height,duration/10.0) ? 0 : 1;
+  }
+
+  if (raw_video) {
+    return runRawVideoCheck(width,height) ? 0 : 1;
+  }
+
+  if (receive) {
+    return runReceiveBenchmark(s_cameras.toInt(),fps,duration) ? 0 : 1;
+  }
+
+  BenchmarkResult result;
+  if (s_max_cameras.isEmpty()) {
+    if (!runBenchmark(s_cameras.toInt(),fps,duration,warmup,s_dir,s_replay,width,height,scene_robots,roi_tracking,ball_tracking,result)) return 1;
+    printResult(result,fps);
+    return isSustained(result,fps,0.95) ? 0 : 2;
+  }
+
+  int max_cameras = s_max_cameras.toInt();
+  int sustained = 0;
+  for (int cameras = 1; cameras <= max_cameras; cameras++) {
+    if (!runBenchmark(cameras,fps,duration,warmup,s_dir,s_replay,width,height,scene_robots,roi_tracking,ball_tracking,result)) return 1;
+    printResult(result,fps);
+    if (!isSustained(result,fps,0.95)) break;
+    sustained = cameras;
+  }
+  printf("Maximum sustained camera count at %.1f fps: %d\n",fps,sustained);
+  return 0;
+}
@@ -31,6 +31,7 @@
 #include "messages_robocup_ssl_detection.pb.h"
 #include "messages_robocup_ssl_geometry.pb.h"
 #include "messages_robocup_ssl_wrapper.pb.h"
+#include "messages_robocup_ssl_wrapper_legacy.pb.h"
 
 void printRobotInfo(const SSL_DetectionRobot & robot) {
     printf("CONF=%4.2f ", robot.confidence());
@@ -49,100 +50,145 @@ void printRobotInfo(const SSL_DetectionRobot & robot) {
 }
 
 
+void printDetection(const SSL_DetectionFrame & detection) {
+    //Display the contents of the robot detection results:
+    double t_now = GetTimeSec();
+
+    printf("-[Detection Data]-------\n");
+    //Frame info:
+    printf("Camera ID=%d FRAME=%d T_CAPTURE=%.4f\n",detection.camera_id(),detection.frame_number(),detection.t_capture());
+
+    printf("SSL-Vision Processing Latency                   %7.3fms\n",(detection.t_sent()-detection.t_capture())*1000.0);
+    printf("Network Latency (assuming synched system clock) %7.3fms\n",(t_now-detection.t_sent())*1000.0);
+    printf("Total Latency   (assuming synched system clock) %7.3fms\n",(t_now-detection.t_capture())*1000.0);
+    int balls_n = detection.balls_size();
+    int robots_blue_n =  detection.robots_blue_size();
+    int robots_yellow_n =  detection.robots_yellow_size();
+
+    //Ball info:
+    for (int i = 0; i < balls_n; i++) {
+        const SSL_DetectionBall & ball = detection.balls(i);
+        printf("-Ball (%2d/%2d): CONF=%4.2f POS=<%9.2f,%9.2f> ", i+1, balls_n, ball.confidence(),ball.x(),ball.y());
+        if (ball.has_z()) {
+            printf("Z=%7.2f ",ball.z());
+        } else {
+            printf("Z=N/A   ");
+        }
+        printf("RAW=<%8.2f,%8.2f>\n",ball.pixel_x(),ball.pixel_y());
+    }
+
+    //Blue robot info:
+    for (int i = 0; i < robots_blue_n; i++) {
+        const SSL_DetectionRobot & robot = detection.robots_blue(i);
+        printf("-Robot(B) (%2d/%2d): ",i+1, robots_blue_n);
+        printRobotInfo(robot);
+    }
+
+    //Yellow robot info:
+    for (int i = 0; i < robots_yellow_n; i++) {
+        const SSL_DetectionRobot & robot = detection.robots_yellow(i);
+        printf("-Robot(Y) (%2d/%2d): ",i+1, robots_yellow_n);
+        printRobotInfo(robot);
+    }
+}
+
+void printPacket(const SSL_WrapperPacket & packet) {
+    printf("-----Received Wrapper Packet---------------------------------------------\n");
+    //see if the packet contains a robot detection frame:
+    if (packet.has_detection()) {
+        printDetection(packet.detection());
+    }
+
+    //see if packet contains geometry data:
+    if (packet.has_geometry()) {
+        const SSL_GeometryData & geom = packet.geometry();
+        printf("-[Geometry Data]-------\n");
+
+        const SSL_GeometryFieldSize & field = geom.field();
+        printf("Field Dimensions:\n");
+        printf("  -field_length=%d (mm)\n",field.field_length());
+        printf("  -field_width=%d (mm)\n",field.field_width());
+        printf("  -boundary_width=%d (mm)\n",field.boundary_width());
+        printf("  -goal_width=%d (mm)\n",field.goal_width());
+        printf("  -goal_depth=%d (mm)\n",field.goal_depth());
+        printf("  -field_lines_size=%d\n",field.field_lines_size());
+        printf("  -field_arcs_size=%d\n",field.field_arcs_size());
+
+        int calib_n = geom.calib_size();
+        for (int i=0; i< calib_n; i++) {
+            const SSL_GeometryCameraCalibration & calib = geom.calib(i);
+            printf("Camera Geometry for Camera ID %d:\n", calib.camera_id());
+            printf("  -focal_length=%.2f\n",calib.focal_length());
+            printf("  -principal_point_x=%.2f\n",calib.principal_point_x());
+            printf("  -principal_point_y=%.2f\n",calib.principal_point_y());
+            printf("  -distortion=%.2f\n",calib.distortion());
+            printf("  -q0=%.2f\n",calib.q0());
+            printf("  -q1=%.2f\n",calib.q1());
+            printf("  -q2=%.2f\n",calib.q2());
+            printf("  -q3=%.2f\n",calib.q3());
+            printf("  -tx=%.2f\n",calib.tx());
+            printf("  -ty=%.2f\n",calib.ty());
+            printf("  -tz=%.2f\n",calib.tz());
+
+            if (calib.has_derived_camera_world_tx() && calib.has_derived_camera_world_ty() && calib.has_derived_camera_world_tz()) {
+              printf("  -derived_camera_world_tx=%.f\n",calib.derived_camera_world_tx());
+              printf("  -derived_camera_world_ty=%.f\n",calib.derived_camera_world_ty());
+              printf("  -derived_camera_world_tz=%.f\n",calib.derived_camera_world_tz());
+            }
+
+        }
+    }
+}
+
+void printLegacyPacket(const RoboCup2014Legacy::Wrapper::SSL_WrapperPacket & packet) {
+    printf("-----Received Legacy Wrapper Packet--------------------------------------\n");
+    if (packet.has_detection()) {
+        printDetection(packet.detection());
+    }
+    if (packet.has_geometry()) {
+        const RoboCup2014Legacy::Geometry::SSL_GeometryFieldSize & field = packet.geometry().field();
+        printf("-[Legacy Geometry Data]-------\n");
+        printf("Field Dimensions:\n");
+        printf("  -field_length=%d (mm)\n",field.field_length());
+        printf("  -field_width=%d (mm)\n",field.field_width());
+        printf("  -boundary_width=%d (mm)\n",field.boundary_width());
+        printf("  -goal_width=%d (mm)\n",field.goal_width());
+        printf("  -goal_depth=%d (mm)\n",field.goal_depth());
+        printf("  -calib_size=%d\n",packet.geometry().calib_size());
+    }
+}
+
 int main(int argc, char *argv[])
 {
     (void)argc;
     (void)argv;
 
-    RoboCupSSLClient client;
-    client.open(true);
-    SSL_WrapperPacket packet;
+    //the current protocol, and the legacy protocol of older vision
+    //versions, watched with one epoll set. Legacy packets are only printed
+    //until the current protocol is heard from, as current visions publish
+    //both:
+    RoboCupSSLClient client(10006);
+    RoboCupSSLClient legacy_client(10005);
+    RoboCupSSLClientGroup group;
+    if (client.open(false)) group.add(&client);
+    if (legacy_client.open(false)) group.add(&legacy_client);
+    RoboCup2014Legacy::Wrapper::SSL_WrapperPacket legacy_packet;
+    bool have_current = false;
 
     while(true) {
-        if (client.receive(packet)) {
-            printf("-----Received Wrapper Packet---------------------------------------------\n");
-            //see if the packet contains a robot detection frame:
-            if (packet.has_detection()) {
-                SSL_DetectionFrame detection = packet.detection();
-                //Display the contents of the robot detection results:
-                double t_now = GetTimeSec();
-
-                printf("-[Detection Data]-------\n");
-                //Frame info:
-                printf("Camera ID=%d FRAME=%d T_CAPTURE=%.4f\n",detection.camera_id(),detection.frame_number(),detection.t_capture());
-
-                printf("SSL-Vision Processing Latency                   %7.3fms\n",(detection.t_sent()-detection.t_capture())*1000.0);
-                printf("Network Latency (assuming synched system clock) %7.3fms\n",(t_now-detection.t_sent())*1000.0);
-                printf("Total Latency   (assuming synched system clock) %7.3fms\n",(t_now-detection.t_capture())*1000.0);
-                int balls_n = detection.balls_size();
-                int robots_blue_n =  detection.robots_blue_size();
-                int robots_yellow_n =  detection.robots_yellow_size();
-
-                //Ball info:
-                for (int i = 0; i < balls_n; i++) {
-                    SSL_DetectionBall ball = detection.balls(i);
-                    printf("-Ball (%2d/%2d): CONF=%4.2f POS=<%9.2f,%9.2f> ", i+1, balls_n, ball.confidence(),ball.x(),ball.y());
-                    if (ball.has_z()) {
-                        printf("Z=%7.2f ",ball.z());
-                    } else {
-                        printf("Z=N/A   ");
+        int ready = group.wait();
+        for (int r = 0; r < ready; r++) {
+            RoboCupSSLClient * c = group.getReady(r);
+            //drain all pending datagrams, one recvmmsg call per batch:
+            int n;
+            while ((n = c->receiveBatch()) > 0) {
+                for (int i = 0; i < n; i++) {
+                    if (c == &legacy_client) {
+                        if (have_current == false && c->parseBatchData(i,legacy_packet)) printLegacyPacket(legacy_packet);
+                    } else if (c->isBatchPacketValid(i)) {
+                        have_current = true;
+                        printPacket(c->getBatchPacket(i));
                     }
-                    printf("RAW=<%8.2f,%8.2f>\n",ball.pixel_x(),ball.pixel_y());
-                }
-
-                //Blue robot info:
-                for (int i = 0; i < robots_blue_n; i++) {
-                    SSL_DetectionRobot robot = detection.robots_blue(i);
-                    printf("-Robot(B) (%2d/%2d): ",i+1, robots_blue_n);
-                    printRobotInfo(robot);
-                }
-
-                //Yellow robot info:
-                for (int i = 0; i < robots_yellow_n; i++) {
-                    SSL_DetectionRobot robot = detection.robots_yellow(i);
-                    printf("-Robot(Y) (%2d/%2d): ",i+1, robots_yellow_n);
-                    printRobotInfo(robot);
-                }
-
-            }
-
-            //see if packet contains geometry data:
-            if (packet.has_geometry()) {
-                const SSL_GeometryData & geom = packet.geometry();
-                printf("-[Geometry Data]-------\n");
-
-                const SSL_GeometryFieldSize & field = geom.field();
-                printf("Field Dimensions:\n");
-                printf("  -field_length=%d (mm)\n",field.field_length());
-                printf("  -field_width=%d (mm)\n",field.field_width());
-                printf("  -boundary_width=%d (mm)\n",field.boundary_width());
-                printf("  -goal_width=%d (mm)\n",field.goal_width());
-                printf("  -goal_depth=%d (mm)\n",field.goal_depth());
-                printf("  -field_lines_size=%d\n",field.field_lines_size());
-                printf("  -field_arcs_size=%d\n",field.field_arcs_size());
-
-                int calib_n = geom.calib_size();
-                for (int i=0; i< calib_n; i++) {
-                    const SSL_GeometryCameraCalibration & calib = geom.calib(i);
-                    printf("Camera Geometry for Camera ID %d:\n", calib.camera_id());
-                    printf("  -focal_length=%.2f\n",calib.focal_length());
-                    printf("  -principal_point_x=%.2f\n",calib.principal_point_x());
-                    printf("  -principal_point_y=%.2f\n",calib.principal_point_y());
-                    printf("  -distortion=%.2f\n",calib.distortion());
-                    printf("  -q0=%.2f\n",calib.q0());
-                    printf("  -q1=%.2f\n",calib.q1());
-                    printf("  -q2=%.2f\n",calib.q2());
-                    printf("  -q3=%.2f\n",calib.q3());
-                    printf("  -tx=%.2f\n",calib.tx());
-                    printf("  -ty=%.2f\n",calib.ty());
-                    printf("  -tz=%.2f\n",calib.tz());
-
-                    if (calib.has_derived_camera_world_tx() && calib.has_derived_camera_world_ty() && calib.has_derived_camera_world_tz()) {
-                      printf("  -derived_camera_world_tx=%.f\n",calib.derived_camera_world_tx());
-                      printf("  -derived_camera_world_ty=%.f\n",calib.derived_camera_world_ty());
-                      printf("  -derived_camera_world_tz=%.f\n",calib.derived_camera_world_tz());
-                    }
-
                 }
             }
         }
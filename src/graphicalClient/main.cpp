@@ -24,6 +24,7 @@
 #include <QApplication>
 #include "soccerview.h"
 #include "timer.h"
+#include "messages_robocup_ssl_wrapper_legacy.pb.h"
 
 GLSoccerView *view;
 
@@ -34,21 +35,43 @@ class MyThread : public QThread
 protected:
   void run()
   {
-    static const double minDuration = 0.01; //100FPS
-    RoboCupSSLClient client;
-    client.open(false);
-    SSL_WrapperPacket packet;
+    static const int maxWaitMSec = 10;
+    //the current and the legacy protocol, watched with one epoll set.
+    //Legacy detections are only shown until the current protocol is heard
+    //from, as current visions publish both. The legacy geometry has
+    //another field format and is not shown:
+    RoboCupSSLClient client(10006);
+    RoboCupSSLClient legacy_client(10005);
+    RoboCupSSLClientGroup group;
+    if (client.open(false)) group.add(&client);
+    if (legacy_client.open(false)) group.add(&legacy_client);
+    RoboCup2014Legacy::Wrapper::SSL_WrapperPacket legacy_packet;
+    bool have_current = false;
     while(runApp) {
-      while (client.receive(packet)) {
-        if (packet.has_detection()) {
-          SSL_DetectionFrame detection = packet.detection();
-          view->updateDetection(detection);
-        }
-        if (packet.has_geometry()) {
-          view->updateFieldGeometry(packet.geometry().field());
+      int ready = group.wait(maxWaitMSec);
+      for (int r = 0; r < ready; r++) {
+        RoboCupSSLClient * c = group.getReady(r);
+        int n;
+        while ((n = c->receiveBatch()) > 0) {
+          for (int i = 0; i < n; i++) {
+            if (c == &legacy_client) {
+              if (have_current == false && c->parseBatchData(i,legacy_packet) && legacy_packet.has_detection()) {
+                view->updateDetection(legacy_packet.detection());
+              }
+              continue;
+            }
+            if (!c->isBatchPacketValid(i)) continue;
+            have_current = true;
+            const SSL_WrapperPacket & packet = c->getBatchPacket(i);
+            if (packet.has_detection()) {
+              view->updateDetection(packet.detection());
+            }
+            if (packet.has_geometry()) {
+              view->updateFieldGeometry(packet.geometry().field());
+            }
+          }
         }
       }
-      Sleep(minDuration);
     }
   }
   
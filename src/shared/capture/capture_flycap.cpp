@@ -30,6 +30,7 @@
 #include "capturedc1394v2.h"
 #include "FlyCapture2.h"
 #include "conversions.h"
+#include "bayer.h"
 #include "colors.h"
 #include "VarTypes.h"
 #include <iostream>
@@ -131,6 +132,8 @@ CaptureFlycap::CaptureFlycap(VarList * _settings,int default_camera_id, QObject
       "convert to mode",Colors::colorFormatToString(COLOR_YUV422_UYVY)));
     v_colorout->addItem(Colors::colorFormatToString(COLOR_RGB8));
     v_colorout->addItem(Colors::colorFormatToString(COLOR_YUV422_UYVY));
+    v_colorout->addItem(Colors::colorFormatToString(COLOR_YUV444));
+    v_colorout->addItem(Colors::colorFormatToString(COLOR_RAW8));
 
     conversion_settings->addChild(v_debayer=new VarBool("de-bayer",false));
     conversion_settings->addChild(v_debayer_pattern=new VarStringEnum("de-bayer pattern",colorFilterToString(DC1394_COLOR_FILTER_MIN)));
@@ -142,6 +145,8 @@ CaptureFlycap::CaptureFlycap(VarList * _settings,int default_camera_id, QObject
       v_debayer_method->addItem(bayerMethodToString((dc1394bayer_method_t)i));
     }
     conversion_settings->addChild(v_debayer_y16=new VarInt("de-bayer y16 bits",16));
+    conversion_settings->addChild(v_debayer_native=new VarBool("native de-bayer (8 bit)",false));
+    conversion_settings->addChild(v_debayer_threads=new VarInt("de-bayer threads",1,1,16));
     //dcam_parameters->addFlags( VARTYPE_FLAG_HIDE_CHILDREN );
 
     //=======================CAPTURE SETTINGS==========================
@@ -517,7 +522,9 @@ bool CaptureFlycap::copyAndConvertFrame(const RawImage & src,
                       v_debayer->getBool(),
                       stringToColorFilter(v_debayer_pattern->getSelection().c_str()),
                       stringToBayerMethod(v_debayer_method->getSelection().c_str()),
-                      v_debayer_y16->getInt());
+                      v_debayer_y16->getInt(),
+                      v_debayer_native->getBool(),
+                      v_debayer_threads->getInt());
 }
 
 bool CaptureFlycap::convertFrame(const RawImage & src,
@@ -526,7 +533,9 @@ bool CaptureFlycap::convertFrame(const RawImage & src,
                            bool debayer,
                            dc1394color_filter_t bayer_format,
                            dc1394bayer_method_t bayer_method,
-                           int y16bits) {
+                           int y16bits,
+                           bool native_debayer,
+                           int debayer_threads) {
   mutex.lock();
 
   int width = v_width->getInt();
@@ -545,7 +554,12 @@ bool CaptureFlycap::convertFrame(const RawImage & src,
     memcpy(target.getData(),src.getData(),src.getNumBytes());
   } else {
     //do some more fancy conversion
-    if ((src_fmt==COLOR_MONO8 || src_fmt==COLOR_RAW8) && output_fmt==COLOR_RGB8) {
+    if ((src_fmt==COLOR_MONO8 || src_fmt==COLOR_RAW8) && debayer && native_debayer && Bayer::isSupportedOutput(output_fmt)) {
+      //de-bayer straight into the output format, without a full RGB intermediate
+      Bayer::demosaic(src.getData(), target.getData(), src.getWidth(), src.getHeight(),
+                      (Bayer::Pattern)(bayer_format - DC1394_COLOR_FILTER_MIN), output_fmt, debayer_threads,
+                      &debayer_workers);
+    } else if ((src_fmt==COLOR_MONO8 || src_fmt==COLOR_RAW8) && output_fmt==COLOR_RGB8) {
       //check whether to debayer or simply average to a grey rgb image
       if (debayer) {
         //de-bayer
@@ -44,6 +44,7 @@
 #include <dc1394/control.h>
 #include <dc1394/conversions.h>
 #include "VarTypes.h"
+#include "worker_threads.h"
 
 
 typedef struct {
@@ -154,6 +155,9 @@ protected:
     VarStringEnum * v_debayer_method;
     VarInt        * v_debayer_y16;
     VarBool       * v_debayer;
+    VarBool       * v_debayer_native;
+    VarInt        * v_debayer_threads;
+    WorkerThreads   debayer_workers;
 
     //DCAM parameters:
     VarList * P_WHITE_BALANCE;
@@ -232,7 +236,9 @@ protected:
                            bool debayer=true,
                            dc1394color_filter_t bayer_format=DC1394_COLOR_FILTER_RGGB,
                            dc1394bayer_method_t bayer_method=DC1394_BAYER_METHOD_HQLINEAR,
-                           int y16bits=16);
+                           int y16bits=16,
+                           bool native_debayer=false,
+                           int debayer_threads=1);
 };
 
 #endif //  CAPTURE_FLYCAP_H
@@ -44,10 +44,16 @@ CaptureGenerator::CaptureGenerator ( VarList * _settings ) : CaptureInterface (
   capture_settings->addChild ( v_width = new VarInt ( "Width (pixels)", 780 ) );
   capture_settings->addChild ( v_height = new VarInt ( "Height (pixels)", 580 ) );
   capture_settings->addChild ( v_test_image = new VarBool ( "Generate Color Test Image", false ) );
+
+  //=======================SCENE SETTINGS============================
+  settings->addChild ( scene_settings = new VarList ( "Scene" ) );
+  scene = new GeneratorScene ( scene_settings );
+  frame_number=0;
 }
 
 CaptureGenerator::~CaptureGenerator()
 {
+  delete scene;
 }
 
 bool CaptureGenerator::stopCapture()
@@ -73,6 +79,8 @@ bool CaptureGenerator::startCapture()
   mutex.lock();
 #endif
   limit.init ( v_framerate->getDouble() );
+  frame_number=0;
+  scene->clearHistory();
   is_capturing=true;
 
 
@@ -101,8 +109,7 @@ bool CaptureGenerator::copyAndConvertFrame ( const RawImage & src, RawImage & ta
     if ( src.getData() != 0 ) memcpy ( target.getData(),src.getData(),src.getNumBytes() );
   } else if ( src_fmt == COLOR_RGB8 && output_fmt == COLOR_YUV422_UYVY ) {
     if ( src.getData() != 0 ) {
-      dc1394_convert_to_YUV422 ( src.getData(), target.getData(), src.getWidth(), src.getHeight(),
-                                 DC1394_BYTE_ORDER_UYVY, DC1394_COLOR_CODING_RGB8, 8 );
+      Conversions::rgb2uyvy ( src.getData(), target.getData(), src.getWidth(), src.getHeight() );
     }
   } else {
     fprintf ( stderr,"Cannot copy and convert frame...unknown conversion selected from: %s to %s\n",
@@ -131,7 +138,13 @@ RawImage CaptureGenerator::getFrame()
   rgbImage img;
   img.fromRawImage(result);
 
-  if (v_test_image->getBool()) {
+  if (scene->isEnabled()) {
+    //scene time advances by exactly one frame period per frame, which
+    //keeps the rendered poses independent of the actual timing:
+    double fps = v_framerate->getDouble();
+    scene->render(img, frame_number, fps > 0.0 ? frame_number / fps : 0.0, result.getTime());
+    frame_number++;
+  } else if (v_test_image->getBool()) {
     int w = result.getWidth();
     int h = result.getHeight();
     int n_colors = 8;
@@ -186,6 +199,18 @@ void CaptureGenerator::releaseFrame()
 #endif
 }
 
+bool CaptureGenerator::getGroundTruth ( double time, GeneratorScene::GroundTruth & truth )
+{
+#ifndef VDATA_NO_QT
+  mutex.lock();
+#endif
+  bool found = scene->getGroundTruth ( time, truth );
+#ifndef VDATA_NO_QT
+  mutex.unlock();
+#endif
+  return found;
+}
+
 string CaptureGenerator::getCaptureMethodName() const
 {
   return "Image Generator";
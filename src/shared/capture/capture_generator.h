@@ -28,6 +28,7 @@
 #include "framecounter.h"
 #include "framelimiter.h"
 #include "image.h"
+#include "generator_scene.h"
 #ifndef VDATA_NO_QT
   #include <QMutex>
 #else
@@ -66,7 +67,11 @@ protected:
   VarInt * v_height;
   VarDouble * v_framerate;
   VarBool * v_test_image;
-  
+
+  VarList * scene_settings;
+  GeneratorScene * scene;
+  int frame_number;
+
 public:
 #ifndef VDATA_NO_QT
   CaptureGenerator(VarList * _settings, QObject * parent=0);
@@ -87,6 +92,10 @@ public:
 
   virtual bool copyAndConvertFrame(const RawImage & src, RawImage & target);
   virtual string getCaptureMethodName() const;
+
+  /// ground truth robot and ball poses of the generated frame with
+  /// capture time \p time, if the scene is enabled.
+  bool getGroundTruth(double time, GeneratorScene::GroundTruth & truth);
 };
 
 #endif
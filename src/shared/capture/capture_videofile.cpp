@@ -0,0 +1,278 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    capture_videofile.cpp
+  \brief   C++ Implementation: CaptureVideoFile
+  \author  Author Name, 2026
+*/
+//========================================================================
+
+#include "capture_videofile.h"
+#include "conversions.h"
+#include "bayer.h"
+#include "timer.h"
+#include <unistd.h>
+
+#ifndef VDATA_NO_QT
+CaptureVideoFile::CaptureVideoFile(VarList * _settings, QObject * parent) : QObject(parent), CaptureInterface(_settings)
+#else
+CaptureVideoFile::CaptureVideoFile(VarList * _settings) : CaptureInterface(_settings)
+#endif
+{
+  is_capturing=false;
+  current_frame=0;
+  last_seek=0;
+  pace_wall_start=0.0;
+  pace_video_start=0.0;
+
+  settings->addChild(conversion_settings = new VarList("Conversion Settings"));
+  settings->addChild(capture_settings = new VarList("Capture Settings"));
+
+  //=======================CONVERSION SETTINGS=======================
+  conversion_settings->addChild(v_colorout=new VarStringEnum("convert to mode",Colors::colorFormatToString(COLOR_YUV422_UYVY)));
+  v_colorout->addItem(Colors::colorFormatToString(COLOR_RGB8));
+  v_colorout->addItem(Colors::colorFormatToString(COLOR_YUV422_UYVY));
+  v_colorout->addItem(Colors::colorFormatToString(COLOR_RAW8));
+  conversion_settings->addChild(v_zero_copy=new VarBool("zero-copy (if no conversion)",true));
+
+  //=======================CAPTURE SETTINGS==========================
+  capture_settings->addChild(v_file = new VarString("file", ""));
+  capture_settings->addChild(v_pacing = new VarStringEnum("playback speed","recorded timestamps"));
+  v_pacing->addItem("recorded timestamps");
+  v_pacing->addItem("fixed framerate");
+  v_pacing->addItem("as fast as possible");
+  capture_settings->addChild(v_framerate = new VarDouble("framerate (fixed)", 60.0, 0.1));
+  capture_settings->addChild(v_loop = new VarBool("loop", true));
+  capture_settings->addChild(v_recorded_time = new VarBool("use recorded timestamps", true));
+  capture_settings->addChild(v_seek = new VarInt("seek to frame", 0, 0));
+  capture_settings->addChild(v_frame_count = new VarInt("frames in file", 0));
+  v_frame_count->addFlags(VARTYPE_FLAG_READONLY);
+}
+
+CaptureVideoFile::~CaptureVideoFile()
+{
+  reader.close();
+}
+
+bool CaptureVideoFile::stopCapture()
+{
+  cleanup();
+  return true;
+}
+
+void CaptureVideoFile::cleanup()
+{
+#ifndef VDATA_NO_QT
+  mutex.lock();
+#endif
+  //frames borrowed from the mapping have been detached by the capture thread
+  reader.close();
+  is_capturing=false;
+#ifndef VDATA_NO_QT
+  mutex.unlock();
+#endif
+}
+
+bool CaptureVideoFile::startCapture()
+{
+#ifndef VDATA_NO_QT
+  mutex.lock();
+#endif
+  if (reader.open(v_file->getString()) == false || reader.getFrameCount() == 0) {
+    fprintf(stderr,"CaptureVideoFile: no frames to play from '%s'\n", v_file->getString().c_str());
+    reader.close();
+    is_capturing=false;
+#ifndef VDATA_NO_QT
+    mutex.unlock();
+#endif
+    return false;
+  }
+  printf("CaptureVideoFile: %d frames of %dx%d %s\n", reader.getFrameCount(), reader.getWidth(), reader.getHeight(),
+         Colors::colorFormatToString(reader.getColorFormat()).c_str());
+  v_frame_count->setInt(reader.getFrameCount());
+  v_seek->setMax(reader.getFrameCount()-1);
+  last_seek = v_seek->getInt();
+  current_frame = min(max(0, last_seek), reader.getFrameCount()-1);
+  restartPacing();
+  is_capturing=true;
+#ifndef VDATA_NO_QT
+  mutex.unlock();
+#endif
+  return true;
+}
+
+void CaptureVideoFile::seek(int frame)
+{
+#ifndef VDATA_NO_QT
+  mutex.lock();
+#endif
+  if (reader.isOpen()) {
+    current_frame = min(max(0, frame), reader.getFrameCount()-1);
+    restartPacing();
+  }
+#ifndef VDATA_NO_QT
+  mutex.unlock();
+#endif
+}
+
+/// The next frame is shown right away, later frames are paced relative to it.
+void CaptureVideoFile::restartPacing()
+{
+  pace_wall_start = -1.0;
+  limit.init(max(0.1, v_framerate->getDouble()));
+}
+
+void CaptureVideoFile::waitForFrame(int frame)
+{
+  string pacing = v_pacing->getSelection();
+  if (pacing == "as fast as possible") return;
+  if (pacing == "fixed framerate") {
+    limit.waitForNextFrame();
+    return;
+  }
+  double video_time = reader.getFrameTime(frame);
+  double now = GetTimeSec();
+  if (pace_wall_start < 0.0 || video_time < pace_video_start) {
+    //first frame, or the recording wrapped around
+    pace_wall_start = now;
+    pace_video_start = video_time;
+    return;
+  }
+  double wait = (pace_wall_start + (video_time - pace_video_start)) - now;
+  if (wait > 1.0) {
+    //a gap in the recording: skip it instead of stalling
+    pace_wall_start = now;
+    pace_video_start = video_time;
+  } else if (wait > 0.0) {
+    usleep((unsigned long)(wait * 1.0E6));
+  }
+}
+
+RawImage CaptureVideoFile::getFrame()
+{
+#ifndef VDATA_NO_QT
+  mutex.lock();
+#endif
+  RawImage result;
+  result.setColorFormat(reader.getColorFormat());
+  result.setWidth(reader.getWidth());
+  result.setHeight(reader.getHeight());
+  result.setTime(0.0);
+  result.setData(0);
+
+  if (v_seek->getInt() != last_seek) {
+    //seek requested from the settings:
+    last_seek = v_seek->getInt();
+    current_frame = min(max(0, last_seek), reader.getFrameCount()-1);
+    restartPacing();
+  }
+  if (current_frame >= reader.getFrameCount()) {
+    if (v_loop->getBool() && reader.getFrameCount() > 0) {
+      current_frame = 0;
+    } else {
+      //end of the recording
+      is_capturing=false;
+#ifndef VDATA_NO_QT
+      mutex.unlock();
+#endif
+      return result;
+    }
+  }
+
+  waitForFrame(current_frame);
+  result.setData(reader.getFrameData(current_frame));
+  if (v_recorded_time->getBool()) {
+    result.setTime(reader.getFrameTime(current_frame));
+  } else {
+    result.setTime(GetTimeSec());
+  }
+  current_frame++;
+  //let the kernel read the next frame while this one is processed
+  reader.prefetch(current_frame < reader.getFrameCount() ? current_frame : 0);
+#ifndef VDATA_NO_QT
+  mutex.unlock();
+#endif
+  return result;
+}
+
+void CaptureVideoFile::releaseFrame()
+{
+  //frames belong to the file mapping
+}
+
+bool CaptureVideoFile::copyAndConvertFrame(const RawImage & src, RawImage & target)
+{
+#ifndef VDATA_NO_QT
+  mutex.lock();
+#endif
+  ColorFormat output_fmt = Colors::stringToColorFormat(v_colorout->getSelection().c_str());
+  ColorFormat src_fmt = src.getColorFormat();
+  if (src.getData() == 0) {
+#ifndef VDATA_NO_QT
+    mutex.unlock();
+#endif
+    return false;
+  }
+  if (output_fmt == src_fmt && v_zero_copy->getBool()) {
+    //the mapping stays valid until stopCapture()
+    target.borrowData(src);
+#ifndef VDATA_NO_QT
+    mutex.unlock();
+#endif
+    return true;
+  }
+
+  if (target.getData()==0) {
+    target.allocate(output_fmt, src.getWidth(), src.getHeight());
+  } else {
+    target.ensure_allocation(output_fmt, src.getWidth(), src.getHeight());
+  }
+  target.setTime(src.getTime());
+
+  unsigned char * in = src.getData();
+  unsigned char * out = target.getData();
+  int w = src.getWidth();
+  int h = src.getHeight();
+  bool ok = true;
+  if (output_fmt == src_fmt) {
+    memcpy(out, in, src.getNumBytes());
+  } else if (src_fmt == COLOR_RAW8 && Bayer::isSupportedOutput(output_fmt)) {
+    ok = Bayer::demosaic(in, out, w, h, (Bayer::Pattern)reader.getBayerPattern(), output_fmt);
+  } else if (src_fmt == COLOR_YUV422_UYVY && output_fmt == COLOR_RGB8) {
+    Conversions::uyvy2rgb(in, out, w, h);
+  } else if (src_fmt == COLOR_YUV422_YUYV && output_fmt == COLOR_RGB8) {
+    Conversions::yuyv2rgb(in, out, w, h);
+  } else if (src_fmt == COLOR_YUV422_YUYV && output_fmt == COLOR_YUV422_UYVY) {
+    Conversions::yuyv2uyvy(in, out, w, h);
+  } else if (src_fmt == COLOR_RGB8 && output_fmt == COLOR_YUV422_UYVY) {
+    Conversions::rgb2uyvy(in, out, w, h);
+  } else if (src_fmt == COLOR_MONO8 && output_fmt == COLOR_RGB8) {
+    Conversions::y2rgb(in, out, w, h);
+  } else {
+    fprintf(stderr,"Cannot copy and convert frame...unknown conversion selected from: %s to %s\n",
+            Colors::colorFormatToString(src_fmt).c_str(),
+            Colors::colorFormatToString(output_fmt).c_str());
+    ok = false;
+  }
+#ifndef VDATA_NO_QT
+  mutex.unlock();
+#endif
+  return ok;
+}
+
+string CaptureVideoFile::getCaptureMethodName() const
+{
+  return "VideoFile";
+}
@@ -0,0 +1,113 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    capture_videofile.h
+  \brief   C++ Interface: CaptureVideoFile
+  \author  Author Name, 2026
+*/
+//========================================================================
+
+#ifndef CAPTUREVIDEOFILE_H
+#define CAPTUREVIDEOFILE_H
+
+#include "captureinterface.h"
+#include <string>
+#include "VarTypes.h"
+#include "framelimiter.h"
+#include "raw_video_file.h"
+#ifndef VDATA_NO_QT
+  #include <QMutex>
+#else
+  #include <pthread.h>
+#endif
+
+/*!
+  \class  CaptureVideoFile
+  \brief  Replays a raw video file (see RawVideoFile) as a camera
+
+  Frames are read straight from a memory mapping of the file. Playback
+  can follow the recorded timestamps, a fixed framerate, or run as fast
+  as the stack consumes frames (for throughput benchmarks). The replayed
+  frames carry their recorded timestamps, so that a recording produces
+  the same results on every run.
+*/
+#ifndef VDATA_NO_QT
+  #include <QMutex>
+  //if using QT, inherit QObject as a base
+class CaptureVideoFile : public QObject, public CaptureInterface
+#else
+class CaptureVideoFile : public CaptureInterface
+#endif
+{
+#ifndef VDATA_NO_QT
+  Q_OBJECT
+  protected:
+  QMutex mutex;
+  public:
+#endif
+
+protected:
+  bool is_capturing;
+  RawVideoReader reader;
+  FrameLimiter limit;
+  int current_frame;
+  int last_seek;
+  //wall clock time and recorded time of the frame that started the current pacing run
+  double pace_wall_start;
+  double pace_video_start;
+
+  //processing variables:
+  VarStringEnum * v_colorout;
+  VarBool * v_zero_copy;
+
+  //capture variables:
+  VarString * v_file;
+  VarStringEnum * v_pacing;
+  VarDouble * v_framerate;
+  VarBool * v_loop;
+  VarBool * v_recorded_time;
+  VarInt * v_seek;
+  VarInt * v_frame_count;
+  VarList * capture_settings;
+  VarList * conversion_settings;
+
+  void restartPacing();
+  void waitForFrame(int frame);
+
+public:
+#ifndef VDATA_NO_QT
+  CaptureVideoFile(VarList * _settings, QObject * parent=0);
+#else
+  CaptureVideoFile(VarList * _settings);
+#endif
+  ~CaptureVideoFile();
+
+  virtual bool startCapture();
+  virtual bool stopCapture();
+  virtual bool isCapturing() { return is_capturing; };
+
+  virtual RawImage getFrame();
+  virtual void releaseFrame();
+
+  void cleanup();
+
+  /// the next getFrame() returns \p frame
+  void seek(int frame);
+
+  virtual bool copyAndConvertFrame(const RawImage & src, RawImage & target);
+  virtual string getCaptureMethodName() const;
+};
+
+#endif
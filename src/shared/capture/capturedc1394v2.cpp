@@ -65,6 +65,10 @@ CaptureDC1394v2::CaptureDC1394v2(VarList * _settings,int default_camera_id) : Ca
   cam_id=default_camera_id;
   camera=0;
   is_capturing=false;
+  last_frame_time=0.0;
+  frame_period=0.0;
+  dropped_frames=0;
+  frames_behind=0;
   #ifndef VDATA_NO_QT
     mutex.lock();
   #endif
@@ -77,7 +81,10 @@ CaptureDC1394v2::CaptureDC1394v2(VarList * _settings,int default_camera_id) : Ca
   conversion_settings->addChild(v_colorout=new VarStringEnum("convert to mode",Colors::colorFormatToString(COLOR_YUV422_UYVY)));
   v_colorout->addItem(Colors::colorFormatToString(COLOR_RGB8));
   v_colorout->addItem(Colors::colorFormatToString(COLOR_YUV422_UYVY));
+  v_colorout->addItem(Colors::colorFormatToString(COLOR_YUV444));
+  v_colorout->addItem(Colors::colorFormatToString(COLOR_RAW8));
 
+  conversion_settings->addChild(v_zero_copy=new VarBool("zero-copy (if no conversion)",false));
   conversion_settings->addChild(v_debayer=new VarBool("de-bayer",false));
   conversion_settings->addChild(v_debayer_pattern=new VarStringEnum("de-bayer pattern",colorFilterToString(DC1394_COLOR_FILTER_MIN)));
   for (int i = DC1394_COLOR_FILTER_MIN; i <= DC1394_COLOR_FILTER_MAX; i++) {
@@ -88,6 +95,8 @@ CaptureDC1394v2::CaptureDC1394v2(VarList * _settings,int default_camera_id) : Ca
     v_debayer_method->addItem(bayerMethodToString((dc1394bayer_method_t)i));
   }
   conversion_settings->addChild(v_debayer_y16=new VarInt("de-bayer y16 bits",16));
+  conversion_settings->addChild(v_debayer_native=new VarBool("native de-bayer (8 bit)",false));
+  conversion_settings->addChild(v_debayer_threads=new VarInt("de-bayer threads",1,1,16));
   dcam_parameters->addFlags( VARTYPE_FLAG_HIDE_CHILDREN );
 
   //=======================CAPTURE SETTINGS==========================
@@ -805,6 +814,7 @@ bool CaptureDC1394v2::resetBus() {
     dc1394_camera_free(camera);
     camera=0;
   }
+  held_frames.clear();
 
   if (cam_list != 0) {
     dc1394_camera_free_list(cam_list);
@@ -918,6 +928,7 @@ void CaptureDC1394v2::cleanup()
     dc1394_camera_free(camera);
   }
   camera=0;
+  held_frames.clear();
   //TODO: cleanup/free any memory buffers.
 
   is_capturing=false;
@@ -1012,6 +1023,8 @@ bool CaptureDC1394v2::startCapture()
   int fps=v_fps->getInt();
   CaptureMode mode=stringToCaptureMode(v_format->getString().c_str());
   ring_buffer_size=v_buffer_size->getInt();
+  //zero-copy frames stay dequeued while the caller holds them:
+  if (v_zero_copy->getBool()) ring_buffer_size+=max_held_frames;
   bool use_1394B=v_use1394B->getBool();
   dc1394speed_t iso_speed=(v_use_iso_800->getBool() ? DC1394_ISO_SPEED_800 : DC1394_ISO_SPEED_400);
 
@@ -1511,6 +1524,10 @@ dc1394error_t dc1394_format7_get_packets_per_frame(dc1394camera_t *camera, dc139
   }
 
   is_capturing=true;
+  last_frame_time=0.0;
+  frame_period=(fps > 0 ? 1.0/fps : 0.0);
+  dropped_frames=0;
+  frames_behind=0;
 
   vector<VarType *> tmp = capture_settings->getChildren();
   for (unsigned int i=0; i < tmp.size();i++) {
@@ -1535,17 +1552,35 @@ bool CaptureDC1394v2::copyFrame(const RawImage & src, RawImage & target)
 
 bool CaptureDC1394v2::copyAndConvertFrame(const RawImage & src, RawImage & target)
 {
-  return convertFrame(src,target,
-                      Colors::stringToColorFormat(v_colorout->getSelection().c_str()),
+  ColorFormat output_fmt=Colors::stringToColorFormat(v_colorout->getSelection().c_str());
+  if (v_zero_copy->getBool() && src.getColorFormat()==output_fmt && src.getData()!=0) {
+    //let the stack work directly on the DMA buffer until releaseFrame()
+    target.borrowData(src);
+    return true;
+  }
+  return convertFrame(src,target,output_fmt,
                       v_debayer->getBool(),
                       stringToColorFilter(v_debayer_pattern->getSelection().c_str()),
                       stringToBayerMethod(v_debayer_method->getSelection().c_str()),
-                      v_debayer_y16->getInt());
+                      v_debayer_y16->getInt(),
+                      v_debayer_native->getBool(),
+                      v_debayer_threads->getInt());
 }
 
 
+unsigned int CaptureDC1394v2::getDroppedFrames() const
+{
+  return dropped_frames;
+}
+
+int CaptureDC1394v2::getFramesBehind() const
+{
+  return frames_behind;
+}
+
 bool CaptureDC1394v2::convertFrame(const RawImage & src, RawImage & target, ColorFormat output_fmt,
-                         bool debayer, dc1394color_filter_t bayer_format,dc1394bayer_method_t bayer_method, int y16bits)
+                         bool debayer, dc1394color_filter_t bayer_format,dc1394bayer_method_t bayer_method, int y16bits,
+                         bool native_debayer, int debayer_threads)
 {
   #ifndef VDATA_NO_QT
     mutex.lock();
@@ -1566,7 +1601,12 @@ bool CaptureDC1394v2::convertFrame(const RawImage & src, RawImage & target, Colo
     memcpy(target.getData(),src.getData(),src.getNumBytes());
   } else {
     //do some more fancy conversion
-    if ((src_fmt==COLOR_MONO8 || src_fmt==COLOR_RAW8) && output_fmt==COLOR_RGB8) {
+    if ((src_fmt==COLOR_MONO8 || src_fmt==COLOR_RAW8) && debayer && native_debayer && Bayer::isSupportedOutput(output_fmt)) {
+      //de-bayer straight into the output format, without a full RGB intermediate
+      Bayer::demosaic(src.getData(), target.getData(), src.getWidth(), src.getHeight(),
+                      (Bayer::Pattern)(bayer_format - DC1394_COLOR_FILTER_MIN), output_fmt, debayer_threads,
+                      &debayer_workers);
+    } else if ((src_fmt==COLOR_MONO8 || src_fmt==COLOR_RAW8) && output_fmt==COLOR_RGB8) {
       //check whether to debayer or simply average to a grey rgb image
       if (debayer) {
         //de-bayer
@@ -1664,9 +1704,33 @@ RawImage CaptureDC1394v2::getFrame()
     if (dc1394_capture_is_frame_corrupt (camera, frame) == DC1394_TRUE) {
       printf("============================CORRUPT!\n"); fflush(stdout); exit(1);
     }*/
-    gettimeofday(&tv,NULL);
-    result.setTime((double)tv.tv_sec + tv.tv_usec*(1.0E-6));
+    //the driver stamps frames with the unix time [us] at which the DMA
+    //completed, which is the same clock as GetTimeSec():
+    double t;
+    if (frame->timestamp!=0) {
+      t=(double)frame->timestamp*(1.0E-6);
+    } else {
+      gettimeofday(&tv,NULL);
+      t=(double)tv.tv_sec + tv.tv_usec*(1.0E-6);
+    }
+    result.setTime(t);
     result.setData(frame->image);
+    frames_behind=frame->frames_behind;
+    held_frames.push_back(frame);
+
+    //the bus does not provide frame counters, so detect gaps from the
+    //timestamps, using a running estimate of the frame period:
+    if (last_frame_time > 0.0 && t > last_frame_time) {
+      double dt=t-last_frame_time;
+      if (frame_period <= 0.0) {
+        frame_period=dt;
+      } else if (dt > 1.5*frame_period) {
+        dropped_frames+=(unsigned int)(dt/frame_period + 0.5) - 1;
+      } else {
+        frame_period=0.95*frame_period + 0.05*dt;
+      }
+    }
+    last_frame_time=t;
 
     /*printf("B: %d w: %d h: %d bytes: %d pad: %d pos: %d %d depth: %d bpp %d coding: %d  behind %d id %d\n",frame->data_in_padding ? 1 : 0, frame->size[0],frame->size[1],frame->image_bytes,frame->padding_bytes, frame->position[0],frame->position[1],frame->data_depth,frame->packets_per_frame,frame->color_coding,frame->frames_behind,frame->id);*/
   }
@@ -1680,8 +1744,31 @@ void CaptureDC1394v2::releaseFrame() {
   #ifndef VDATA_NO_QT
     mutex.lock();
   #endif
-  if (dc1394_capture_enqueue (camera, frame) !=DC1394_SUCCESS) {
-    fprintf (stderr, "CaptureDC1394v2 Error: Failed to release frame from camera %d\n", cam_id);
+  if (camera!=0 && !held_frames.empty()) {
+    if (dc1394_capture_enqueue (camera, held_frames.front()) !=DC1394_SUCCESS) {
+      fprintf (stderr, "CaptureDC1394v2 Error: Failed to release frame from camera %d\n", cam_id);
+    }
+    held_frames.pop_front();
+  }
+  #ifndef VDATA_NO_QT
+    mutex.unlock();
+  #endif
+}
+
+void CaptureDC1394v2::releaseHeldFrame(const unsigned char * data) {
+  #ifndef VDATA_NO_QT
+    mutex.lock();
+  #endif
+  if (camera!=0) {
+    for (std::deque<dc1394video_frame_t *>::iterator it=held_frames.begin(); it!=held_frames.end(); it++) {
+      if ((*it)->image==data) {
+        if (dc1394_capture_enqueue (camera, *it) !=DC1394_SUCCESS) {
+          fprintf (stderr, "CaptureDC1394v2 Error: Failed to release frame from camera %d\n", cam_id);
+        }
+        held_frames.erase(it);
+        break;
+      }
+    }
   }
   #ifndef VDATA_NO_QT
     mutex.unlock();
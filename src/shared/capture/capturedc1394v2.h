@@ -26,11 +26,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <deque>
 #include "VarTypes.h"
 #include <dc1394/control.h>
 #include <dc1394/conversions.h>
 
 //#include "conversions.h"
+#include "bayer.h"
 #ifndef VDATA_NO_QT
   #include <QMutex>
 #else
@@ -327,7 +329,11 @@ protected:
   VarStringEnum * v_debayer_pattern;
   VarStringEnum * v_debayer_method;
   VarInt        * v_debayer_y16;
+  VarBool       * v_debayer_native;
+  VarInt        * v_debayer_threads;
+  WorkerThreads   debayer_workers;
   VarStringEnum * v_colorout;
+  VarBool       * v_zero_copy;
 
   //DCAM parameters:
   VarList * P_BRIGHTNESS;
@@ -369,11 +375,19 @@ protected:
   int ring_buffer_size;
   dc1394camera_list_t * cam_list;
 
+  //frame loss detection based on the frame timestamps:
+  double last_frame_time;
+  double frame_period;
+  unsigned int dropped_frames;
+  int frames_behind;
+
   dc1394_t * dc1394_instance;
   dc1394framerate_t dcfps;
   dc1394video_mode_t dcformat;
   dc1394featureset_t features;
   dc1394video_frame_t * frame;
+  //dequeued frames which were not released yet, oldest first:
+  std::deque<dc1394video_frame_t *> held_frames;
   //dc1394camera_t **cameras;
   dc1394camera_t * camera;
 
@@ -417,6 +431,8 @@ public:
 
   virtual void releaseFrame();
 
+  virtual void releaseHeldFrame(const unsigned char * data);
+
   virtual bool resetBus();
 
   void cleanup();
@@ -439,6 +455,10 @@ public:
 
   virtual bool copyAndConvertFrame(const RawImage & src, RawImage & target);
 
+  virtual unsigned int getDroppedFrames() const;
+
+  virtual int getFramesBehind() const;
+
   virtual string getCaptureMethodName() const;
 
 protected:
@@ -451,7 +471,9 @@ protected:
                            bool debayer=true,
                            dc1394color_filter_t bayer_format=DC1394_COLOR_FILTER_RGGB,
                            dc1394bayer_method_t bayer_method=DC1394_BAYER_METHOD_HQLINEAR,
-                           int y16bits=16);
+                           int y16bits=16,
+                           bool native_debayer=false,
+                           int debayer_threads=1);
 
 };
 
@@ -21,11 +21,19 @@
 //========================================================================
 
 #include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
 #include <cctype>
 #include "capturefromfile.h"
 #include "image_io.h"
 #include "conversions.h"
 
+static const char raw_frame_magic[4] = { 'U', 'Y', 'V', 'Y' };
+static const size_t raw_frame_header_size = 16;
 
 #ifndef VDATA_NO_QT
 CaptureFromFile::CaptureFromFile(VarList * _settings, QObject * parent) : QObject(parent), CaptureInterface(_settings)
@@ -35,6 +43,13 @@ CaptureFromFile::CaptureFromFile(VarList * _settings) : CaptureInterface(_settin
 {
   currentImageIndex = 0;
   is_capturing=false;
+  load_fmt=COLOR_UNDEFINED;
+  prefetch_running=false;
+  prefetch_stop=false;
+  prefetch_limit=1;
+  next_file=0;
+  pthread_mutex_init(&prefetch_mutex,0);
+  pthread_cond_init(&prefetch_cond,0);
 
   settings->addChild(conversion_settings = new VarList("Conversion Settings"));
   settings->addChild(capture_settings = new VarList("Capture Settings"));
@@ -46,6 +61,10 @@ CaptureFromFile::CaptureFromFile(VarList * _settings) : CaptureInterface(_settin
     
   //=======================CAPTURE SETTINGS==========================
   capture_settings->addChild(v_cap_dir = new VarString("directory", ""));
+  capture_settings->addChild(v_streaming = new VarBool("streaming (decode in background)", true));
+  capture_settings->addChild(v_prefetch = new VarInt("prefetch frames", 8, 1, 256));
+  capture_settings->addChild(v_framerate = new VarDouble("framerate (0 = as fast as possible)", 0.0, 0.0));
+  limit_fps=0.0;
     
   // Valid file endings
   validImageFileEndings.push_back("PNG");
@@ -56,10 +75,10 @@ CaptureFromFile::CaptureFromFile(VarList * _settings) : CaptureInterface(_settin
 
 CaptureFromFile::~CaptureFromFile()
 {
-  for(unsigned int i=0; i<images.size(); ++i)
-  {
-    delete images[i];
-  }
+  stopPrefetching();
+  freeFrames();
+  pthread_cond_destroy(&prefetch_cond);
+  pthread_mutex_destroy(&prefetch_mutex);
 }
 
 bool CaptureFromFile::stopCapture() 
@@ -70,6 +89,8 @@ bool CaptureFromFile::stopCapture()
 
 void CaptureFromFile::cleanup()
 {
+  //join the decoder outside of mutex, it never takes it
+  stopPrefetching();
 #ifndef VDATA_NO_QT
   mutex.lock();
 #endif
@@ -79,62 +100,96 @@ void CaptureFromFile::cleanup()
 #endif
 }
 
+void CaptureFromFile::freeFrames()
+{
+  for(unsigned int i=0; i<frames.size(); ++i)
+    freeFrame(frames[i]);
+  frames.clear();
+}
+
+bool CaptureFromFile::scanDirectory()
+{
+  // Acquire a list of file names
+  DIR *dp;
+  struct dirent *dirp;
+  files.clear();
+  if((v_cap_dir->getString() == "") || ((dp  = opendir(v_cap_dir->getString().c_str())) == 0)) 
+  {
+    fprintf(stderr,"Failed to open directory %s \n", v_cap_dir->getString().c_str());
+    return false;
+  }  
+  while ((dirp = readdir(dp))) 
+  {
+    if (strcmp(dirp->d_name,".") != 0 && strcmp(dirp->d_name,"..") != 0) 
+    {
+      std::string name(dirp->d_name);
+      if(isImageFileName(name) || isRawFileName(name))
+        files.push_back(v_cap_dir->getString() + name);
+      else
+        fprintf(stderr,"Not a valid image file: %s \n", dirp->d_name);
+    }
+  }
+  closedir(dp);
+  std::sort(files.begin(), files.end());
+  return files.size() > 0;
+}
+
 bool CaptureFromFile::startCapture()
 {
+  stopPrefetching();
 #ifndef VDATA_NO_QT
   mutex.lock();
 #endif
-  if(images.size() == 0)
+  ColorFormat output_fmt = Colors::stringToColorFormat(v_colorout->getSelection().c_str());
+  bool streaming = v_streaming->getBool();
+  //preloaded frames are kept across restarts, unless they no longer fit the settings
+  if (streaming || output_fmt != load_fmt)
+    freeFrames();
+  load_fmt = output_fmt;
+
+  if((streaming || frames.size() == 0) && scanDirectory() == false)
   {
-    // Acquire a list of file names
-    DIR *dp;
-    struct dirent *dirp;
-    if((v_cap_dir->getString() == "") || ((dp  = opendir(v_cap_dir->getString().c_str())) == 0)) 
-    {
-      fprintf(stderr,"Failed to open directory %s \n", v_cap_dir->getString().c_str());
 #ifndef VDATA_NO_QT
-      mutex.unlock();
+    mutex.unlock();
 #endif      
-      is_capturing=false;
-      return false;
-    }  
-    while ((dirp = readdir(dp))) 
-    {
-      if (strcmp(dirp->d_name,".") != 0 && strcmp(dirp->d_name,"..") != 0) 
-      {
-        if(isImageFileName(std::string(dirp->d_name)))
-          imgs_to_load.push_back(v_cap_dir->getString() + std::string(dirp->d_name));
-        else
-          fprintf(stderr,"Not a valid image file: %s \n", dirp->d_name);
-      }
-    }
-    closedir(dp);
-    if(imgs_to_load.size() == 0)
+    is_capturing=false;
+    return false;
+  }
+
+  if (streaming)
+  {
+    pthread_mutex_lock(&prefetch_mutex);
+    prefetch_limit = max(1, v_prefetch->getInt());
+    next_file = 0;
+    prefetch_stop = false;
+    pthread_mutex_unlock(&prefetch_mutex);
+    prefetch_running = (pthread_create(&prefetch_thread, 0, prefetchThreadEntry, this) == 0);
+    if (!prefetch_running)
     {
+      fprintf(stderr,"CaptureFromFile: failed to start the prefetch thread\n");
 #ifndef VDATA_NO_QT
       mutex.unlock();
-#endif      
+#endif
       is_capturing=false;
       return false;
     }
-  
+  }
+  else if (frames.size() == 0)
+  {
     // Read images to buffer in memory:
-    imgs_to_load.sort();
-    imgs_it = imgs_to_load.begin();
-    std::list<std::string>::iterator currentImage = imgs_it;
-    while(currentImage != imgs_to_load.end())
+    for (unsigned int i=0; i<files.size(); i++)
     {
-      int width(-1);
-      int height(-1);
-      rgba* rgba_img = ImageIO::readRGBA(width, height, currentImage->c_str());
-      fprintf (stderr, "Loaded %s \n", currentImage->c_str());
-      images.push_back(rgba_img);
-      heights.push_back(height);
-      widths.push_back(width);
-      ++currentImage;
+      FileFrame f;
+      if (loadFrame(files[i], f))
+      {
+        fprintf (stderr, "Loaded %s \n", files[i].c_str());
+        frames.push_back(f);
+      }
     }
     currentImageIndex = 0;
   }
+  //restart the pacing with the first frame
+  limit_fps=0.0;
   is_capturing=true;  
   
 #ifndef VDATA_NO_QT
@@ -159,6 +214,176 @@ bool CaptureFromFile::isImageFileName(const std::string& fileName)
   return false;
 }
 
+bool CaptureFromFile::isRawFileName(const std::string& fileName)
+{
+  string::size_type pointPos = fileName.find_last_of(".");
+  if(pointPos == string::npos)
+    return false;
+  string ending = fileName.substr(pointPos+1);
+  for(unsigned int i=0; i<ending.size(); ++i)
+    ending[i] = toupper(ending[i]);
+  return ending == "UYVY";
+}
+
+bool CaptureFromFile::mapRawFrame(const std::string & fileName, FileFrame & frame)
+{
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    fprintf(stderr,"CaptureFromFile: cannot open %s: %s\n", fileName.c_str(), strerror(errno));
+    return false;
+  }
+  struct stat st;
+  uint32_t header[4];
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < raw_frame_header_size ||
+      read(fd, header, sizeof(header)) != (ssize_t)sizeof(header) ||
+      memcmp(header, raw_frame_magic, sizeof(raw_frame_magic)) != 0)
+  {
+    fprintf(stderr,"CaptureFromFile: %s is not a raw UYVY frame\n", fileName.c_str());
+    close(fd);
+    return false;
+  }
+  int width = header[1];
+  int height = header[2];
+  size_t size = raw_frame_header_size + RawImage::computeImageSize(COLOR_YUV422_UYVY, width*height);
+  if (width <= 0 || height <= 0 || (size_t)st.st_size < size)
+  {
+    fprintf(stderr,"CaptureFromFile: %s is truncated\n", fileName.c_str());
+    close(fd);
+    return false;
+  }
+  void * base = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED)
+  {
+    fprintf(stderr,"CaptureFromFile: cannot map %s: %s\n", fileName.c_str(), strerror(errno));
+    return false;
+  }
+  //start reading it in now, instead of page faulting on first access
+  madvise(base, size, MADV_WILLNEED);
+  frame.map_base = base;
+  frame.map_length = size;
+  frame.data = (unsigned char*)base + raw_frame_header_size;
+  frame.width = width;
+  frame.height = height;
+  frame.format = COLOR_YUV422_UYVY;
+  return true;
+}
+
+bool CaptureFromFile::loadFrame(const std::string & fileName, FileFrame & frame)
+{
+  if (isRawFileName(fileName))
+    return mapRawFrame(fileName, frame);
+
+  int width(-1);
+  int height(-1);
+  rgba* rgba_img = ImageIO::readRGBA(width, height, fileName.c_str());
+  if (rgba_img == 0)
+  {
+    fprintf(stderr,"CaptureFromFile: failed to load %s\n", fileName.c_str());
+    return false;
+  }
+  int n = width * height;
+  unsigned char * rgb_data = new unsigned char[n*3];
+  unsigned char* p = rgb_data;
+  for (int i=0; i < n; i++)
+  {
+    *p = rgba_img[i].r;
+    p++;
+    *p = rgba_img[i].g;
+    p++;
+    *p = rgba_img[i].b;
+    p++;
+  }
+  delete[] rgba_img;
+
+  //convert once here, so that replaying is a plain copy
+  if (load_fmt == COLOR_YUV422_UYVY)
+  {
+    frame.data = new unsigned char[RawImage::computeImageSize(COLOR_YUV422_UYVY, n)];
+    Conversions::rgb2uyvy(rgb_data, frame.data, width, height);
+    delete[] rgb_data;
+    frame.format = COLOR_YUV422_UYVY;
+  }
+  else
+  {
+    frame.data = rgb_data;
+    frame.format = COLOR_RGB8;
+  }
+  frame.width = width;
+  frame.height = height;
+  return true;
+}
+
+void CaptureFromFile::freeFrame(FileFrame & frame)
+{
+  if (frame.map_base != 0)
+    munmap(frame.map_base, frame.map_length);
+  else
+    delete[] frame.data;
+  frame = FileFrame();
+}
+
+void * CaptureFromFile::prefetchThreadEntry(void * arg)
+{
+  ((CaptureFromFile *)arg)->prefetchLoop();
+  return 0;
+}
+
+void CaptureFromFile::prefetchLoop()
+{
+  unsigned int failures = 0;
+  pthread_mutex_lock(&prefetch_mutex);
+  while (!prefetch_stop)
+  {
+    if (prefetched.size() >= prefetch_limit)
+    {
+      pthread_cond_wait(&prefetch_cond, &prefetch_mutex);
+      continue;
+    }
+    std::string fileName = files[next_file];
+    next_file = (next_file + 1) % files.size();
+    //decode without holding the lock, so getFrame can take what is ready
+    pthread_mutex_unlock(&prefetch_mutex);
+    FileFrame f;
+    bool ok = loadFrame(fileName, f);
+    pthread_mutex_lock(&prefetch_mutex);
+    if (ok)
+    {
+      failures = 0;
+      prefetched.push_back(f);
+      pthread_cond_broadcast(&prefetch_cond);
+    }
+    else if (++failures >= files.size())
+    {
+      //nothing in the directory can be loaded
+      break;
+    }
+  }
+  prefetch_stop = true;
+  pthread_cond_broadcast(&prefetch_cond);
+  pthread_mutex_unlock(&prefetch_mutex);
+}
+
+void CaptureFromFile::stopPrefetching()
+{
+  if (prefetch_running)
+  {
+    pthread_mutex_lock(&prefetch_mutex);
+    prefetch_stop = true;
+    pthread_cond_broadcast(&prefetch_cond);
+    pthread_mutex_unlock(&prefetch_mutex);
+    pthread_join(prefetch_thread, 0);
+    prefetch_running = false;
+  }
+  while (prefetched.size() > 0)
+  {
+    freeFrame(prefetched.front());
+    prefetched.pop_front();
+  }
+  freeFrame(current);
+}
+
 bool CaptureFromFile::copyAndConvertFrame(const RawImage & src, RawImage & target)
 {
 #ifndef VDATA_NO_QT
@@ -182,14 +407,12 @@ bool CaptureFromFile::copyAndConvertFrame(const RawImage & src, RawImage & targe
   else if (src_fmt == COLOR_RGB8 && output_fmt == COLOR_YUV422_UYVY)
   {
     if (src.getData() != 0)
-      dc1394_convert_to_YUV422(src.getData(), target.getData(), src.getWidth(), src.getHeight(), 
-                               DC1394_BYTE_ORDER_UYVY, DC1394_COLOR_CODING_RGB8, 8);
+      Conversions::rgb2uyvy(src.getData(), target.getData(), src.getWidth(), src.getHeight());
   }
   else if (src_fmt == COLOR_YUV422_UYVY && output_fmt == COLOR_RGB8)
   {
     if (src.getData() != 0)
-      dc1394_convert_to_RGB8(src.getData(),target.getData(), src.getWidth(), src.getHeight(), 
-                             DC1394_BYTE_ORDER_UYVY, DC1394_COLOR_CODING_YUV422, 8);
+      Conversions::uyvy2rgb(src.getData(), target.getData(), src.getWidth(), src.getHeight());
   } 
   else 
   {
@@ -213,44 +436,56 @@ RawImage CaptureFromFile::getFrame()
    mutex.lock();
 #endif
 
+  double fps = v_framerate->getDouble();
+  if (fps > 0.0)
+  {
+    if (fps != limit_fps)
+    {
+      limit.init(fps);
+      limit_fps = fps;
+    }
+    limit.waitForNextFrame();
+  }
+
   RawImage result;
   result.setColorFormat(COLOR_RGB8); 
   result.setTime(0.0);
-  rgba* rgba_img = 0;
-  int width;
-  int height;
-  if(images.size())
+  const FileFrame * f = 0;
+  if (prefetch_running)
+  {
+    pthread_mutex_lock(&prefetch_mutex);
+    freeFrame(current);
+    while (prefetched.size() == 0 && !prefetch_stop)
+      pthread_cond_wait(&prefetch_cond, &prefetch_mutex);
+    if (prefetched.size() > 0)
+    {
+      current = prefetched.front();
+      prefetched.pop_front();
+      //make room for the decoder
+      pthread_cond_broadcast(&prefetch_cond);
+      f = &current;
+    }
+    pthread_mutex_unlock(&prefetch_mutex);
+  }
+  else if(frames.size())
   {
-    rgba_img = images[currentImageIndex];
-    width = widths[currentImageIndex];
-    height = heights[currentImageIndex];
-    currentImageIndex = (currentImageIndex + 1) % images.size();
+    f = &frames[currentImageIndex];
+    currentImageIndex = (currentImageIndex + 1) % frames.size();
   }
-  if (rgba_img == 0)
+  if (f == 0)
   {
     fprintf (stderr, "CaptureFromFile Error, no images available");
     is_capturing=false;
     result.setData(0);
     result.setWidth(640);
     result.setHeight(480);
-    frame = 0;
   }
   else
   {
-    frame = new unsigned char[width*height*3];
-    unsigned char* p = &frame[0];
-    for (int i=0; i < width * height; i++)
-    {
-      *p = rgba_img[i].r;
-      p++;
-      *p = rgba_img[i].g;
-      p++;
-      *p = rgba_img[i].b;
-      p++;
-    }
-    result.setWidth(width);
-    result.setHeight(height);
-    result.setData(frame);
+    result.setColorFormat(f->format);
+    result.setWidth(f->width);
+    result.setHeight(f->height);
+    result.setData(f->data);
     timeval tv;    
     gettimeofday(&tv,0);
     result.setTime((double)tv.tv_sec + tv.tv_usec*(1.0E-6));
@@ -263,16 +498,35 @@ RawImage CaptureFromFile::getFrame()
 
 void CaptureFromFile::releaseFrame() 
 {
-#ifndef VDATA_NO_QT
-  mutex.lock();
-#endif
-  delete[] frame;
-#ifndef VDATA_NO_QT
-  mutex.unlock();
-#endif
+  //frames stay owned by this class: preloaded frames live until the next
+  //restart, a streamed frame is freed when the next one is taken
 }
 
 string CaptureFromFile::getCaptureMethodName() const 
 {
   return "FromFile";
 }
+
+bool CaptureFromFile::writeRawFrame(const RawImage & img, const std::string & fileName)
+{
+  if (img.getColorFormat() != COLOR_YUV422_UYVY || img.getData() == 0)
+  {
+    fprintf(stderr,"CaptureFromFile: raw frames have to be UYVY\n");
+    return false;
+  }
+  FILE * file = fopen(fileName.c_str(), "wb");
+  if (file == 0)
+  {
+    fprintf(stderr,"CaptureFromFile: cannot write %s: %s\n", fileName.c_str(), strerror(errno));
+    return false;
+  }
+  uint32_t header[4];
+  memcpy(&header[0], raw_frame_magic, sizeof(raw_frame_magic));
+  header[1] = img.getWidth();
+  header[2] = img.getHeight();
+  header[3] = 0;
+  bool ok = fwrite(header, sizeof(header), 1, file) == 1 &&
+            fwrite(img.getData(), img.getNumBytes(), 1, file) == 1;
+  ok = (fclose(file) == 0) && ok;
+  return ok;
+}
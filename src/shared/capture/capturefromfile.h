@@ -27,8 +27,12 @@
 #include <dirent.h>
 #include <string>
 #include <list>
+#include <deque>
+#include <vector>
 #include <algorithm>
+#include <pthread.h>
 #include "VarTypes.h"
+#include "framelimiter.h"
 
 #ifndef VDATA_NO_QT
   #include <QMutex>
@@ -36,7 +40,20 @@
   #include <pthread.h>
 #endif
 
+/*!
+  \class  CaptureFromFile
+  \brief  Replays a directory of image files as a camera
+
+  Images (png, bmp, jpg) are decoded and converted to the output color
+  format either all at start (preload) or by a background thread that
+  keeps a bounded window of upcoming frames ready (streaming).
 
+  Files ending in .uyvy contain one pre-converted frame: a 16 byte header
+  ("UYVY", then width, height and a reserved word as 32 bit host-order
+  integers) followed by the UYVY pixel data. These are mmap'ed instead of
+  decoded, so they cost neither startup time nor heap memory. They can
+  be written with writeRawFrame().
+*/
 #ifndef VDATA_NO_QT
   #include <QMutex>
   //if using QT, inherit QObject as a base
@@ -55,6 +72,17 @@ class CaptureFromFile : public CaptureInterface
 #endif
 
 protected:
+  /// a decoded or mmap'ed frame
+  struct FileFrame {
+    unsigned char * data;
+    int width;
+    int height;
+    ColorFormat format;
+    void * map_base;    //non-zero if data lies in a file mapping
+    size_t map_length;
+    FileFrame() : data(0), width(0), height(0), format(COLOR_UNDEFINED), map_base(0), map_length(0) {}
+  };
+
   bool is_capturing;
 
   //processing variables:
@@ -62,20 +90,47 @@ protected:
 
   //capture variables:
   VarString * v_cap_dir;
+  VarBool * v_streaming;
+  VarInt * v_prefetch;
+  VarDouble * v_framerate;
   VarList * capture_settings;
   VarList * conversion_settings;
 
-  unsigned char* frame;
-  std::list<std::string> imgs_to_load;
-  std::list<std::string>::iterator imgs_it;
-  std::vector<rgba*> images;
-  std::vector<int> heights;
-  std::vector<int> widths;
+  std::vector<std::string> files;
+  ColorFormat load_fmt;
+
+  //preload mode:
+  std::vector<FileFrame> frames;
   unsigned int currentImageIndex;
-  
+
+  //streaming mode:
+  pthread_t prefetch_thread;
+  bool prefetch_running;
+  bool prefetch_stop;
+  pthread_mutex_t prefetch_mutex;
+  pthread_cond_t prefetch_cond;
+  std::deque<FileFrame> prefetched;
+  unsigned int prefetch_limit;
+  unsigned int next_file;
+  FileFrame current;
+
+  //pacing:
+  FrameLimiter limit;
+  double limit_fps;
+
   bool isImageFileName(const std::string& fileName);
+  bool isRawFileName(const std::string& fileName);
   std::vector<std::string> validImageFileEndings;
-  
+
+  bool scanDirectory();
+  bool loadFrame(const std::string & fileName, FileFrame & frame);
+  static bool mapRawFrame(const std::string & fileName, FileFrame & frame);
+  static void freeFrame(FileFrame & frame);
+  static void * prefetchThreadEntry(void * arg);
+  void prefetchLoop();
+  void stopPrefetching();
+  void freeFrames();
+
 public:
 #ifndef VDATA_NO_QT
   CaptureFromFile(VarList * _settings, QObject * parent=0);
@@ -96,6 +151,9 @@ public:
 
   virtual bool copyAndConvertFrame(const RawImage & src, RawImage & target);
   virtual string getCaptureMethodName() const;
+
+  /// writes a UYVY frame in the raw format that is replayed without decoding
+  static bool writeRawFrame(const RawImage & img, const std::string & fileName);
 };
 
 #endif
@@ -28,6 +28,7 @@ CaptureInterface::CaptureInterface(VarList * _settings)
   } else {
     settings=new VarList("capture settings");
   }
+  max_held_frames=1;
 }
 
 
@@ -37,6 +38,14 @@ CaptureInterface::~CaptureInterface()
 }
 
 
+void CaptureInterface::setMaxHeldFrames(int n) {
+  max_held_frames=(n > 1) ? n : 1;
+}
+
+void CaptureInterface::releaseHeldFrame(const unsigned char *) {
+  releaseFrame();
+}
+
 bool CaptureInterface::resetBus() {
   return true;
 }
@@ -45,6 +54,14 @@ void CaptureInterface::readAllParameterValues() {
 
 }
 
+unsigned int CaptureInterface::getDroppedFrames() const {
+  return 0;
+}
+
+int CaptureInterface::getFramesBehind() const {
+  return 0;
+}
+
 bool CaptureInterface::copyAndConvertFrame(const RawImage & src, RawImage & target) {
   target.ensure_allocation(target.getColorFormat(),src.getWidth(),src.getHeight());
   target.setTime(src.getTime());
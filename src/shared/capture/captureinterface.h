@@ -42,6 +42,8 @@ using namespace VarTypes;
 */
 class CaptureInterface
 {
+protected:
+    int max_held_frames;
 public:
     CaptureInterface(VarList * _settings=0);
 
@@ -64,8 +66,22 @@ public:
     virtual bool     isCapturing() = 0;
 
     /// This releases the pointer of a previous \c getFrame() call.
+    /// Frames are released in the order in which getFrame() returned
+    /// them, see setMaxHeldFrames().
     virtual void     releaseFrame() = 0;
 
+    /// Releases the one held frame whose getFrame() result pointed to
+    /// \p data, regardless of its position in the release order.
+    /// Implementations that lend their buffers via copyAndConvertFrame()
+    /// have to override this, the default simply calls releaseFrame().
+    virtual void     releaseHeldFrame(const unsigned char * data);
+
+    /// The caller may keep up to \p n frames returned by getFrame()
+    /// unreleased at the same time (default 1). Implementations that
+    /// lend their buffers via copyAndConvertFrame() size their queues for
+    /// it. Takes effect with the next startCapture().
+    void             setMaxHeldFrames(int n);
+
     /// This will make your method start capturing data
     /// Note, that upon construction, your class should NOT be starting
     /// to capture data automatically.
@@ -88,6 +104,15 @@ public:
     /// this function should force a readout of such parameters.
     virtual void     readAllParameterValues();
 
+    /// If your capture device provides hardware timestamps or frame
+    /// counters, this should return the number of frames that were lost
+    /// since startCapture() was called, i.e. gaps in the frame sequence.
+    virtual unsigned int getDroppedFrames() const;
+
+    /// Number of frames which were already waiting in the driver queue
+    /// behind the one returned by the most recent getFrame() call.
+    virtual int      getFramesBehind() const;
+
     /// This function will allow the copying of a captured frame
     /// to another RawImage data-structure.
     /// Overloading this function is recommended to provide more advanced
@@ -100,6 +125,13 @@ public:
     /// In its current implementation in this base-interface,
     /// all this function will do is allocate the target image (if not
     /// already allocated, and then memcpy the data as-is.
+    ///
+    /// If no conversion is needed, an implementation may instead let
+    /// \p target borrow the data of \p src (see RawImage::borrowData).
+    /// The borrowed data stays valid until the frame is released, or
+    /// until stopCapture() or resetBus() is called. The caller has to
+    /// hold the frame as long as \p target refers to it, and to detach
+    /// any frames still referring to it before stopping or resetting.
     virtual bool     copyAndConvertFrame(const RawImage & src, RawImage & target);
 
     /// Return a string describing your capture method
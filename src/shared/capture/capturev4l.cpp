@@ -51,6 +51,7 @@
 
 #include "capturev4l.h"
 #include "conversions.h"
+#include "timer.h"
 
 #include <sys/ioctl.h>
 #include <sys/mman.h>
@@ -60,6 +61,9 @@
 #include <sys/stat.h>
 #include <fcntl.h>      //open
 #include <unistd.h>     //close
+#include <time.h>       //clock_gettime
+#include <sys/epoll.h>
+#include <algorithm>
 
 //======================= Singleton Manager =======================
 
@@ -115,6 +119,103 @@ int GlobalV4LinstanceManager::enumerateInstances(int *id_list, int max_id)
 }
 
 
+//======================= Shared frame waiter =======================
+
+V4LFrameWaiter* V4LFrameWaiter::pinstance = NULL;
+pthread_mutex_t V4LFrameWaiter::instance_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+V4LFrameWaiter* V4LFrameWaiter::obtainInstance() {
+    pthread_mutex_lock(&instance_mutex);
+    if (!pinstance) pinstance=new V4LFrameWaiter();
+    pthread_mutex_unlock(&instance_mutex);
+    return pinstance;
+}
+
+V4LFrameWaiter::V4LFrameWaiter() {
+    pthread_mutex_init(&mutex, NULL);
+    running=false;
+    epoll_fd=epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        fprintf(stderr,"V4LFrameWaiter: epoll_create1 failed (%s)\n", strerror(errno));
+    }
+}
+
+bool V4LFrameWaiter::addDevice(GlobalV4Linstance *pDevice) {
+    if (epoll_fd < 0) return false;
+    pthread_mutex_lock(&mutex);
+    epoll_event ev;
+    mzero(ev);
+    ev.events = EPOLLIN;
+    ev.data.ptr = pDevice;
+    bool bSuccess = (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pDevice->pollset.fd, &ev) == 0);
+    if (bSuccess) {
+        devices.insert(pDevice);
+        //the thread lives as long as the process, idling in epoll_wait,
+        //unless epoll_wait failed
+        if (!running) {
+            running = (pthread_create(&thread, NULL, &V4LFrameWaiter::threadMain, this) == 0);
+            if (running) pthread_detach(thread);
+            bSuccess = running;
+        }
+    } else {
+        fprintf(stderr,"V4LFrameWaiter: unable to watch '%s' (%s)\n", pDevice->szDevice, strerror(errno));
+    }
+    pthread_mutex_unlock(&mutex);
+    return bSuccess;
+}
+
+void V4LFrameWaiter::removeDevice(GlobalV4Linstance *pDevice) {
+    //waits for a running dispatch, which holds the mutex, to finish
+    pthread_mutex_lock(&mutex);
+    if (devices.erase(pDevice) > 0) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pDevice->pollset.fd, NULL);
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+void *V4LFrameWaiter::threadMain(void *arg) {
+    static_cast<V4LFrameWaiter*>(arg)->run();
+    return NULL;
+}
+
+void V4LFrameWaiter::run() {
+    const int max_events = 16;
+    epoll_event events[max_events];
+    while (true) {
+        int n = epoll_wait(epoll_fd, events, max_events, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr,"V4LFrameWaiter: epoll_wait failed (%s)\n", strerror(errno));
+            //nobody dequeues frames any more: fail the watched streams
+            //instead of letting them time out, restarting a capture then
+            //starts this thread again
+            pthread_mutex_lock(&mutex);
+            for (std::set<GlobalV4Linstance*>::iterator it = devices.begin(); it != devices.end(); it++) {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, (*it)->pollset.fd, NULL);
+                (*it)->dequeueReady(true);
+            }
+            devices.clear();
+            running = false;
+            pthread_mutex_unlock(&mutex);
+            return;
+        }
+        pthread_mutex_lock(&mutex);
+        for (int i = 0; i < n; i++) {
+            GlobalV4Linstance *pDevice = static_cast<GlobalV4Linstance*>(events[i].data.ptr);
+            if (devices.find(pDevice) == devices.end()) continue;  //removed meanwhile
+            bool bError = (events[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+            pDevice->dequeueReady(bError);
+            if (bError) {
+                //e.g. unplugged, stop watching it until it is restarted
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pDevice->pollset.fd, NULL);
+                devices.erase(pDevice);
+            }
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+
 //======================= Actual V4L device interface =======================
 
 bool GlobalV4Linstance::obtainInstance(int iDevice)
@@ -234,9 +335,9 @@ int GlobalV4Linstance::xioctl(int fd,int request,void *data,
     return(ret);
 }
 
-bool GlobalV4Linstance::captureFrame(RawImage *pImage, int iMaxSpin)
+bool GlobalV4Linstance::captureFrame(RawImage *pImage, int max_msec, unsigned int *pSequence)
 {
-    const image_t *_img = captureFrame(iMaxSpin);       //low-level fetch
+    const image_t *_img = captureFrame(max_msec);       //low-level fetch
     if (!_img || _img->data==NULL) return false;
     bool bSuccess = false;
 
@@ -265,7 +366,8 @@ bool GlobalV4Linstance::captureFrame(RawImage *pImage, int iMaxSpin)
                 gettimeofday(&tv,NULL);
                 pImage->setTime((double)tv.tv_sec + tv.tv_usec*(1.0E-6));
                 */
-                pImage->setTime((double)_img->timestamp.tv_sec + _img->timestamp.tv_usec*(1.0E-6));
+                pImage->setTime(_img->time);
+                if (pSequence) (*pSequence) = _img->sequence;
                 bSuccess = true;
             }
             unlock();
@@ -278,59 +380,130 @@ bool GlobalV4Linstance::captureFrame(RawImage *pImage, int iMaxSpin)
 }
 
 
-const GlobalV4Linstance::image_t *GlobalV4Linstance::captureFrame(int iMaxSpin)
+// waits up to max_msec for the next frame handed over by V4LFrameWaiter
+const GlobalV4Linstance::image_t *GlobalV4Linstance::captureFrame(int max_msec)
 {
-    if(!waitForFrame(300)) {
-        fprintf(stderr,"GlobalV4Linstance: error waiting for frame '%s'\n", szDevice);
-        return(NULL);
+    pthread_mutex_lock(&frame_mutex);
+    if (ready_img == NULL && !stream_error && max_msec > 0) {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += max_msec / 1000;
+        deadline.tv_nsec += (max_msec % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (ready_img == NULL && !stream_error) {
+            if (pthread_cond_timedwait(&frame_cond, &frame_mutex, &deadline) == ETIMEDOUT) break;
+        }
     }
-    
-    do {
-        // get the frame
-        dequeueBuffer(tempbuf);
-        
-        // poll to see if a another frame is already available
-        // if so, break out now
-        if(!waitForFrame(0)) break;
+    const image_t *_img = ready_img;
+    ready_img = NULL;
+    pthread_mutex_unlock(&frame_mutex);
+    return(_img);
+}
+
+// called by the V4LFrameWaiter thread whenever the device is readable:
+// dequeues all completed buffers and keeps only the newest one
+void GlobalV4Linstance::dequeueReady(bool bError)
+{
+    const image_t *newest = NULL;
+    while (!bError) {
+        v4l2_buffer buf;
+        mzero(buf);
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = memory_type;
+        if (ioctl(pollset.fd, VIDIOC_DQBUF, &buf) < 0) break;     //EAGAIN: drained
         
-        // otherwise, drop this frame
-        enqueueBuffer(tempbuf);
+        image_t *_img = &(img[buf.index]);
+        _img->timestamp = buf.timestamp;
+        _img->field = (buf.field == V4L2_FIELD_BOTTOM);
+        _img->time = bufferTimeSec(buf);
+        _img->sequence = buf.sequence;
+        if (newest) requeueBuffer(newest->index);
+        newest = _img;
     }
-    while(iMaxSpin--);
     
-    int i = tempbuf.index;
-    img[i].timestamp = tempbuf.timestamp;
-    img[i].field = (tempbuf.field == V4L2_FIELD_BOTTOM);
-    return(&(img[i]));
+    pthread_mutex_lock(&frame_mutex);
+    if (newest) {
+        //a frame nobody picked up is outdated now
+        if (ready_img) requeueBuffer(ready_img->index);
+        ready_img = newest;
+    }
+    if (bError) stream_error = true;
+    pthread_cond_broadcast(&frame_cond);
+    pthread_mutex_unlock(&frame_mutex);
+}
+
+// maps the driver timestamp of a buffer onto the GetTimeSec() clock
+double GlobalV4Linstance::bufferTimeSec(const v4l2_buffer &buf)
+{
+    double t = (double)buf.timestamp.tv_sec + buf.timestamp.tv_usec*(1.0E-6);
+    if (t <= 0.0) return GetTimeSec();
+#ifdef V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC
+    if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        //most drivers stamp with CLOCK_MONOTONIC, shift that to wall-clock time
+        timespec mono;
+        clock_gettime(CLOCK_MONOTONIC, &mono);
+        t += GetTimeSec() - ((double)mono.tv_sec + mono.tv_nsec*(1.0E-9));
+    }
+#endif
+    return t;
 }
 
 bool GlobalV4Linstance::releaseFrame(const GlobalV4Linstance::image_t *_img)
 {
     if(!_img) return(false);
-    tempbuf.index = _img->index;
-    return(enqueueBuffer(tempbuf));
+    return(requeueBuffer(_img->index));
 }
 
-//because there is some delay before camera actually starts, spin
+bool GlobalV4Linstance::requeueBuffer(int index)
+{
+    v4l2_buffer buf;
+    mzero(buf);
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = memory_type;
+    buf.index = index;
+    return(enqueueBuffer(buf));
+}
+
+//because there is some delay before camera actually starts, wait
 // here for the first frame to come out
-void GlobalV4Linstance::captureWarm(int iMaxSpin)
+bool GlobalV4Linstance::captureWarm(int max_msec)
 {
-    const GlobalV4Linstance::image_t *_img = NULL;
-    while (!_img) {
-        _img = captureFrame(iMaxSpin);
-    }
-    if (_img->data)
-        releaseFrame(_img);
+    const GlobalV4Linstance::image_t *_img = captureFrame(max_msec);
+    if (!_img) return false;
+    releaseFrame(_img);
+    return true;
 }
 
-bool GlobalV4Linstance::waitForFrame(int max_msec)
+// Allocates a capture buffer for USERPTR streaming. The buffers are
+// page-aligned (and thus 64-byte aligned for the conversion routines),
+// backed by huge pages if the system has some reserved, or else at least
+// advised to transparent huge pages. \p length is rounded up accordingly,
+// the buffer is released with munmap() just like a driver buffer.
+unsigned char *GlobalV4Linstance::allocateUserBuffer(size_t &length)
 {
-    if (pollset.fd==-1) return false;
-    int n = poll(&pollset,1,max_msec);
-    return(n==1 && (pollset.revents & POLLIN)!=0);
+    const size_t huge_page = 2*1024*1024;
+    size_t huge_length = (length + huge_page - 1) & ~(huge_page - 1);
+    void *p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    p = mmap(NULL, huge_length, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (p == MAP_FAILED) {
+        p = mmap(NULL, huge_length, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+        madvise(p, huge_length, MADV_HUGEPAGE);
+#endif
+    }
+    length = huge_length;
+    return static_cast<unsigned char*>(p);
 }
 
-bool GlobalV4Linstance::startStreaming(int iWidth_, int iHeight_, int iInputIdx)
+bool GlobalV4Linstance::startStreaming(int iWidth_, int iHeight_, int iInputIdx, bool bUserPtr)
 {
     struct v4l2_requestbuffers req;
     
@@ -365,23 +538,54 @@ bool GlobalV4Linstance::startStreaming(int iWidth_, int iHeight_, int iInputIdx)
     setControl(V4L2_CID_SATURATION, lControlVal);
      */
 
-    // Request mmap-able capture buffers
+    // Request user pointer buffers, if wanted and supported by the driver
     mzero(req);
-    req.count  = V4L_STREAMBUFS;
-    req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    req.memory = V4L2_MEMORY_MMAP;
-    if(!xioctl(VIDIOC_REQBUFS, &req, "Request Buffers") || req.count != V4L_STREAMBUFS) {
-        printf("REQBUFS returned error, count %d\n", req.count);
-        return(false);
+    memory_type = V4L2_MEMORY_MMAP;
+    if (bUserPtr) {
+        req.count  = V4L_STREAMBUFS;
+        req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_USERPTR;
+        if(ioctl(pollset.fd, VIDIOC_REQBUFS, &req) == 0 && req.count == V4L_STREAMBUFS) {
+            memory_type = V4L2_MEMORY_USERPTR;
+        } else {
+            printf("Warning: '%s' does not support user pointer streaming, using mmap\n", szDevice);
+        }
+    }
+    
+    // Request mmap-able capture buffers
+    if (memory_type == V4L2_MEMORY_MMAP) {
+        mzero(req);
+        req.count  = V4L_STREAMBUFS;
+        req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_MMAP;
+        if(!xioctl(VIDIOC_REQBUFS, &req, "Request Buffers") || req.count != V4L_STREAMBUFS) {
+            printf("REQBUFS returned error, count %d\n", req.count);
+            return(false);
+        }
     }
     
     // set up individual buffers
     mzero(img,V4L_STREAMBUFS);
     mzero(tempbuf);
     tempbuf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    tempbuf.memory = V4L2_MEMORY_MMAP;
+    tempbuf.memory = memory_type;
+    
+    if (memory_type == V4L2_MEMORY_USERPTR) {
+        size_t frame_size = fmt.fmt.pix.sizeimage;
+        if (frame_size == 0) frame_size = iWidth_ * iHeight_ * 2;
+        for(unsigned i=0; i<V4L_STREAMBUFS; i++){
+            img[i].index = i;
+            img[i].length = frame_size;
+            img[i].data = allocateUserBuffer(img[i].length);
+            if(img[i].data == NULL){
+                printf("Unable to allocate capture buffer (%s)\n",strerror(errno));
+                return(false);
+            }
+        }
+        req.count = V4L_STREAMBUFS;
+    }
     
-    for(unsigned i=0; i<req.count; i++){
+    for(unsigned i=0; memory_type == V4L2_MEMORY_MMAP && i<req.count; i++){
         tempbuf.index = i;
         if(!xioctl(VIDIOC_QUERYBUF, &tempbuf, "Allocate query buffer")) {
             printf("QUERYBUF returned error, '%s'\n", szDevice);
@@ -402,6 +606,7 @@ bool GlobalV4Linstance::startStreaming(int iWidth_, int iHeight_, int iInputIdx)
     //enqueue buffer that we just memmapped/allocated
     for(unsigned i=0; i<req.count; i++){
         tempbuf.index = i;
+        tempbuf.memory = memory_type;
         if(!enqueueBuffer(tempbuf)){
             printf("Error queueing initial buffers, '%s'\n", szDevice);
             return(false);
@@ -410,13 +615,27 @@ bool GlobalV4Linstance::startStreaming(int iWidth_, int iHeight_, int iInputIdx)
     
     //start actual stream
     v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    return xioctl(VIDIOC_STREAMON, &type, "StreamOn");
+    if (!xioctl(VIDIOC_STREAMON, &type, "StreamOn")) return(false);
+    
+    //from now on frames are dequeued by the shared waiter thread
+    pthread_mutex_lock(&frame_mutex);
+    ready_img = NULL;
+    stream_error = false;
+    pthread_mutex_unlock(&frame_mutex);
+    return V4LFrameWaiter::obtainInstance()->addDevice(this);
 }
 
 bool GlobalV4Linstance::stopStreaming()
 {
     bool bSuccess = false;
     if(pollset.fd != -1){
+        V4LFrameWaiter::obtainInstance()->removeDevice(this);
+        pthread_mutex_lock(&frame_mutex);
+        ready_img = NULL;
+        stream_error = true;            //wake up anybody still waiting
+        pthread_cond_broadcast(&frame_cond);
+        pthread_mutex_unlock(&frame_mutex);
+        
         v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
         bSuccess = xioctl(VIDIOC_STREAMOFF, &type, NULL);
         
@@ -436,6 +655,11 @@ bool GlobalV4Linstance::stopStreaming()
 
 bool GlobalV4Linstance::enqueueBuffer(v4l2_buffer &buf)
 {
+    if (memory_type == V4L2_MEMORY_USERPTR) {
+        //user pointers have to be handed back with every QBUF
+        buf.m.userptr = reinterpret_cast<unsigned long>(img[buf.index].data);
+        buf.length = img[buf.index].length;
+    }
     return xioctl(VIDIOC_QBUF, &buf, "EnqueueBuffer");
 }
 
@@ -566,6 +790,11 @@ CaptureV4L::CaptureV4L(VarList * _settings,int default_camera_id) : CaptureInter
     cam_count = 0;
     cam_id=default_camera_id;
     is_capturing=false;
+    have_sequence=false;
+    last_sequence=0;
+    dropped_frames=0;
+    frame_failures=0;
+    rawFrameIndex=0;
 
 #ifndef VDATA_NO_QT
     mutex.lock();
@@ -606,6 +835,9 @@ CaptureV4L::CaptureV4L(VarList * _settings,int default_camera_id) : CaptureInter
 //    v_colorout->addItem(Colors::colorFormatToString(COLOR_YUV422_UYVY));
 //    v_colorout->addItem(Colors::colorFormatToString(COLOR_YUV422_YUYV));
 //    v_colorout->addItem(Colors::colorFormatToString(COLOR_YUV444));
+    //frames are always converted from the driver buffers, this only saves
+    //the copy of the converted frame into the frame buffer:
+    conversion_settings->addChild(v_zero_copy=new VarBool("lend converted frames",false));
     
     dcam_parameters->addFlags( VARTYPE_FLAG_HIDE_CHILDREN );
     
@@ -633,6 +865,9 @@ CaptureV4L::CaptureV4L(VarList * _settings,int default_camera_id) : CaptureInter
 //    }
     capture_settings->addChild(v_buffer_size      = new VarInt("ringbuffer size",V4L_STREAMBUFS));
     v_buffer_size->addFlags(VARTYPE_FLAG_READONLY);
+    capture_settings->addChild(v_io_method        = new VarStringEnum("streaming I/O","mmap"));
+    v_io_method->addItem("mmap");
+    v_io_method->addItem("user pointer");
 
     // we could do a better job of enumerating formats here...
     // http://www.linuxtv.org/downloads/v4l-dvb-apis/vidioc-enum-fmt.html
@@ -981,7 +1216,8 @@ void CaptureV4L::readParameterProperty(VarList * item) {
 CaptureV4L::~CaptureV4L()
 {
     GlobalV4LinstanceManager::removeInstance(camera_instance);
-    rawFrame.clear();           //release memory from local image
+    for (unsigned int i=0; i<rawFrames.size(); i++)
+        rawFrames[i].clear();   //release memory from local images
 }
 
 bool CaptureV4L::resetBus() {
@@ -1032,6 +1268,8 @@ void CaptureV4L::cleanup()
     if (camera_instance && is_capturing)
         camera_instance->stopStreaming();
     is_capturing=false;
+    //the caller detached all lent frames before stopping
+    heldRawFrames.clear();
 #ifndef VDATA_NO_QT
     mutex.unlock();
 #endif
@@ -1348,7 +1586,7 @@ bool CaptureV4L::startCapture()
     //TODO: map cature_format to VFL format
     //  http://linuxtv.org/downloads/v4l-dvb-apis/yuv-formats.html
     
-    if (!camera_instance->startStreaming(width, height)) {
+    if (!camera_instance->startStreaming(width, height, 0, v_io_method->getString()=="user pointer")) {
         fprintf(stderr,"CaptureV4L Error: unable to setup capture. Maybe selected combination of Format/Resolution is not supported?\n");
 #ifndef VDATA_NO_QT
         mutex.unlock();
@@ -1380,10 +1618,14 @@ bool CaptureV4L::startCapture()
 #ifndef VDATA_NO_QT
     mutex.lock();
 #endif
-    camera_instance->captureWarm();
+    if (!camera_instance->captureWarm()) {
+        fprintf(stderr,"CaptureV4L Warning: no frame from camera %d yet\n", cam_id);
+    }
     
     //now we can allow upstream/external to capture
     is_capturing=true;
+    have_sequence=false;
+    dropped_frames=0;
 
 #ifndef VDATA_NO_QT
     mutex.unlock();
@@ -1399,7 +1641,14 @@ bool CaptureV4L::copyFrame(const RawImage & src, RawImage & target)
 
 bool CaptureV4L::copyAndConvertFrame(const RawImage & src, RawImage & target)
 {
-    return convertFrame(src, target, Colors::stringToColorFormat(v_colorout->getSelection().c_str()));
+    ColorFormat output_fmt=Colors::stringToColorFormat(v_colorout->getSelection().c_str());
+    if (v_zero_copy->getBool() && src.getColorFormat()==output_fmt && src.getData()!=0) {
+        //the driver buffer was already converted into one of rawFrames,
+        //which is not touched again before it was released, so lend it
+        target.borrowData(src);
+        return true;
+    }
+    return convertFrame(src, target, output_fmt);
 }
 
 
@@ -1464,10 +1713,38 @@ RawImage CaptureV4L::getFrame()
 #ifndef VDATA_NO_QT
     mutex.lock();
 #endif
-    // capture a frame and write it
+    // capture a frame and write it. A frame lent to the caller must not be
+    // overwritten before it was released, so lent frames are tracked and
+    // only a converted frame which is not held any more is reused.
+    if (v_zero_copy->getBool()) {
+        if (rawFrames.size() < (unsigned int)max_held_frames)
+            rawFrames.resize(max_held_frames);
+        unsigned int i;
+        for (i=1; i<=rawFrames.size(); i++) {
+            unsigned int idx = (rawFrameIndex + i) % rawFrames.size();
+            if (std::find(heldRawFrames.begin(), heldRawFrames.end(), idx) == heldRawFrames.end())
+                break;
+        }
+        if (i > rawFrames.size()) {
+            //the caller holds more frames than announced
+            rawFrames.push_back(RawImage());
+            rawFrameIndex = rawFrames.size() - 1;
+        } else {
+            rawFrameIndex = (rawFrameIndex + i) % rawFrames.size();
+        }
+    } else {
+        heldRawFrames.clear();
+        if (rawFrames.empty())
+            rawFrames.resize(1);
+        rawFrameIndex = 0;
+    }
+    RawImage & rawFrame = rawFrames[rawFrameIndex];
     rawFrame.ensure_allocation(capture_format, width, height);
-    if (!camera_instance || !is_capturing || !camera_instance->captureFrame(&rawFrame)) {
-        fprintf (stderr, "CaptureV4L Warning: Frame not ready, camera %d\n", cam_id);
+    unsigned int sequence = 0;
+    if (!camera_instance || !is_capturing || !camera_instance->captureFrame(&rawFrame, 500, &sequence)) {
+        //only report the first of a series of failures
+        if (frame_failures++ == 0)
+            fprintf (stderr, "CaptureV4L Warning: Frame not ready, camera %d\n", cam_id);
 #ifndef VDATA_NO_QT
         mutex.unlock();
 #endif
@@ -1475,6 +1752,14 @@ RawImage CaptureV4L::getFrame()
         return badImage;
     }
 
+    frame_failures = 0;
+    
+    //frames skipped by the driver or by the frame waiter show up as gaps
+    if (have_sequence && sequence > last_sequence + 1)
+        dropped_frames += sequence - last_sequence - 1;
+    last_sequence = sequence;
+    have_sequence = true;
+
 #ifndef NDEBUG
     //strictly for debugging
     const char *szOutput = NULL;
@@ -1486,18 +1771,43 @@ RawImage CaptureV4L::getFrame()
     
     /*printf("B: %d w: %d h: %d bytes: %d pad: %d pos: %d %d depth: %d bpp %d coding: %d  behind %d id %d\n",frame->data_in_padding ? 1 : 0, frame->size[0],frame->size[1],frame->image_bytes,frame->padding_bytes, frame->position[0],frame->position[1],frame->data_depth,frame->packets_per_frame,frame->color_coding,frame->frames_behind,frame->id);*/
 
+    if (v_zero_copy->getBool())
+        heldRawFrames.push_back(rawFrameIndex);
+
 #ifndef VDATA_NO_QT
     mutex.unlock();
 #endif
     return rawFrame;
 }
 
+unsigned int CaptureV4L::getDroppedFrames() const
+{
+    return dropped_frames;
+}
+
 void CaptureV4L::releaseFrame() {
 #ifndef VDATA_NO_QT
     mutex.lock();
 #endif
     
-    //frame management done at low-level now...
+    //driver buffers are requeued at low-level now, only lent frames remain
+    if (!heldRawFrames.empty())
+        heldRawFrames.pop_front();
+#ifndef VDATA_NO_QT
+    mutex.unlock();
+#endif
+}
+
+void CaptureV4L::releaseHeldFrame(const unsigned char * data) {
+#ifndef VDATA_NO_QT
+    mutex.lock();
+#endif
+    for (std::deque<unsigned int>::iterator it=heldRawFrames.begin(); it!=heldRawFrames.end(); it++) {
+        if (rawFrames[*it].getData() == data) {
+            heldRawFrames.erase(it);
+            break;
+        }
+    }
 #ifndef VDATA_NO_QT
     mutex.unlock();
 #endif
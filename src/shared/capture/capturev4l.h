@@ -44,11 +44,12 @@
 #include <sys/poll.h>
 
 #include <map>
+#include <set>
+#include <deque>
+#include <pthread.h>
 
 #ifndef VDATA_NO_QT
 #include <QMutex>
-#else
-#include <pthread.h>
 #endif
 
 typedef long v4lfeature_t;
@@ -62,6 +63,7 @@ typedef long v4lfeature_t;
 
 // place-holder for friend relationship
 class GlobalV4LinstanceManager;
+class V4LFrameWaiter;
 
 /*!
  \class GlobalV4Linstance
@@ -71,6 +73,7 @@ class GlobalV4LinstanceManager;
 class GlobalV4Linstance
 {
 friend class GlobalV4LinstanceManager;
+friend class V4LFrameWaiter;
 public:
     struct image_t {
         unsigned char *data;
@@ -78,6 +81,8 @@ public:
         int index;
         uint8_t  field;        // which field of video this is from {0,1}
         timeval  timestamp;
+        double   time;         // timestamp on the GetTimeSec() clock
+        unsigned int sequence; // driver frame counter
     };
     enum private_control_t {    //custom control codes that must be individually caught...
         V4L2_FEATURE_PRIVATE = V4L2_CID_PRIVATE_BASE,
@@ -91,8 +96,13 @@ protected:
 #endif
         counter=0;
         pollset.fd=-1;
+        memory_type=V4L2_MEMORY_MMAP;
         mzero(img, V4L_STREAMBUFS);
         memset(szDevice, 0, sizeof(char)*128);
+        ready_img=NULL;
+        stream_error=false;
+        pthread_mutex_init(&frame_mutex, NULL);
+        pthread_cond_init(&frame_cond, NULL);
     }
     ~GlobalV4Linstance() {
         while (counter) removeInstance();       //if iterating, release control first
@@ -100,6 +110,8 @@ protected:
 #else
         pthread_mutex_destroy (&mutex);
 #endif
+        pthread_cond_destroy(&frame_cond);
+        pthread_mutex_destroy(&frame_mutex);
     }
 #ifndef VDATA_NO_QT
     QMutex mutex;
@@ -112,10 +124,20 @@ private:
     char szDevice[128];
     struct v4l2_buffer tempbuf;
     image_t img[V4L_STREAMBUFS];
+    v4l2_memory memory_type;
+    
+    // hand-over of dequeued frames from the V4LFrameWaiter thread
+    pthread_mutex_t frame_mutex;
+    pthread_cond_t frame_cond;
+    const image_t *ready_img;   // newest dequeued frame, not yet taken
+    bool stream_error;
     
     bool enqueueBuffer(v4l2_buffer &buf);
     bool dequeueBuffer(v4l2_buffer &buf);
-    bool waitForFrame(int max_msec=500);
+    bool requeueBuffer(int index);
+    void dequeueReady(bool bError);
+    static double bufferTimeSec(const v4l2_buffer &buf);
+    static unsigned char *allocateUserBuffer(size_t &length);
 
     bool obtainInstance(int iDevice);
     bool obtainInstance(char *szDevice);
@@ -129,12 +151,12 @@ public:
     bool setControl(int ctrl_id,long s);
     bool checkControl(int ctrl_id, bool *bEnabled=NULL, bool *bReadOnly=NULL,
                       long *lDefault=NULL, long *lMin=NULL, long *lMax=NULL);
-    bool startStreaming(int iWidth_, int iHeight_, int iInput=0);
+    bool startStreaming(int iWidth_, int iHeight_, int iInput=0, bool bUserPtr=false);
     bool stopStreaming();
     
-    void captureWarm(int iMaxSpin=1);
-    bool captureFrame(RawImage *pImage, int iMaxSpin=1);
-    const image_t *captureFrame(int iMaxSpin=1);
+    bool captureWarm(int max_msec=2000);
+    bool captureFrame(RawImage *pImage, int max_msec=500, unsigned int *pSequence=NULL);
+    const image_t *captureFrame(int max_msec=500);
     bool releaseFrame(const image_t *_img);
     
 private:
@@ -173,6 +195,38 @@ private:
 };
 
 
+/*!
+ \class V4LFrameWaiter
+ \brief A single thread waiting for frames of all streaming V4L devices
+ 
+ Every streaming GlobalV4Linstance registers its device with one epoll
+ set. Whenever a device signals new frames, the waiter dequeues them and
+ hands the newest one to the capture thread blocked in captureFrame(),
+ so nobody polls and no CPU is used between frames.
+ */
+class V4LFrameWaiter
+{
+public:
+    static V4LFrameWaiter* obtainInstance();
+    bool addDevice(GlobalV4Linstance *pDevice);
+    void removeDevice(GlobalV4Linstance *pDevice);
+protected:
+    V4LFrameWaiter();
+    V4LFrameWaiter(const V4LFrameWaiter&);
+    V4LFrameWaiter& operator= (const V4LFrameWaiter&);
+    static void *threadMain(void *arg);
+    void run();
+private:
+    static V4LFrameWaiter* pinstance;
+    static pthread_mutex_t instance_mutex;
+    pthread_mutex_t mutex;      // held while dispatching, protects devices
+    pthread_t thread;
+    bool running;
+    int epoll_fd;
+    std::set<GlobalV4Linstance*> devices;
+};
+
+
 /*!
  \class GlobalV4LinstanceManager
  \brief A static instance manager to provide global singleton access to GlobalV4Linstance
@@ -236,6 +290,7 @@ protected:
     
     //processing variables:
     VarStringEnum * v_colorout;
+    VarBool       * v_zero_copy;
     
     //DCAM parameters:
     VarList * P_BRIGHTNESS;
@@ -260,6 +315,7 @@ protected:
     VarStringEnum * v_colormode;
     VarStringEnum * v_format;
     VarInt    * v_buffer_size;
+    VarStringEnum * v_io_method;
     
     int cam_id;
     int width;
@@ -270,7 +326,16 @@ protected:
     int ring_buffer_size;
     int cam_list[MAX_CAM_SCAN];
     int cam_count;
-    RawImage rawFrame;
+    //converted frames, used in turn while lent frames are held:
+    std::vector<RawImage> rawFrames;
+    unsigned int rawFrameIndex;
+    std::deque<unsigned int> heldRawFrames; //indices of lent frames, oldest first
+    
+    //frame loss detection based on the driver's frame counter:
+    bool have_sequence;
+    unsigned int last_sequence;
+    unsigned int dropped_frames;
+    unsigned int frame_failures;
     
     GlobalV4Linstance * camera_instance;
     
@@ -311,6 +376,8 @@ public:
     virtual RawImage getFrame();
     
     virtual void releaseFrame();
+
+    virtual void releaseHeldFrame(const unsigned char * data);
     
     virtual bool resetBus();
     
@@ -334,6 +401,8 @@ public:
     
     virtual bool copyAndConvertFrame(const RawImage & src, RawImage & target);
     
+    virtual unsigned int getDroppedFrames() const;
+    
     virtual string getCaptureMethodName() const;
     
 protected:
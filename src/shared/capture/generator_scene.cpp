@@ -0,0 +1,567 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    generator_scene.cpp
+  \brief   C++ Implementation: GeneratorScene
+  \author  Author Name, 2026
+*/
+//========================================================================
+
+#include "generator_scene.h"
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const rgb side_color = rgb(40,40,40);
+static const rgb outside_color = rgb(70,70,70);
+
+GeneratorScene::GeneratorScene(VarList * _settings) : camera(0)
+{
+  settings=_settings;
+  settings->addChild(v_enable = new VarBool("enable scene", false));
+  settings->addChild(v_seed = new VarInt("random seed", 1));
+  settings->addChild(v_robots_per_team = new VarInt("robots per team", 6, 0, 16));
+  settings->addChild(v_balls = new VarInt("balls", 1, 0, 16));
+  settings->addChild(v_robot_height = new VarDouble("robot height (mm)", 140.0));
+  settings->addChild(v_robot_radius = new VarDouble("robot radius (mm)", 90.0));
+  settings->addChild(v_ball_radius = new VarDouble("ball radius (mm)", 21.5));
+  settings->addChild(v_speed = new VarDouble("speed (mm/s)", 500.0, 0.0));
+
+  const char * team_names[2] = { "Blue Team", "Yellow Team" };
+  for (int t = 0; t < 2; t++) {
+    TeamSettings & ts = team_settings[t];
+    settings->addChild(ts.list = new VarList(team_names[t]));
+    ts.list->addChild(ts.v_marker_image_file = new VarString("marker image file", "patterns/teams/standard2010.png"));
+    ts.list->addChild(ts.v_marker_image_rows = new VarInt("marker image rows", 3, 1));
+    ts.list->addChild(ts.v_marker_image_cols = new VarInt("marker image cols", 4, 1));
+    markers[t].valid=false;
+    markers[t].rows=0;
+    markers[t].cols=0;
+  }
+
+  settings->addChild(field_settings = new VarList("Field"));
+  field_settings->addChild(v_field_length = new VarDouble("field length (mm)", 9000.0));
+  field_settings->addChild(v_field_width = new VarDouble("field width (mm)", 6000.0));
+  field_settings->addChild(v_boundary_width = new VarDouble("boundary width (mm)", 300.0));
+  field_settings->addChild(v_line_width = new VarDouble("line width (mm)", 10.0));
+  field_settings->addChild(v_center_circle_radius = new VarDouble("center circle radius (mm)", 500.0));
+
+  settings->addChild(imaging_settings = new VarList("Imaging"));
+  imaging_settings->addChild(v_noise = new VarDouble("noise stddev", 0.0, 0.0, 64.0));
+  imaging_settings->addChild(v_blur = new VarInt("blur radius (pixels)", 0, 0, 16));
+  imaging_settings->addChild(v_lighting_gradient = new VarDouble("lighting gradient", 0.0, 0.0, 1.0));
+
+  settings->addChild(camera_settings = new VarList("Camera Parameters"));
+  camera.addSettingsToList(*camera_settings);
+
+  cache_width=0;
+  cache_height=0;
+  visible_min_x=visible_max_x=visible_min_y=visible_max_y=0.0;
+  noise_stddev=0.0;
+  max_history=256;
+}
+
+GeneratorScene::~GeneratorScene()
+{
+}
+
+bool GeneratorScene::isEnabled() const
+{
+  return v_enable->getBool();
+}
+
+CameraParameters & GeneratorScene::getCameraParameters()
+{
+  return camera;
+}
+
+void GeneratorScene::updateCache(int width, int height)
+{
+  bool camera_changed=camera_model.update(camera);
+  vector<double> key;
+  key.push_back(v_field_length->getDouble());
+  key.push_back(v_field_width->getDouble());
+  key.push_back(v_boundary_width->getDouble());
+  key.push_back(v_line_width->getDouble());
+  key.push_back(v_center_circle_radius->getDouble());
+  key.push_back(v_lighting_gradient->getDouble());
+  if (!camera_changed && key == cache_key && width == cache_width && height == cache_height) return;
+  cache_key=key;
+  cache_width=width;
+  cache_height=height;
+
+  camera_location=camera_model.getWorldLocation();
+  int n = width * height;
+  ground_x.resize(n);
+  ground_y.resize(n);
+  shading.resize(n);
+  background.allocate(width,height);
+
+  double gradient=v_lighting_gradient->getDouble();
+  double cx = 0.5 * width;
+  double cy = 0.5 * height;
+  double max_r_sq = cx*cx + cy*cy;
+  GVector::vector3d<double> p_f;
+  visible_min_x=visible_min_y=1e12;
+  visible_max_x=visible_max_y=-1e12;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      int i = y*width + x;
+      camera_model.image2fieldExact(p_f,GVector::vector2d<double>(x,y),0.0);
+      ground_x[i]=p_f.x;
+      ground_y[i]=p_f.y;
+      background.setPixel(x,y,fieldColor(p_f.x,p_f.y));
+      double r_sq = (sq(x-cx) + sq(y-cy)) / max_r_sq;
+      shading[i]=(unsigned short)bound(256.0 * (1.0 - gradient * r_sq),0.0,256.0);
+      if (x==0 || y==0 || x==width-1 || y==height-1) {
+        visible_min_x=min(visible_min_x,p_f.x);
+        visible_max_x=max(visible_max_x,p_f.x);
+        visible_min_y=min(visible_min_y,p_f.y);
+        visible_max_y=max(visible_max_y,p_f.y);
+      }
+    }
+  }
+
+  //keep the objects on the field, even if the camera sees more than that:
+  double half_length = 0.5 * v_field_length->getDouble() + v_boundary_width->getDouble();
+  double half_width = 0.5 * v_field_width->getDouble() + v_boundary_width->getDouble();
+  visible_min_x=max(visible_min_x,-half_length);
+  visible_max_x=min(visible_max_x,half_length);
+  visible_min_y=max(visible_min_y,-half_width);
+  visible_max_y=min(visible_max_y,half_width);
+}
+
+void GeneratorScene::updateMarkerImage(Team team)
+{
+  TeamSettings & ts = team_settings[team];
+  MarkerImage & m = markers[team];
+  string filename = ts.v_marker_image_file->getString();
+  int rows = ts.v_marker_image_rows->getInt();
+  int cols = ts.v_marker_image_cols->getInt();
+  if (filename == m.filename && rows == m.rows && cols == m.cols) return;
+  m.filename=filename;
+  m.rows=rows;
+  m.cols=cols;
+  m.valid=false;
+  m.center_x.clear();
+  m.center_y.clear();
+  m.background.clear();
+  if (filename.empty() || rows < 1 || cols < 1) return;
+  if (m.image.load(filename)==false) {
+    fprintf(stderr,"GeneratorScene: unable to load marker image '%s'. Drawing plain robots.\n",filename.c_str());
+    return;
+  }
+  m.cell_w = m.image.getWidth() / cols;
+  m.cell_h = m.image.getHeight() / rows;
+  if (m.cell_w < 1 || m.cell_h < 1) return;
+
+  //the marker images carry the blue team's center marker, yellow robots
+  //get the same layout with a yellow center instead:
+  rgb center = (team == TEAM_YELLOW) ? RGB::Yellow : RGB::Blue;
+  int n = m.image.getNumPixels();
+  rgb * p = m.image.getPixelData();
+  for (int i = 0; i < n; i++) {
+    if (p[i].b > 150 && p[i].r < 100 && p[i].g < 100) p[i]=center;
+  }
+
+  //find each cell's center marker, robot local coordinates are relative to it:
+  for (int idx = 0; idx < rows * cols; idx++) {
+    int x0 = (idx % cols) * m.cell_w;
+    int y0 = (idx / cols) * m.cell_h;
+    double sum_x=0.0, sum_y=0.0;
+    int count=0;
+    for (int y = y0; y < y0 + m.cell_h; y++) {
+      for (int x = x0; x < x0 + m.cell_w; x++) {
+        rgb c = m.image.getPixel(x,y);
+        if (c.r==center.r && c.g==center.g && c.b==center.b) {
+          sum_x+=x;
+          sum_y+=y;
+          count++;
+        }
+      }
+    }
+    m.center_x.push_back(count > 0 ? sum_x / count : x0 + 0.5 * m.cell_w);
+    m.center_y.push_back(count > 0 ? sum_y / count : y0 + 0.5 * m.cell_h);
+    //the cell's background is the most common color close to its corners,
+    //which keeps the border lines and the height bar out of the vote:
+    int ix = m.cell_w / 20;
+    int iy = m.cell_h / 20;
+    rgb corners[4] = { m.image.getPixel(x0 + ix, y0 + iy), m.image.getPixel(x0 + m.cell_w - 1 - ix, y0 + iy),
+                       m.image.getPixel(x0 + ix, y0 + m.cell_h - 1 - iy), m.image.getPixel(x0 + m.cell_w - 1 - ix, y0 + m.cell_h - 1 - iy) };
+    int best = 0;
+    int best_votes = 0;
+    for (int a = 0; a < 4; a++) {
+      int votes = 0;
+      for (int b = 0; b < 4; b++) {
+        if (corners[a].r==corners[b].r && corners[a].g==corners[b].g && corners[a].b==corners[b].b) votes++;
+      }
+      if (votes > best_votes) {
+        best = a;
+        best_votes = votes;
+      }
+    }
+    m.background.push_back(corners[best]);
+  }
+  m.valid=true;
+}
+
+rgb GeneratorScene::fieldColor(double x, double y) const
+{
+  double half_length = 0.5 * v_field_length->getDouble();
+  double half_width = 0.5 * v_field_width->getDouble();
+  double boundary = v_boundary_width->getDouble();
+  double half_line = 0.5 * v_line_width->getDouble();
+  double ax = fabs(x);
+  double ay = fabs(y);
+  if (ax > half_length + boundary || ay > half_width + boundary) return outside_color;
+  if (ax <= half_length + half_line && ay <= half_width + half_line) {
+    if (fabs(ax - half_length) <= half_line || fabs(ay - half_width) <= half_line) return RGB::White;
+    if (ax <= half_line || ay <= half_line) return RGB::White;
+    if (fabs(sqrt(x*x + y*y) - v_center_circle_radius->getDouble()) <= half_line) return RGB::White;
+  }
+  return RGB::DarkGreen;
+}
+
+void GeneratorScene::updatePoses(GroundTruth & truth, double scene_time)
+{
+  //everything is derived from the seed, so each frame is reproducible on its own:
+  Random rng;
+  rng.seed((uint32_t)v_seed->getInt());
+
+  //a team can not field more robots than its marker image has patterns for:
+  int n_team[2];
+  for (int t = 0; t < 2; t++) {
+    n_team[t] = v_robots_per_team->getInt();
+    if (markers[t].valid) n_team[t] = min(n_team[t],(int)markers[t].center_x.size());
+  }
+  int n_robots = n_team[TEAM_BLUE] + n_team[TEAM_YELLOW];
+  int n_balls = v_balls->getInt();
+  int n = n_robots + n_balls;
+  truth.robots.clear();
+  truth.balls.clear();
+  if (n <= 0) return;
+
+  //one grid cell per object, spread over the visible part of the field:
+  double area_w = max(visible_max_x - visible_min_x, 1.0);
+  double area_h = max(visible_max_y - visible_min_y, 1.0);
+  int cols = max(1,(int)ceil(sqrt(n * area_w / area_h)));
+  int rows = (n + cols - 1) / cols;
+  double cell_w = area_w / cols;
+  double cell_h = area_h / rows;
+
+  vector<int> cells(rows * cols);
+  for (unsigned int i = 0; i < cells.size(); i++) cells[i]=i;
+  for (int i = (int)cells.size() - 1; i > 0; i--) swap(cells[i],cells[rng.uint32(i + 1)]);
+
+  double radius = v_robot_radius->getDouble();
+  double amplitude = max(0.0, 0.5 * (0.5 * min(cell_w,cell_h) - radius));
+  double speed = v_speed->getDouble();
+  double omega = amplitude > 0.0 ? speed / amplitude : 0.0;
+
+  for (int k = 0; k < n; k++) {
+    double phase = rng.real32() * 2.0 * M_PI;
+    double heading = rng.real32() * 2.0 * M_PI;
+    int cell = cells[k];
+    double cx = visible_min_x + (cell % cols + 0.5) * cell_w;
+    double cy = visible_min_y + (cell / cols + 0.5) * cell_h;
+    double a = omega * scene_time + phase;
+    double x = cx + amplitude * cos(a);
+    double y = cy + amplitude * sin(a);
+    if (k < n_robots) {
+      RobotPose robot;
+      robot.team = (k < n_team[TEAM_BLUE]) ? TEAM_BLUE : TEAM_YELLOW;
+      robot.id = (k < n_team[TEAM_BLUE]) ? k : k - n_team[TEAM_BLUE];
+      robot.x = x;
+      robot.y = y;
+      robot.orientation = angle_mod(heading + a);
+      robot.height = v_robot_height->getDouble();
+      truth.robots.push_back(robot);
+    } else {
+      BallPose ball;
+      ball.x = x;
+      ball.y = y;
+      ball.z = v_ball_radius->getDouble();
+      truth.balls.push_back(ball);
+    }
+  }
+}
+
+bool GeneratorScene::projectBox(double min_x, double max_x, double min_y, double max_y,
+                                double min_z, double max_z, int width, int height,
+                                int & x0, int & y0, int & x1, int & y1) const
+{
+  double ix0=1e12, iy0=1e12, ix1=-1e12, iy1=-1e12;
+  GVector::vector2d<double> p_i;
+  for (int c = 0; c < 8; c++) {
+    GVector::vector3d<double> p_f((c & 1) ? max_x : min_x,(c & 2) ? max_y : min_y,(c & 4) ? max_z : min_z);
+    //points at or behind the camera plane can not be projected:
+    if (p_f.z >= camera_location.z) return false;
+    camera_model.field2image(p_f,p_i);
+    ix0=min(ix0,p_i.x);
+    iy0=min(iy0,p_i.y);
+    ix1=max(ix1,p_i.x);
+    iy1=max(iy1,p_i.y);
+  }
+  x0=max(0,(int)floor(ix0) - 1);
+  y0=max(0,(int)floor(iy0) - 1);
+  x1=min(width - 1,(int)ceil(ix1) + 1);
+  y1=min(height - 1,(int)ceil(iy1) + 1);
+  return x0 <= x1 && y0 <= y1;
+}
+
+void GeneratorScene::drawRobot(rgbImage & img, const RobotPose & robot) const
+{
+  double radius = v_robot_radius->getDouble();
+  int x0,y0,x1,y1;
+  if (!projectBox(robot.x - radius,robot.x + radius,robot.y - radius,robot.y + radius,0.0,robot.height,
+                  img.getWidth(),img.getHeight(),x0,y0,x1,y1)) return;
+
+  const MarkerImage & m = markers[robot.team];
+  bool use_image = m.valid && robot.id < (int)m.center_x.size();
+  rgb team_color = (robot.team == TEAM_YELLOW) ? RGB::Yellow : RGB::Blue;
+  double cos_a = cos(robot.orientation);
+  double sin_a = sin(robot.orientation);
+  double radius_sq = radius * radius;
+  const GVector::vector3d<double> & c = camera_location;
+  double s = (c.z - robot.height) / c.z;
+
+  int width = img.getWidth();
+  for (int y = y0; y <= y1; y++) {
+    for (int x = x0; x <= x1; x++) {
+      int i = y*width + x;
+      double gx = ground_x[i];
+      double gy = ground_y[i];
+      //where the ray passes the robot's top plane:
+      double dx = c.x + (gx - c.x) * s - robot.x;
+      double dy = c.y + (gy - c.y) * s - robot.y;
+      if (dx*dx + dy*dy <= radius_sq) {
+        double lx = dx * cos_a + dy * sin_a;
+        double ly = -dx * sin_a + dy * cos_a;
+        if (use_image) {
+          //marker image cells have the robot's front up and its left side left:
+          int col = (int)floor(m.center_x[robot.id] - ly + 0.5);
+          int row = (int)floor(m.center_y[robot.id] - lx + 0.5);
+          int cell_x0 = (robot.id % m.cols) * m.cell_w;
+          int cell_y0 = (robot.id / m.cols) * m.cell_h;
+          if (col >= cell_x0 && col < cell_x0 + m.cell_w && row >= cell_y0 && row < cell_y0 + m.cell_h) {
+            rgb p = m.image.getPixel(col,row);
+            const rgb & bg = m.background[robot.id];
+            if (abs((int)p.r - bg.r) + abs((int)p.g - bg.g) + abs((int)p.b - bg.b) > 60) {
+              img.setPixel(x,y,p);
+            }
+          }
+        } else {
+          img.setPixel(x,y,(lx*lx + ly*ly <= sq(25.0)) ? team_color : RGB::Black);
+        }
+        continue;
+      }
+      //otherwise the ray may still hit the robot's side on its way to the ground:
+      double ex = gx - robot.x;
+      double ey = gy - robot.y;
+      double sx = ex - dx;
+      double sy = ey - dy;
+      double len_sq = sx*sx + sy*sy;
+      double t = len_sq > 0.0 ? bound(-(dx*sx + dy*sy) / len_sq,0.0,1.0) : 0.0;
+      if (sq(dx + t*sx) + sq(dy + t*sy) <= radius_sq) {
+        img.setPixel(x,y,side_color);
+      }
+    }
+  }
+}
+
+void GeneratorScene::drawBall(rgbImage & img, const BallPose & ball) const
+{
+  double r = v_ball_radius->getDouble();
+  int x0,y0,x1,y1;
+  if (!projectBox(ball.x - r,ball.x + r,ball.y - r,ball.y + r,ball.z - r,ball.z + r,
+                  img.getWidth(),img.getHeight(),x0,y0,x1,y1)) return;
+
+  const GVector::vector3d<double> & c = camera_location;
+  double ox = c.x - ball.x;
+  double oy = c.y - ball.y;
+  double oz = c.z - ball.z;
+  double oo = ox*ox + oy*oy + oz*oz - r*r;
+  int width = img.getWidth();
+  for (int y = y0; y <= y1; y++) {
+    for (int x = x0; x <= x1; x++) {
+      int i = y*width + x;
+      double dx = ground_x[i] - c.x;
+      double dy = ground_y[i] - c.y;
+      double dz = -c.z;
+      double a = dx*dx + dy*dy + dz*dz;
+      double b = ox*dx + oy*dy + oz*dz;
+      double disc = b*b - a*oo;
+      if (disc < 0.0) continue;
+      double t = (-b - sqrt(disc)) / a;
+      double nz = (oz + t*dz) / r;
+      //lit from above:
+      double light = 0.55 + 0.45 * max(0.0,nz);
+      img.setPixel(x,y,rgb((unsigned char)(RGB::Orange.r * light),
+                           (unsigned char)(RGB::Orange.g * light),
+                           (unsigned char)(RGB::Orange.b * light)));
+    }
+  }
+}
+
+void GeneratorScene::applyShading(rgbImage & img) const
+{
+  int n = img.getNumPixels();
+  rgb * p = img.getPixelData();
+  for (int i = 0; i < n; i++) {
+    unsigned int f = shading[i];
+    p[i].r = (unsigned char)((p[i].r * f) >> 8);
+    p[i].g = (unsigned char)((p[i].g * f) >> 8);
+    p[i].b = (unsigned char)((p[i].b * f) >> 8);
+  }
+}
+
+void GeneratorScene::applyBlur(rgbImage & img, int radius) const
+{
+  //separable box filter with running sums, edges are clamped:
+  int width = img.getWidth();
+  int height = img.getHeight();
+  int stride = width * 3;
+  int window = 2 * radius + 1;
+  unsigned char * data = img.getData();
+
+  //dividing by the window size is done as a fixed point multiplication:
+  unsigned int scale = (1 << 16) / window + 1;
+  vector<unsigned char> line(stride);
+  for (int y = 0; y < height; y++) {
+    unsigned char * row = data + y * stride;
+    memcpy(&line[0],row,stride);
+    unsigned int sum[3] = { 0, 0, 0 };
+    for (int k = -radius; k <= radius; k++) {
+      const unsigned char * p = &line[bound(k,0,width - 1)*3];
+      sum[0] += p[0];
+      sum[1] += p[1];
+      sum[2] += p[2];
+    }
+    for (int x = 0; x < width; x++) {
+      const unsigned char * add = &line[min(x + radius + 1,width - 1)*3];
+      const unsigned char * sub = &line[max(x - radius,0)*3];
+      for (int ch = 0; ch < 3; ch++) {
+        row[x*3 + ch] = (unsigned char)((sum[ch] * scale) >> 16);
+        sum[ch] += add[ch] - sub[ch];
+      }
+    }
+  }
+
+  //the vertical pass keeps one running sum per column and walks the rows in order:
+  vector<unsigned char> source(data,data + stride * height);
+  vector<unsigned int> sums(stride,0);
+  for (int k = -radius; k <= radius; k++) {
+    const unsigned char * row = &source[bound(k,0,height - 1) * stride];
+    for (int i = 0; i < stride; i++) sums[i] += row[i];
+  }
+  for (int y = 0; y < height; y++) {
+    unsigned char * out = data + y * stride;
+    const unsigned char * add = &source[min(y + radius + 1,height - 1) * stride];
+    const unsigned char * sub = &source[max(y - radius,0) * stride];
+    for (int i = 0; i < stride; i++) {
+      out[i] = (unsigned char)((sums[i] * scale) >> 16);
+      sums[i] += add[i] - sub[i];
+    }
+  }
+}
+
+void GeneratorScene::applyNoise(rgbImage & img, int frame_number)
+{
+  static const int table_size = 1 << 16;
+  double stddev = v_noise->getDouble();
+  if (noise_table.empty() || stddev != noise_stddev) {
+    noise_stddev = stddev;
+    noise_table.resize(table_size);
+    Random rng;
+    rng.seed(0x5eed);
+    for (int i = 0; i < table_size; i++) {
+      noise_table[i] = (signed char)bound(rng.gaussian32() * stddev,-127.0,127.0);
+    }
+  }
+  //a per-frame offset into the table keeps consecutive frames uncorrelated:
+  Random rng;
+  rng.seed((uint32_t)(v_seed->getInt() * 7919 + frame_number));
+  unsigned int offset = rng.uint32(table_size);
+  int n = img.getNumBytes();
+  unsigned char * p = img.getData();
+  for (int i = 0; i < n; i++) {
+    p[i] = (unsigned char)bound((int)p[i] + noise_table[(offset + i) & (table_size - 1)],0,255);
+  }
+}
+
+static bool fartherFromCamera(const pair<double,int> & a, const pair<double,int> & b)
+{
+  return a.first > b.first;
+}
+
+void GeneratorScene::render(rgbImage & img, int frame_number, double scene_time, double time)
+{
+  int width = img.getWidth();
+  int height = img.getHeight();
+  updateCache(width,height);
+  updateMarkerImage(TEAM_BLUE);
+  updateMarkerImage(TEAM_YELLOW);
+
+  GroundTruth truth;
+  truth.time = time;
+  truth.frame_number = frame_number;
+  updatePoses(truth,scene_time);
+
+  memcpy(img.getData(),background.getData(),img.getNumBytes());
+
+  //painter's algorithm: draw the objects farthest from the camera first
+  //so that closer ones occlude them.
+  vector<pair<double,int> > order;
+  int n_robots = truth.robots.size();
+  for (int i = 0; i < n_robots; i++) {
+    order.push_back(make_pair(sq(truth.robots[i].x - camera_location.x) + sq(truth.robots[i].y - camera_location.y),i));
+  }
+  for (unsigned int i = 0; i < truth.balls.size(); i++) {
+    order.push_back(make_pair(sq(truth.balls[i].x - camera_location.x) + sq(truth.balls[i].y - camera_location.y),n_robots + i));
+  }
+  sort(order.begin(),order.end(),fartherFromCamera);
+  for (unsigned int i = 0; i < order.size(); i++) {
+    int idx = order[i].second;
+    if (idx < n_robots) {
+      drawRobot(img,truth.robots[idx]);
+    } else {
+      drawBall(img,truth.balls[idx - n_robots]);
+    }
+  }
+
+  if (v_lighting_gradient->getDouble() > 0.0) applyShading(img);
+  if (v_blur->getInt() > 0) applyBlur(img,v_blur->getInt());
+  if (v_noise->getDouble() > 0.0) applyNoise(img,frame_number);
+
+  history.push_back(truth);
+  while (history.size() > max_history) history.pop_front();
+}
+
+bool GeneratorScene::getGroundTruth(double time, GroundTruth & truth) const
+{
+  for (deque<GroundTruth>::const_reverse_iterator it = history.rbegin(); it != history.rend(); ++it) {
+    if (it->time == time) {
+      truth = *it;
+      return true;
+    }
+  }
+  return false;
+}
+
+void GeneratorScene::clearHistory()
+{
+  history.clear();
+}
@@ -0,0 +1,182 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    generator_scene.h
+  \brief   C++ Interface: GeneratorScene
+  \author  Author Name, 2026
+*/
+//========================================================================
+
+#ifndef GENERATOR_SCENE_H
+#define GENERATOR_SCENE_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include "VarTypes.h"
+#include "image.h"
+#include "random.h"
+#include "camera_calibration.h"
+using namespace std;
+
+/*!
+  \class   GeneratorScene
+  \brief   Renders a synthetic view of a RoboCup SSL field for the CaptureGenerator
+
+  Every image pixel is cast as a ray through the scene's own
+  CameraParameters (including radial distortion) and intersected with
+  the field, the robot tops and the balls. Robot tops are sampled from
+  the same multi-pattern marker images the TeamDetector loads (1 pixel
+  = 1 mm, front of the robot pointing up), so the rendered robots carry
+  the real marker layouts of their team.
+
+  All robot and ball poses are a deterministic function of the random
+  seed and the scene time, which makes runs reproducible. The poses of
+  the recently rendered frames are kept as ground truth and can be
+  looked up by the frame's capture time.
+*/
+class GeneratorScene
+{
+public:
+  enum Team {
+    TEAM_BLUE=0,
+    TEAM_YELLOW
+  };
+
+  class RobotPose {
+  public:
+    Team team;
+    int id;
+    double x;
+    double y;
+    double orientation;
+    double height;
+  };
+
+  class BallPose {
+  public:
+    double x;
+    double y;
+    double z;
+  };
+
+  class GroundTruth {
+  public:
+    double time;
+    int frame_number;
+    vector<RobotPose> robots;
+    vector<BallPose> balls;
+  };
+
+protected:
+  class TeamSettings {
+  public:
+    VarList * list;
+    VarString * v_marker_image_file;
+    VarInt * v_marker_image_rows;
+    VarInt * v_marker_image_cols;
+  };
+
+  /// one multi-pattern marker image, split into cells of one robot each
+  class MarkerImage {
+  public:
+    string filename;
+    int rows;
+    int cols;
+    bool valid;
+    rgbImage image;
+    int cell_w;
+    int cell_h;
+    vector<double> center_x;
+    vector<double> center_y;
+    vector<rgb> background;
+  };
+
+  VarList * settings;
+  VarBool * v_enable;
+  VarInt * v_seed;
+  VarInt * v_robots_per_team;
+  VarInt * v_balls;
+  VarDouble * v_robot_height;
+  VarDouble * v_robot_radius;
+  VarDouble * v_ball_radius;
+  VarDouble * v_speed;
+  TeamSettings team_settings[2];
+
+  VarList * field_settings;
+  VarDouble * v_field_length;
+  VarDouble * v_field_width;
+  VarDouble * v_boundary_width;
+  VarDouble * v_line_width;
+  VarDouble * v_center_circle_radius;
+
+  VarList * imaging_settings;
+  VarDouble * v_noise;
+  VarInt * v_blur;
+  VarDouble * v_lighting_gradient;
+
+  VarList * camera_settings;
+  CameraParameters camera;
+  CameraModel camera_model;
+
+  MarkerImage markers[2];
+
+  //per pixel cache, rebuilt whenever the camera, field or image size changes:
+  vector<double> cache_key;
+  int cache_width;
+  int cache_height;
+  GVector::vector3d<double> camera_location;
+  vector<float> ground_x;  //intersection of each pixel's ray with the field plane
+  vector<float> ground_y;
+  vector<unsigned short> shading; //lighting gradient, 256 = unchanged
+  rgbImage background;
+  double visible_min_x, visible_max_x, visible_min_y, visible_max_y;
+
+  double noise_stddev;
+  vector<signed char> noise_table;
+
+  unsigned int max_history;
+  deque<GroundTruth> history;
+
+  void updateCache(int width, int height);
+  void updateMarkerImage(Team team);
+  void updatePoses(GroundTruth & truth, double scene_time);
+  rgb fieldColor(double x, double y) const;
+  bool projectBox(double min_x, double max_x, double min_y, double max_y, double min_z, double max_z,
+                  int width, int height, int & x0, int & y0, int & x1, int & y1) const;
+  void drawRobot(rgbImage & img, const RobotPose & robot) const;
+  void drawBall(rgbImage & img, const BallPose & ball) const;
+  void applyShading(rgbImage & img) const;
+  void applyBlur(rgbImage & img, int radius) const;
+  void applyNoise(rgbImage & img, int frame_number);
+
+public:
+  GeneratorScene(VarList * _settings);
+  ~GeneratorScene();
+
+  bool isEnabled() const;
+  CameraParameters & getCameraParameters();
+
+  /// renders the scene at \p scene_time seconds into \p img and records
+  /// the ground truth of the frame under its capture \p time.
+  void render(rgbImage & img, int frame_number, double scene_time, double time);
+
+  /// the ground truth of the rendered frame with capture time \p time.
+  /// Returns false if no such frame is in the history anymore.
+  bool getGroundTruth(double time, GroundTruth & truth) const;
+  void clearHistory();
+};
+
+#endif
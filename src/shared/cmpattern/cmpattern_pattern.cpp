@@ -191,6 +191,29 @@ void MultiPatternModel::clearPatternModels() {
     patterns[i].reset();
   }
   marker_max_dist=0.0;
+  index.clear();
+}
+
+void MultiPatternModel::calcDerived() {
+  //index every rotation of every enabled pattern by the code a marker set
+  //in that rotation would have, so that findPattern needs a single lookup:
+  index.clear();
+  PatternIndexEntry e;
+  for (int i=0;i<num_patterns;i++) {
+    const Pattern &p = patterns[i];
+    if (!p.enabled) continue;
+    e.num_markers = p.num_markers;
+    e.idx = i;
+    for (int ofs=0; ofs<p.num_markers; ofs++) {
+      e.ofs = ofs;
+      e.pattern = 0x00;
+      for (int j=0; j<p.num_markers; j++) {
+        e.pattern = (e.pattern << 8) | p.markers[(j - ofs + p.num_markers) % p.num_markers].id.v;
+      }
+      index.push_back(e);
+    }
+  }
+  std::sort(index.begin(),index.end());
 }
 
 
@@ -316,6 +339,7 @@ bool MultiPatternModel::loadSinglePatternImage(const yuvImage & image, YUVLUT *
   p.pattern = pattern;
   p.height = height;
   p.robot_id = idx;
+  calcDerived();
 
   //TODO:  a nice feature would be to automatically calculate histogram
   //       percentages here.
@@ -382,43 +406,36 @@ void MultiPatternModel::recheckColorsUsed() {
       }
     }
   }
+  calcDerived();
 }
 
-bool MultiPatternModel::findPattern(PatternDetectionResult & result, Marker * markers,int num_markers, const PatternFitParameters & fit_params,const CameraParameters& camera_params) const {
+bool MultiPatternModel::findPattern(PatternDetectionResult & result, Marker * markers,int num_markers, const PatternFitParameters & fit_params,const CameraModel& camera_model) const {
   if(markers==0 || num_markers<0) return(false);
 
   int best_idx = -1;
   int best_ofs = 0;
   double best_sse = sq(fit_params.fit_max_error);
 
-  for(int ofs=0; ofs<num_markers; ofs++){
-    // calculate pattern code
-    pattern_t pattern = 0x00;
-    for(int i=0; i<num_markers; i++){
-      int j = (i + ofs) % num_markers;
-      pattern = (pattern << 8) | markers[j].id.v;
-    }
+  // calculate pattern code
+  PatternIndexEntry key;
+  key.num_markers = num_markers;
+  key.pattern = 0x00;
+  for(int i=0; i<num_markers; i++){
+    key.pattern = (key.pattern << 8) | markers[i].id.v;
+  }
 
-    // find covers with matching pattern code and number of markers
-    for(int i=0; i<num_patterns; i++){
-      if (patterns[i].enabled) {
-        const Pattern &p = patterns[i];
-        if(p.num_markers==num_markers && p.pattern==pattern){
-          // calculate fit error for matching pattern
-          double sse = calcFitError(p.markers,markers,num_markers,ofs,fit_params);
-//          printf("SSE: %f\n",sse);
-          /*if(unlikely(verbose > 1)){
-            float conf = SSEVsUniform(sse,fit_variance,fit_uniform);
-            printf("    0x%04X id=%X err=%6.3f conf=%0.6f\n",
-                  pattern,rc.robot_id,sqrt(sse),conf);
-          }*/
-          if(sse < best_sse){
-            best_idx = i;
-            best_ofs = ofs;
-            best_sse = sse;
-          }
-        }
-      }
+  // find covers with matching pattern code and number of markers in any
+  // rotation, ordered by rotation and pattern
+  std::pair<vector<PatternIndexEntry>::const_iterator,vector<PatternIndexEntry>::const_iterator> range =
+    std::equal_range(index.begin(),index.end(),key,LessPatternCode());
+  for(vector<PatternIndexEntry>::const_iterator it=range.first; it!=range.second; it++){
+    const Pattern &p = patterns[it->idx];
+    // calculate fit error for matching pattern
+    double sse = calcFitError(p.markers,markers,num_markers,it->ofs,fit_params);
+    if(sse < best_sse){
+      best_idx = it->idx;
+      best_ofs = it->ofs;
+      best_sse = sse;
     }
   }
 
@@ -429,7 +446,7 @@ bool MultiPatternModel::findPattern(PatternDetectionResult & result, Marker * ma
     for(int i=0; i<num_markers; i++){
       vector2d marker_img_center(markers[i].reg->cen_x,markers[i].reg->cen_y);
       vector3d marker_center3d;
-      camera_params.image2field(marker_center3d,marker_img_center,markers[i].height);
+      camera_model.image2field(marker_center3d,marker_img_center,markers[i].height);
       markers[i].loc.set(marker_center3d.x,marker_center3d.y);
     }
 
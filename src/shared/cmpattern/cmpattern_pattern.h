@@ -173,12 +173,37 @@ public:
     }
   };
 protected:
+  /// one rotation of an enabled pattern: a marker set whose code (taken
+  /// in angular order from its first marker) is \p pattern matches
+  /// pattern \p idx when rotated by \p ofs.
+  class PatternIndexEntry {
+  public:
+    int num_markers;
+    pattern_t pattern;
+    int ofs;
+    int idx;
+    bool operator<(const PatternIndexEntry & other) const {
+      if (num_markers != other.num_markers) return num_markers < other.num_markers;
+      if (pattern != other.pattern) return pattern < other.pattern;
+      if (ofs != other.ofs) return ofs < other.ofs;
+      return idx < other.idx;
+    }
+  };
+  class LessPatternCode {
+  public:
+    bool operator()(const PatternIndexEntry & a, const PatternIndexEntry & b) const {
+      if (a.num_markers != b.num_markers) return a.num_markers < b.num_markers;
+      return a.pattern < b.pattern;
+    }
+  };
+
   float     marker_max_dist;
   int       num_patterns;
   Pattern * patterns;
   ColorsUsed used;
+  vector<PatternIndexEntry> index; //all rotations of all enabled patterns, sorted
 protected:
-  void calcDerived();
+  void calcDerived(); //rebuilds the pattern index
   void allocate(int num_patterns);
   double calcFitError(const Marker *model, const Marker *markers, int num_markers, int ofs, const PatternFitParameters & fit_params) const;
 public:
@@ -190,7 +215,7 @@ public:
   bool usesColor(raw8 color_id) const;
   bool loadSinglePatternImage(const yuvImage & image, YUVLUT * _lut,int idx, float default_object_height=0.0);
   bool loadMultiPatternImage(const yuvImage & image, YUVLUT * _lut, int rows=4, int cols=4, float default_object_height=0.0);
-  bool findPattern(PatternDetectionResult & result, Marker * markers,int num_markers, const PatternFitParameters & fit_params,const CameraParameters& camera_params) const;
+  bool findPattern(PatternDetectionResult & result, Marker * markers,int num_markers, const PatternFitParameters & fit_params,const CameraModel& camera_model) const;
   void recheckColorsUsed();//to be used if patterns have been enabled/disabled;
 };
 
@@ -20,6 +20,7 @@
 */
 //========================================================================
 #include "cmpattern_teamdetector.h"
+#include <algorithm>
 
 namespace CMPattern {
 
@@ -55,11 +56,13 @@ Team * TeamDetectorSettings::getTeam(int idx) const {
   return (team_vector[idx]);
 }
 
-TeamDetector::TeamDetector(LUT3D * lut3d, const CameraParameters& camera_params, const RoboCupField& field) : _camera_params(camera_params), _field(field) {
+TeamDetector::TeamDetector(LUT3D * lut3d, const RoboCupField& field) : _camera_model(0), _integral_histogram(0), _field(field) {
   _team=0;
   _lut3d=lut3d;
 
   histogram=0;
+  _label_scale=1;
+  _other_markers_max_query_distance=0.0;
 
   color_id_cyan = _lut3d->getChannelID("Cyan");
   if (color_id_cyan == -1) printf("WARNING color label 'Cyan' not defined in LUT!!!\n");
@@ -175,13 +178,16 @@ TeamDetector::~TeamDetector()
   if (histogram !=0) delete histogram;
 }
 
-void TeamDetector::update(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, int max_robots, const Image<raw8> * image, CMVision::ColorRegionList * colorlist, CMVision::RegionTree & reg_tree) {
+void TeamDetector::update(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, int max_robots, const Image<raw8> * image, const CMVision::ColorRegionList * colorlist, const CMVision::RegionGrid & reg_grid, const CameraModel & camera_model, int label_scale, const CMVision::IntegralHistogram * integral_histogram) {
+  _camera_model=&camera_model;
+  _integral_histogram=(integral_histogram!=0 && integral_histogram->isBuiltFor(image)) ? integral_histogram : 0;
   color_id_team=team_color_id;
+  _label_scale=label_scale;
   _max_robots=max_robots;
   robots->Clear();
 
   if (_unique_patterns) {
-    findRobotsByModel(robots,team_color_id,image,colorlist,reg_tree);
+    findRobotsByModel(robots,team_color_id,image,colorlist,reg_grid);
   } else {
     findRobotsByTeamMarkerOnly(robots,team_color_id,image,colorlist);
   }
@@ -192,18 +198,21 @@ void TeamDetector::update(::google::protobuf::RepeatedPtrField< ::SSL_DetectionR
 
 
 
-void TeamDetector::findRobotsByTeamMarkerOnly(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, const Image<raw8> * image, CMVision::ColorRegionList * colorlist)
+void TeamDetector::findRobotsByTeamMarkerOnly(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, const Image<raw8> * image, const CMVision::ColorRegionList * colorlist)
 {
   filter_team.init( colorlist->getRegionList(team_color_id).getInitialElement() );
 
   //TODO: change these to update on demand:
   //local variables
   const CMVision::Region * reg=0;
-  SSL_DetectionRobot * robot=0;
+  //allow twice as many robots for now...
+  //duplicate filtering will take care of the rest below:
+  candidates.clear(_max_robots*2);
+  RobotCandidate robot;
   while((reg = filter_team.getNext()) != 0) {
     vector2d reg_img_center(reg->cen_x,reg->cen_y);
     vector3d reg_center3d;
-    _camera_params.image2field(reg_center3d,reg_img_center,_robot_height);
+    _camera_model->image2field(reg_center3d,reg_img_center,_robot_height);
     vector2d reg_center(reg_center3d.x,reg_center3d.y);
 
     //TODO: add confidence masking:
@@ -222,38 +231,29 @@ void TeamDetector::findRobotsByTeamMarkerOnly(::google::protobuf::RepeatedPtrFie
       }
       if(det.debug) det.color(reg,rc,conf);*/
 
-      //allow twice as many robots for now...
-      //duplicate filtering will take care of the rest below:
-      robot=addRobot(robots,conf,_max_robots*2);
-
-      if (robot!=0) {
-        //setup robot:
-        robot->set_x(reg_center.x);
-        robot->set_y(reg_center.y);
-        robot->set_pixel_x(reg->cen_x);
-        robot->set_pixel_y(reg->cen_y);
-        robot->set_height(_robot_height);
-      }
+      robot.conf=conf;
+      robot.x=reg_center.x;
+      robot.y=reg_center.y;
+      robot.pixel_x=reg->cen_x;
+      robot.pixel_y=reg->cen_y;
+      robot.height=_robot_height;
+      candidates.add(robot);
     }
   }
+  candidates.sort();
 
   // remove duplicates ... keep the ones with higher confidence:
-  int size=robots->size();
+  int size=candidates.size();
   for(int i=0; i<size; i++){
     for(int j=i+1; j<size; j++){
-      if(sqdist(vector2d(robots->Get(i).x(),robots->Get(i).y()),vector2d(robots->Get(j).x(),robots->Get(j).y())) < sq(_center_marker_duplicate_distance)) {
-        robots->Mutable(i)->set_confidence(0.0);
+      if(sqdist(vector2d(candidates[i].x,candidates[i].y),vector2d(candidates[j].x,candidates[j].y)) < sq(_center_marker_duplicate_distance)) {
+        candidates[i].conf=0.0;
       }
     }
   }
 
-  //remove items with 0-confidence:
-  stripRobots(robots);
-
-  //remove extra items:
-  while(robots->size() > _max_robots) {
-    robots->RemoveLast();
-  }
+  //write all but the 0-confidence and extra items:
+  candidates.write(robots,_max_robots);
 
 }
 
@@ -268,8 +268,8 @@ double TeamDetector::getRegionArea(const CMVision::Region * reg, double z) const
   vector3d a,b;
   vector2d right(reg->x2+1,reg->y2+1);
   vector2d left(reg->x1,reg->y1);
-  _camera_params.image2field(a,right,z);
-  _camera_params.image2field(b,left,z);
+  _camera_model->image2field(a,right,z);
+  _camera_model->image2field(b,left,z);
   vector3d box = a-b;
 
   double box_area = fabs(box.x) * fabs(box.y);
@@ -290,8 +290,14 @@ bool TeamDetector::checkHistogram(const CMVision::Region * reg, const Image<raw8
 
   int ix = (int)(reg->cen_x);
   int iy = (int)(reg->cen_y);
-  int num = histogram->addBox(image,ix-_histogram_pixel_scan_radius,iy-_histogram_pixel_scan_radius,
-              ix+_histogram_pixel_scan_radius,iy+_histogram_pixel_scan_radius);
+  int num;
+  if (_integral_histogram!=0) {
+    num = histogram->addBox(*_integral_histogram,ix-_histogram_pixel_scan_radius,iy-_histogram_pixel_scan_radius,
+              ix+_histogram_pixel_scan_radius,iy+_histogram_pixel_scan_radius,_label_scale);
+  } else {
+    num = histogram->addBox(image,ix-_histogram_pixel_scan_radius,iy-_histogram_pixel_scan_radius,
+              ix+_histogram_pixel_scan_radius,iy+_histogram_pixel_scan_radius,_label_scale);
+  }
 
   float inv_num = 1.0 / num;
 
@@ -351,72 +357,65 @@ bool TeamDetector::checkHistogram(const CMVision::Region * reg, const Image<raw8
 }
 
 
-SSL_DetectionRobot * TeamDetector::addRobot(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, double conf, int max_robots) {
+RobotCandidateList::RobotCandidateList()
+{
+  capacity=0;
+  next_order=0;
+  sorted=false;
+}
 
-  int size=robots->size();
-  SSL_DetectionRobot * result_robot = 0;
-  for (int i=0;i<size;i++) {
-    if (robots->Get(i).confidence() < conf) {
-      //allocate new robot at end of array
-      //and shift everything down by 1...making room for newly inserted item.
-      if (size < max_robots) {
-        //we can expand the array by 1.
-        robots->Add();
-        size++;
-      }
-      for (int j=size-1; j>i; j--) {
-        (*(robots->Mutable(j)))=robots->Get(j-1);
-      }
-      result_robot = robots->Mutable(i);
-      result_robot->Clear();
-      result_robot->set_confidence(conf);
+void RobotCandidateList::clear(int _capacity) {
+  capacity=max(_capacity,0);
+  next_order=0;
+  sorted=false;
+  candidates.clear();
+  candidates.reserve(capacity);
+}
 
-      return result_robot;
-    }
+bool RobotCandidateList::add(const RobotCandidate & candidate) {
+  RobotCandidate c=candidate;
+  c.order=next_order++;
+  if ((int)candidates.size() < capacity) {
+    candidates.push_back(c);
+    push_heap(candidates.begin(),candidates.end());
+    return true;
   }
-  if (size < max_robots) {
-    result_robot = robots->Add();
-    result_robot->set_confidence(conf);
-  }
-  return result_robot;
+  //the top of the heap is the lowest ranking candidate:
+  if (capacity==0 || !(c < candidates.front())) return false;
+  pop_heap(candidates.begin(),candidates.end());
+  candidates.back()=c;
+  push_heap(candidates.begin(),candidates.end());
+  return true;
 }
 
+void RobotCandidateList::sort() {
+  if (!sorted) sort_heap(candidates.begin(),candidates.end());
+  sorted=true;
+}
 
-void TeamDetector::stripRobots(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots) {
-  int size=robots->size();
-
-  int tgt=0;
-  for (int src=0;src<size;src++) {
-    if (robots->Get(src).confidence() != 0.0) {
-      if (tgt!=src) {
-        //copy operation is needed:
-        (*(robots->Mutable(tgt)))=robots->Get(src);
-      }
-      tgt++;
-    }
-  }
-  for (int i=tgt;i<size;i++) {
-    robots->RemoveLast();
+void RobotCandidateList::write(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int max_robots) const {
+  for (unsigned int i=0;i<candidates.size() && robots->size() < max_robots;i++) {
+    const RobotCandidate & c=candidates[i];
+    if (c.conf == 0.0) continue;
+    SSL_DetectionRobot * robot=robots->Add();
+    robot->set_confidence(c.conf);
+    robot->set_x(c.x);
+    robot->set_y(c.y);
+    if (c.have_orientation) robot->set_orientation(c.orientation);
+    if (c.id >= 0) robot->set_robot_id(c.id);
+    robot->set_pixel_x(c.pixel_x);
+    robot->set_pixel_y(c.pixel_y);
+    robot->set_height(c.height);
   }
 }
 
-
-
-
-
-
-
-
-
-
-
-void TeamDetector::findRobotsByModel(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, const Image<raw8> * image, CMVision::ColorRegionList * colorlist, CMVision::RegionTree & reg_tree)
+void TeamDetector::findRobotsByModel(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, const Image<raw8> * image, const CMVision::ColorRegionList * colorlist, const CMVision::RegionGrid & reg_grid)
 {
 
   (void)image;
   const int MaxDetections = _other_markers_max_detections;
   Marker cen; // center marker
-  Marker *markers = new Marker[MaxDetections];
+  markers.resize(max(MaxDetections,1));
   const float marker_max_query_dist = _other_markers_max_query_distance;
   const float marker_max_dist = _pattern_max_dist;
 
@@ -425,14 +424,15 @@ void TeamDetector::findRobotsByModel(::google::protobuf::RepeatedPtrField< ::SSL
 
   filter_team.init( colorlist->getRegionList(team_color_id).getInitialElement());
   const CMVision::Region * reg=0;
-  SSL_DetectionRobot * robot=0;
+  candidates.clear(_max_robots*2);
+  RobotCandidate robot;
 
   MultiPatternModel::PatternDetectionResult res;
 
   while((reg = filter_team.getNext()) != 0) {
     vector2d reg_img_center(reg->cen_x,reg->cen_y);
     vector3d reg_center3d;
-    _camera_params.image2field(reg_center3d,reg_img_center,_robot_height);
+    _camera_model->image2field(reg_center3d,reg_img_center,_robot_height);
     vector2d reg_center(reg_center3d.x,reg_center3d.y);
     //TODO add masking:
     //if(det.mask.get(reg->cen_x,reg->cen_y) >= 0.5){
@@ -440,17 +440,16 @@ void TeamDetector::findRobotsByModel(::google::protobuf::RepeatedPtrField< ::SSL
       cen.set(reg,reg_center3d,getRegionArea(reg,_robot_height));
       int num_markers = 0;
 
-      reg_tree.startQuery(*reg,marker_max_query_dist);
-      double sd=0.0;
-      CMVision::Region *mreg;
-      while((mreg=reg_tree.getNextNearest(sd))!=0 && num_markers<MaxDetections) {
+      reg_grid.query(reg->cen_x,reg->cen_y,marker_max_query_dist,neighbors);
+      for(unsigned int k=0; k<neighbors.size() && num_markers<MaxDetections; k++) {
+        CMVision::Region *mreg=neighbors[k].reg;
         //TODO: implement masking:
         // filter_other.check(*mreg) && det.mask.get(mreg->cen_x,mreg->cen_y)>=0.5
 
         if(filter_others.check(*mreg) && model.usesColor(mreg->color)) {
           vector2d marker_img_center(mreg->cen_x,mreg->cen_y);
           vector3d marker_center3d;
-          _camera_params.image2field(marker_center3d,marker_img_center,_robot_height);
+          _camera_model->image2field(marker_center3d,marker_img_center,_robot_height);
           Marker &m = markers[num_markers];
 
           m.set(mreg,marker_center3d,getRegionArea(mreg,_robot_height));
@@ -463,10 +462,9 @@ void TeamDetector::findRobotsByModel(::google::protobuf::RepeatedPtrField< ::SSL
           }
         }
       }
-      reg_tree.endQuery();
 
       if(num_markers >= 2){
-        CMPattern::PatternProcessing::sortMarkersByAngle(markers,num_markers);
+        CMPattern::PatternProcessing::sortMarkersByAngle(&markers[0],num_markers);
         for(int i=0; i<num_markers; i++){
           /*DEBUG CODE:
           char colorchar='?';
@@ -482,31 +480,26 @@ void TeamDetector::findRobotsByModel(::google::protobuf::RepeatedPtrField< ::SSL
           markers[i].next_angle_dist = angle_pos(angle_diff(markers[i].angle,markers[j].angle));
         }
 
-        if (model.findPattern(res,markers,num_markers,_pattern_fit_params,_camera_params)) {
-              robot=addRobot(robots,res.conf,_max_robots*2);
-              if (robot!=0) {
-                //setup robot:
-                robot->set_x(cen.loc.x);
-                robot->set_y(cen.loc.y);
-                if (_have_angle) robot->set_orientation(res.angle);
-                robot->set_robot_id(res.id);
-                robot->set_pixel_x(reg->cen_x);
-                robot->set_pixel_y(reg->cen_y);
-                robot->set_height(cen.height);
-              }
+        if (model.findPattern(res,&markers[0],num_markers,_pattern_fit_params,*_camera_model)) {
+              robot.conf=res.conf;
+              robot.x=cen.loc.x;
+              robot.y=cen.loc.y;
+              robot.have_orientation=_have_angle;
+              robot.orientation=res.angle;
+              robot.id=res.id;
+              robot.pixel_x=reg->cen_x;
+              robot.pixel_y=reg->cen_y;
+              robot.height=cen.height;
+              candidates.add(robot);
         }
       }
     }
   }
-  //remove items with 0-confidence:
-  stripRobots(robots);
+  candidates.sort();
 
-  //remove extra items:
-  while(robots->size() > _max_robots) {
-    robots->RemoveLast();
-  }
+  //write all but the 0-confidence and extra items:
+  candidates.write(robots,_max_robots);
 
-  delete[] markers;
 }
 
 
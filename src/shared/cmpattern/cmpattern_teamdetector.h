@@ -33,6 +33,7 @@
 #include "field_filter.h"
 #include "vis_util.h"
 #include "cmvision_histogram.h"
+#include "cmvision_regiongrid.h"
 #include <string.h>
 #include <vector>
 #include <QObject>
@@ -147,17 +148,85 @@ public:
 
 
 
+/// a detected robot before it is written to the detection frame
+class RobotCandidate {
+public:
+  double conf;
+  int order; //insertion order, the earlier of two equally confident candidates wins
+  //as in SSL_DetectionRobot:
+  float x;
+  float y;
+  float pixel_x;
+  float pixel_y;
+  float height;
+  float orientation;
+  bool have_orientation;
+  int id; //-1 if unknown
+
+  RobotCandidate() : conf(0.0), order(0), x(0.0f), y(0.0f), pixel_x(0.0f), pixel_y(0.0f),
+                     height(0.0f), orientation(0.0f), have_orientation(false), id(-1) {}
+
+  /// whether this candidate ranks before \p other
+  bool operator<(const RobotCandidate & other) const {
+    if (conf != other.conf) return conf > other.conf;
+    return order < other.order;
+  }
+};
+
+/*!
+  \class   RobotCandidateList
+  \brief   Keeps the most confident robot candidates of a frame
+
+  The candidates are kept in a binary heap with the lowest ranking one
+  on top. Once the capacity is reached, a new candidate only replaces
+  that one if it ranks higher, so adding costs O(log capacity) no matter
+  how many team markers a frame has. The result is the same as keeping
+  a list sorted by descending confidence, with ties in insertion order,
+  and cutting it off at the capacity.
+*/
+class RobotCandidateList {
+protected:
+  vector<RobotCandidate> candidates;
+  int capacity;
+  int next_order;
+  bool sorted;
+public:
+  RobotCandidateList();
+
+  /// empties the list and sets the number of candidates to keep
+  void clear(int _capacity);
+  /// returns false if the candidate did not rank high enough to be kept
+  bool add(const RobotCandidate & candidate);
+  /// orders the kept candidates by rank; add() must not be called afterwards
+  void sort();
+
+  int size() const {
+    return candidates.size();
+  }
+  /// the i-th ranked candidate, valid after sort()
+  RobotCandidate & operator[](int i) {
+    return candidates[i];
+  }
+
+  /// writes up to \p max_robots candidates with a nonzero confidence, in rank order
+  void write(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int max_robots) const;
+};
+
 class TeamDetector {
 protected:
 
   //TeamDetectorSettings * _detector_settings;
 
-  const CameraParameters& _camera_params;
+  const CameraModel * _camera_model; //snapshot of the frame being processed
+  const CMVision::IntegralHistogram * _integral_histogram; //of the frame's labels, if any
   const RoboCupField& _field;
   Team * _team;
   LUT3D * _lut3d;
   FieldFilter field_filter;
   MultiPatternModel model;
+  vector<CMVision::RegionGrid::Neighbor> neighbors; //marker query results
+  vector<Marker> markers; //markers found around a team marker
+  RobotCandidateList candidates;
 
   //-----TEAM CONFIG---------
   CMVision::RegionFilter filter_team;
@@ -181,6 +250,7 @@ protected:
 
   bool  _histogram_enable;
   int    _histogram_pixel_scan_radius;
+  int    _label_scale; //ratio between video and color-labeled image resolution
 
   ClosedRangeFloat _histogram_markeryness;
   ClosedRangeFloat _histogram_field_greenness;
@@ -205,15 +275,8 @@ protected:
     double getRegionArea(const CMVision::Region * reg, double z) const;
     bool checkHistogram(const CMVision::Region * reg, const Image<raw8> * image);
 
-    //returns a mutable pointer if the add was successful
-    //returns 0 if there already are max_robots with higher confidence than conf
-    SSL_DetectionRobot * addRobot(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, double conf, int max_robots);
-
-    //remove anything with a confidence of 0:
-    void stripRobots(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots);
-
 public:
-    TeamDetector(LUT3D * lut3d, const CameraParameters& camera_params, const RoboCupField& field);
+    TeamDetector(LUT3D * lut3d, const RoboCupField& field);
 
     virtual ~TeamDetector();
 
@@ -224,11 +287,16 @@ public:
 
     void init(Team * team);
 
-    void findRobotsByModel(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, const Image<raw8> * image, CMVision::ColorRegionList * colorlist, CMVision::RegionTree & reg_tree);
+    /// the distance in pixels within which markers are searched around a team marker
+    double getMarkerQueryDistance() const {
+      return _other_markers_max_query_distance;
+    }
+
+    void findRobotsByModel(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, const Image<raw8> * image, const CMVision::ColorRegionList * colorlist, const CMVision::RegionGrid & reg_grid);
 
-    void findRobotsByTeamMarkerOnly(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, const Image<raw8> * image, CMVision::ColorRegionList * colorlist);
+    void findRobotsByTeamMarkerOnly(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, const Image<raw8> * image, const CMVision::ColorRegionList * colorlist);
 
-    void update(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, int max_robots, const Image<raw8> * image, CMVision::ColorRegionList * colorlist, CMVision::RegionTree & reg_tree);
+    void update(::google::protobuf::RepeatedPtrField< ::SSL_DetectionRobot >* robots, int team_color_id, int max_robots, const Image<raw8> * image, const CMVision::ColorRegionList * colorlist, const CMVision::RegionGrid & reg_grid, const CameraModel & camera_model, int label_scale=1, const CMVision::IntegralHistogram * integral_histogram=0);
 };
 
 }
@@ -35,11 +35,18 @@ void Histogram::clear() {
   }
 }
 
-int Histogram::addBox(const Image<raw8> * image, int x1, int y1, int x2, int y2) {
+int Histogram::addBox(const Image<raw8> * image, int x1, int y1, int x2, int y2, int scale) {
   raw8 * data = image->getPixelData();
   int image_width = image->getWidth();
   int image_height = image->getHeight();
 
+  if (scale > 1) {
+    x1 /= scale;
+    y1 /= scale;
+    x2 /= scale;
+    y2 /= scale;
+  }
+
   x1 = bound(x1,0,image_width-1);
   y1 = bound(y1,0,image_height-1);
   x2 = bound(x2,0,image_width-1);
@@ -54,6 +61,27 @@ int Histogram::addBox(const Image<raw8> * image, int x1, int y1, int x2, int y2)
   return((x2 - x1 + 1) * (y2 - y1 + 1));
 }
 
+int Histogram::addBox(const IntegralHistogram & integral, int x1, int y1, int x2, int y2, int scale) {
+  if (scale > 1) {
+    x1 /= scale;
+    y1 /= scale;
+    x2 /= scale;
+    y2 /= scale;
+  }
+
+  x1 = bound(x1,0,integral.getWidth()-1);
+  y1 = bound(y1,0,integral.getHeight()-1);
+  x2 = bound(x2,0,integral.getWidth()-1);
+  y2 = bound(y2,0,integral.getHeight()-1);
+
+  int n = min(max_channels,integral.getNumChannels());
+  for (int c=0; c<n; c++) {
+    channels[c]+=integral.getCount(c,x1,y1,x2,y2);
+  }
+
+  return((x2 - x1 + 1) * (y2 - y1 + 1));
+}
+
 int Histogram::getChannel(int channel) {
   return channels[channel];
 }
@@ -67,5 +95,50 @@ Histogram::~Histogram()
   delete[] channels;
 }
 
+IntegralHistogram::IntegralHistogram()
+{
+  num_channels=0;
+  width=0;
+  height=0;
+}
+
+void IntegralHistogram::clear() {
+  width=0;
+  height=0;
+}
+
+void IntegralHistogram::build(const Image<raw8> * image, int _num_channels) {
+  if (_num_channels < 1) _num_channels=1;
+  num_channels=_num_channels;
+  width=image->getWidth();
+  height=image->getHeight();
+  const int stride=(width+1)*num_channels;
+  sums.resize((height+1)*stride);
+  row.resize(num_channels);
+
+  //the top row and the left column of nodes stay zero:
+  for (int i=0; i<stride; i++) sums[i]=0;
+
+  const raw8 * data = image->getPixelData();
+  for (int y=0; y<height; y++) {
+    const int * above=&sums[y*stride];
+    int * node=&sums[(y+1)*stride];
+    for (int c=0; c<num_channels; c++) {
+      node[c]=0;
+      row[c]=0;
+    }
+    const raw8 * pixel=&data[y*width];
+    for (int x=0; x<width; x++) {
+      int label=pixel[x].v;
+      if (label < num_channels) row[label]++;
+      above+=num_channels;
+      node+=num_channels;
+      for (int c=0; c<num_channels; c++) {
+        node[c]=above[c]+row[c];
+      }
+    }
+  }
+}
+
 };
 
@@ -21,9 +21,55 @@
 #ifndef CMVISION_HISTOGRAM_H
 #define CMVISION_HISTOGRAM_H
 #include "image.h"
+#include <vector>
 
 namespace CMVision {
 
+/**
+  Per-channel prefix counts (summed-area tables) of a color-labeled image.
+  Once built for a frame, the histogram of any box of that image takes
+  four lookups per channel instead of a scan of the box.
+  The counts of all channels are stored interleaved per node, so a box
+  query touches only four memory locations.
+*/
+class IntegralHistogram{
+protected:
+    std::vector<int> sums; //(width+1)*(height+1) nodes of num_channels counts
+    std::vector<int> row;
+    int num_channels;
+    int width;
+    int height;
+public:
+    IntegralHistogram();
+
+    //computes the prefix counts of all labels below _num_channels;
+    //other labels are not counted.
+    void build(const Image<raw8> * image, int _num_channels);
+    //marks the tables as not belonging to any image.
+    void clear();
+    //whether the tables were built from an image of this size.
+    bool isBuiltFor(const Image<raw8> * image) const {
+      return image!=0 && width>0 && image->getWidth()==width && image->getHeight()==height;
+    }
+    int getNumChannels() const {
+      return num_channels;
+    }
+    int getWidth() const {
+      return width;
+    }
+    int getHeight() const {
+      return height;
+    }
+    //count of the label channel within the (inclusive) image box, which
+    //has to lie inside the image.
+    int getCount(int channel, int x1, int y1, int x2, int y2) const {
+      const int stride=(width+1)*num_channels;
+      const int * top=&sums[y1*stride+channel];
+      const int * bottom=&sums[(y2+1)*stride+channel];
+      return bottom[(x2+1)*num_channels] - bottom[x1*num_channels] - top[(x2+1)*num_channels] + top[x1*num_channels];
+    }
+};
+
 class Histogram{
 protected:
     int * channels;
@@ -34,7 +80,10 @@ public:
 
     //will sample a rectangular bounding box of a color-labeled image and add it to the histogram
     //the return value is the area of the box.
-    int addBox(const Image<raw8> * image, int x1, int y1, int x2, int y2);
+    //scale is the ratio between the box coordinates and the image resolution
+    int addBox(const Image<raw8> * image, int x1, int y1, int x2, int y2, int scale=1);
+    //same as above, but reads the counts from the integral histogram of the image.
+    int addBox(const IntegralHistogram & integral, int x1, int y1, int x2, int y2, int scale=1);
     int getChannel(int channel);
     void setChannel(int channel, int value);
     void clear();
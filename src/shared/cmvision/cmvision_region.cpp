@@ -34,7 +34,7 @@ RegionProcessing::~RegionProcessing()
 }
 
 
-void RegionProcessing::encodeRuns(Image<raw8> * tmap, CMVision::RunList * runlist)
+void RegionProcessing::encodeRuns(Image<raw8> * tmap, CMVision::RunList * runlist, const CMVision::ROIList * rois)
 // Changes the flat array version of the thresholded image into a run
 // length encoded version, which speeds up later processing since we
 // only have to look at the points where values change.
@@ -61,6 +61,20 @@ void RegionProcessing::encodeRuns(Image<raw8> * tmap, CMVision::RunList * runlis
 
     r.y = y;
 
+    if (rois!=0 && !rois->isRowCovered(y)) {
+      //same single clear run as a scan of the empty row would give:
+      r.x = 0;
+      r.color = clear;
+      r.width = width;
+      r.parent = j;
+      runs[j++] = r;
+      if(j >= max_runs){
+        runlist->setUsedRuns(j);
+        return;
+      }
+      continue;
+    }
+
     x = 0;
     while(x < width){
       m = row[x];
@@ -247,6 +261,26 @@ void RegionProcessing::extractRegions(CMVision::RegionList * reglist, CMVision::
 
 
 
+void RegionProcessing::scaleRegions(CMVision::RegionList * reglist, int scale)
+// Each label pixel covers scale x scale source pixels. Bounding boxes
+// are grown to cover all of them, centroids are moved to the center of
+// the covered block.
+{
+  if (scale <= 1) return;
+  CMVision::Region * reg = reglist->getRegionArrayPointer();
+  int n = reglist->getUsedRegions();
+  float offset = (scale - 1) * 0.5f;
+  for (int i=0; i<n; i++) {
+    reg[i].x1 *= scale;
+    reg[i].y1 *= scale;
+    reg[i].x2 = reg[i].x2 * scale + scale - 1;
+    reg[i].y2 = reg[i].y2 * scale + scale - 1;
+    reg[i].cen_x = reg[i].cen_x * scale + offset;
+    reg[i].cen_y = reg[i].cen_y * scale + offset;
+    reg[i].area *= scale * scale;
+  }
+}
+
 int RegionProcessing::separateRegions(CMVision::ColorRegionList * colorlist, CMVision::RegionList * reglist, int min_area)
 // Splits the various regions in the region table a separate list for
 // each color.  The lists are threaded through the table using the
@@ -420,7 +454,13 @@ void ImageProcessor::processYUV444(const ImageInterface * image, int min_blob_ar
   processThresholded(img_thresholded,min_blob_area);
 }
 
-void ImageProcessor::processThresholded(Image<raw8> * _img_thresholded, int min_blob_area) {
+void ImageProcessor::processBayerQuads(const RawImage * image, Bayer::Pattern pattern, int min_blob_area) {
+  img_thresholded->allocate(image->getWidth()/2,image->getHeight()/2);
+  CMVisionThreshold::thresholdImageBayerQuads(img_thresholded,image,lut,pattern);
+  processThresholded(img_thresholded,min_blob_area,2);
+}
+
+void ImageProcessor::processThresholded(Image<raw8> * _img_thresholded, int min_blob_area, int label_scale) {
   CMVision::RegionProcessing::encodeRuns(_img_thresholded, runlist);
   if (runlist->getUsedRuns() == runlist->getMaxRuns()) {
     printf("Warning: runlength encoder exceeded current max run size of %d\n",runlist->getMaxRuns());
@@ -435,6 +475,8 @@ void ImageProcessor::processThresholded(Image<raw8> * _img_thresholded, int min_
     printf("Warning: extract regions exceeded maximum number of %d regions\n",reglist->getMaxRegions());
   }
 
+  CMVision::RegionProcessing::scaleRegions(reglist, label_scale);
+
   //Separate Regions by colors:
   int max_area = CMVision::RegionProcessing::separateRegions(colorlist, reglist, min_blob_area);
 
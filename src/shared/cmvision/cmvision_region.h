@@ -294,9 +294,12 @@ public:
 
     ~RegionProcessing();
 
-    static void encodeRuns(Image<raw8> * tmap, CMVision::RunList * runlist);
+    //if rois are given, rows outside their windows are known to be clear and are not scanned:
+    static void encodeRuns(Image<raw8> * tmap, CMVision::RunList * runlist, const CMVision::ROIList * rois=0);
     static void connectComponents(CMVision::RunList * runlist);
     static void extractRegions(CMVision::RegionList * reglist, CMVision::RunList * runlist);
+    //maps regions found in a reduced-resolution label image back to full resolution:
+    static void scaleRegions(CMVision::RegionList * reglist, int scale);
     //returns the max area found:
     static int  separateRegions(CMVision::ColorRegionList * colorlist, CMVision::RegionList * reglist, int min_area);
 
@@ -322,7 +325,8 @@ public:
   ~ImageProcessor();
   void processYUV422_UYVY(const RawImage * image, int min_blob_area);
   void processYUV444(const ImageInterface * image, int min_blob_area);
-  void processThresholded(Image<raw8> * _img_thresholded, int min_blob_area);
+  void processBayerQuads(const RawImage * image, Bayer::Pattern pattern, int min_blob_area);
+  void processThresholded(Image<raw8> * _img_thresholded, int min_blob_area, int label_scale=1);
   ColorRegionList * getColorRegionList();
 };
 
@@ -0,0 +1,126 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    cmvision_regiongrid.cpp
+  \brief   C++ Implementation: cmvision_regiongrid
+  \author  Author Name, 2026
+*/
+//========================================================================
+#include "cmvision_regiongrid.h"
+#include <math.h>
+#include <algorithm>
+
+namespace CMVision {
+
+RegionGrid::RegionGrid()
+{
+  cell_size=1.0;
+  inv_cell_size=1.0;
+  min_x=min_y=0.0;
+  cols=rows=0;
+}
+
+void RegionGrid::clear()
+{
+  added.clear();
+  regions.clear();
+  cols=rows=0;
+}
+
+void RegionGrid::add(Region * reg)
+{
+  added.push_back(reg);
+}
+
+void RegionGrid::build(float _cell_size)
+{
+  //keep the grid at a sane size, even for tiny query distances:
+  cell_size=std::max(_cell_size,4.0f);
+  inv_cell_size=1.0f/cell_size;
+  int n=(int)added.size();
+  regions.resize(n);
+  if (n==0) {
+    cols=rows=0;
+    return;
+  }
+
+  float max_x, max_y;
+  min_x=max_x=added[0]->cen_x;
+  min_y=max_y=added[0]->cen_y;
+  for (int i=1;i<n;i++) {
+    const Region * reg=added[i];
+    if (reg->cen_x < min_x) min_x=reg->cen_x;
+    if (reg->cen_x > max_x) max_x=reg->cen_x;
+    if (reg->cen_y < min_y) min_y=reg->cen_y;
+    if (reg->cen_y > max_y) max_y=reg->cen_y;
+  }
+  cols=(int)((max_x-min_x)*inv_cell_size)+1;
+  rows=(int)((max_y-min_y)*inv_cell_size)+1;
+
+  //counting sort: count the regions per cell, turn the counts into
+  //start offsets, then drop every region into its cell's next slot.
+  int num_cells=cols*rows;
+  cell_start.assign(num_cells+1,0);
+  added_cell.resize(n);
+  for (int i=0;i<n;i++) {
+    int cx=(int)((added[i]->cen_x-min_x)*inv_cell_size);
+    int cy=(int)((added[i]->cen_y-min_y)*inv_cell_size);
+    int cell=cy*cols+cx;
+    added_cell[i]=cell;
+    cell_start[cell+1]++;
+  }
+  for (int c=0;c<num_cells;c++) {
+    cell_start[c+1]+=cell_start[c];
+  }
+  for (int i=0;i<n;i++) {
+    regions[cell_start[added_cell[i]]++]=added[i];
+  }
+  //the placement advanced every start to the next cell's start:
+  for (int c=num_cells;c>0;c--) {
+    cell_start[c]=cell_start[c-1];
+  }
+  cell_start[0]=0;
+}
+
+void RegionGrid::query(float x, float y, float max_dist, std::vector<Neighbor> & result) const
+{
+  result.clear();
+  if (cols==0) return;
+  int cx0=std::max(0,(int)floorf((x-max_dist-min_x)*inv_cell_size));
+  int cx1=std::min(cols-1,(int)floorf((x+max_dist-min_x)*inv_cell_size));
+  int cy0=std::max(0,(int)floorf((y-max_dist-min_y)*inv_cell_size));
+  int cy1=std::min(rows-1,(int)floorf((y+max_dist-min_y)*inv_cell_size));
+  if (cx0 > cx1 || cy0 > cy1) return;
+  float max_dist_sq=max_dist*max_dist;
+  Neighbor n;
+  for (int cy=cy0;cy<=cy1;cy++) {
+    //the cells of one row are adjacent in the region array:
+    int end=cell_start[cy*cols+cx1+1];
+    for (int i=cell_start[cy*cols+cx0];i<end;i++) {
+      Region * reg=regions[i];
+      float dx=reg->cen_x-x;
+      float dy=reg->cen_y-y;
+      float d_sq=dx*dx+dy*dy;
+      if (d_sq < max_dist_sq) {
+        n.reg=reg;
+        n.dist=sqrtf(d_sq);
+        result.push_back(n);
+      }
+    }
+  }
+  std::sort(result.begin(),result.end());
+}
+
+}
@@ -0,0 +1,85 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    cmvision_regiongrid.h
+  \brief   C++ Interface: cmvision_regiongrid
+  \author  Author Name, 2026
+*/
+//========================================================================
+#ifndef CMVISION_REGIONGRID_H
+#define CMVISION_REGIONGRID_H
+#include <vector>
+#include "cmvision_region.h"
+
+namespace CMVision {
+
+/*!
+  \class   RegionGrid
+  \brief   A uniform bucket grid over region centroids for radius queries
+
+  Regions are collected with add() and then sorted into square image
+  cells by a single counting-sort pass in build(), so each cell's
+  regions are contiguous in one flat array. A query only visits the
+  cells overlapping the query circle. With the cell size set to the
+  typical query radius, that is at most 3x3 cells.
+
+  Unlike the RegionTree, building needs no allocations once the arrays
+  have grown to the frame's region count. Queries are const, so several
+  threads can query the same grid at once.
+*/
+class RegionGrid {
+public:
+  class Neighbor {
+  public:
+    Region * reg;
+    float dist;
+    bool operator<(const Neighbor & other) const {
+      return dist < other.dist;
+    }
+  };
+
+protected:
+  float cell_size;
+  float inv_cell_size;
+  float min_x;
+  float min_y;
+  int cols;
+  int rows;
+  std::vector<Region *> added;
+  std::vector<int> added_cell;
+  std::vector<int> cell_start; //cols*rows+1 offsets into regions
+  std::vector<Region *> regions; //all regions, ordered by cell
+
+public:
+  RegionGrid();
+
+  void clear();
+  void add(Region * reg);
+  /// sorts all added regions into cells of \p _cell_size pixels
+  void build(float _cell_size);
+
+  /// all regions whose centroid is closer than \p max_dist to (x,y),
+  /// ordered by ascending distance. Any \p max_dist works, but queries
+  /// are fastest if it is close to the cell size.
+  void query(float x, float y, float max_dist, std::vector<Neighbor> & result) const;
+
+  int size() const {
+    return (int)regions.size();
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    cmvision_roi.cpp
+  \brief   C++ Implementation: cmvision_roi
+  \author  Author Name, 2026
+*/
+//========================================================================
+#include "cmvision_roi.h"
+#include <algorithm>
+
+namespace CMVision {
+
+ROIList::ROIList()
+{
+  full_frame=true;
+}
+
+void ROIList::setFullFrame() {
+  full_frame=true;
+  requested.clear();
+  windows.clear();
+  row_covered.clear();
+}
+
+void ROIList::clear() {
+  full_frame=false;
+  requested.clear();
+  windows.clear();
+  row_covered.clear();
+}
+
+void ROIList::add(int x1, int y1, int x2, int y2) {
+  full_frame=false;
+  requested.push_back(ImageROI(std::min(x1,x2),std::min(y1,y2),std::max(x1,x2),std::max(y1,y2)));
+}
+
+void ROIList::mapToImage(int width, int height, int scale) {
+  windows.clear();
+  row_covered.clear();
+  if (full_frame) return;
+  if (scale < 1) scale=1;
+  row_covered.resize(std::max(height,0),0);
+  for (unsigned int i=0;i<requested.size();i++) {
+    const ImageROI & r=requested[i];
+    ImageROI w(r.x1 / scale, r.y1 / scale, r.x2 / scale, r.y2 / scale);
+    w.x1=std::max(w.x1 & ~1, 0);
+    w.y1=std::max(w.y1, 0);
+    w.x2=std::min(w.x2 | 1, width - 1);
+    w.y2=std::min(w.y2, height - 1);
+    if (w.x1 > w.x2 || w.y1 > w.y2) continue;
+    windows.push_back(w);
+    for (int y=w.y1;y<=w.y2;y++) row_covered[y]=1;
+  }
+}
+
+int ROIList::getCoveredPixels() const {
+  int n=0;
+  for (unsigned int i=0;i<windows.size();i++) n+=windows[i].getArea();
+  return n;
+}
+
+}
@@ -0,0 +1,94 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    cmvision_roi.h
+  \brief   C++ Interface: cmvision_roi
+  \author  Author Name, 2026
+*/
+//========================================================================
+#ifndef CMVISION_ROI_H
+#define CMVISION_ROI_H
+#include <vector>
+
+namespace CMVision {
+
+/*!
+  \class   ImageROI
+  \brief   An inclusive rectangle of pixels
+*/
+class ImageROI {
+public:
+  int x1;
+  int y1;
+  int x2;
+  int y2;
+  ImageROI() : x1(0), y1(0), x2(-1), y2(-1) {}
+  ImageROI(int _x1, int _y1, int _x2, int _y2) : x1(_x1), y1(_y1), x2(_x2), y2(_y2) {}
+  int getArea() const {
+    return (x2 - x1 + 1) * (y2 - y1 + 1);
+  }
+};
+
+/*!
+  \class   ROIList
+  \brief   The image windows that segmentation is restricted to in a frame
+
+  A producer either requests a full-frame scan or adds windows in video
+  pixel coordinates. mapToImage() then clips the windows to a (possibly
+  reduced-resolution) label image and marks the label rows they cover,
+  so that thresholding and runlength encoding can skip everything else.
+  Windows may overlap; overlapping pixels are simply processed twice.
+*/
+class ROIList {
+protected:
+  bool full_frame;
+  std::vector<ImageROI> requested; //in video pixels
+  std::vector<ImageROI> windows; //in label image pixels
+  std::vector<unsigned char> row_covered;
+public:
+  ROIList();
+
+  /// no windows, the whole image gets processed
+  void setFullFrame();
+  /// no windows, nothing gets processed until windows are added
+  void clear();
+  /// adds an inclusive window in video pixel coordinates
+  void add(int x1, int y1, int x2, int y2);
+
+  bool isFullFrame() const {
+    return full_frame;
+  }
+
+  /// clips the requested windows to a label image of the given size, which
+  /// is \p scale times smaller than the video. The windows' left edges are
+  /// aligned to even columns and their right edges to odd ones, so they
+  /// never split a YUV422 pixel pair.
+  void mapToImage(int width, int height, int scale);
+
+  /// the windows in label image pixels, valid after mapToImage()
+  const std::vector<ImageROI> & getWindows() const {
+    return windows;
+  }
+  /// whether any window touches the label image row, valid after mapToImage()
+  bool isRowCovered(int y) const {
+    return full_frame || (y >= 0 && y < (int)row_covered.size() && row_covered[y] != 0);
+  }
+  /// number of label pixels inside the windows, counting overlaps twice
+  int getCoveredPixels() const;
+};
+
+}
+
+#endif
@@ -20,6 +20,7 @@
 */
 //========================================================================
 #include "cmvision_threshold.h"
+#include "conversions.h"
 
 CMVisionThreshold::CMVisionThreshold()
 {
@@ -143,6 +144,128 @@ bool CMVisionThreshold::thresholdImageRGB(Image<raw8> * target, const ImageInter
   return true;
 }
 
+bool CMVisionThreshold::thresholdImageBayerQuads(Image<raw8> * target, const RawImage * source, YUVLUT * lut, Bayer::Pattern pattern) {
+  if (source->getColorFormat()!=COLOR_RAW8) {
+    fprintf(stderr,"CMVision Bayer thresholding assumes RAW8 as input, but found %s\n", Colors::colorFormatToString(source->getColorFormat()).c_str());
+    return false;
+  }
+
+  int source_width = source->getWidth();
+  int width  = source_width / 2;
+  int height = source->getHeight() / 2;
+  if (target->getWidth() != width || target->getHeight() != height) {
+    fprintf(stderr, "CMVision Bayer thresholding: target (w=%d h=%d) must be half the size of the source (w=%d  h=%d)!\n", target->getWidth(),target->getHeight(),source->getWidth(),source->getHeight());
+    return false;
+  }
+
+  //offsets of the four samples within a quad:
+  int r, g1, g2, b;
+  Bayer::getQuadOffsets(pattern, r, g1, g2, b);
+  int off_r  = (r  >> 1) * source_width + (r  & 1);
+  int off_g1 = (g1 >> 1) * source_width + (g1 & 1);
+  int off_g2 = (g2 >> 1) * source_width + (g2 & 1);
+  int off_b  = (b  >> 1) * source_width + (b  & 1);
+
+  lut_mask_t * LUT = lut->getTable();
+  const unsigned char * source_pointer = source->getData();
+  raw8 * target_pointer = target->getPixelData();
+
+  lut->lock();
+  int X_SHIFT=lut->X_SHIFT;
+  int Y_SHIFT=lut->Y_SHIFT;
+  int Z_SHIFT=lut->Z_SHIFT;
+  int Z_AND_Y_BITS=lut->Z_AND_Y_BITS;
+  int Z_BITS = lut->Z_BITS;
+  int y, u, v;
+  for (int j=0;j<height;j++) {
+    const unsigned char * quad = source_pointer + 2 * j * source_width;
+    raw8 * row = target_pointer + j * width;
+    for (int i=0;i<width;i++) {
+      Conversions::rgb2yuv(quad[off_r], (quad[off_g1] + quad[off_g2] + 1) >> 1, quad[off_b], y, u, v);
+      row[i] = LUT[(((y >> X_SHIFT) << Z_AND_Y_BITS) | ((u >> Y_SHIFT) << Z_BITS) | (v >> Z_SHIFT))];
+      quad += 2;
+    }
+  }
+  lut->unlock();
+
+  return true;
+}
+
+bool CMVisionThreshold::thresholdImageROIs(Image<raw8> * target, const RawImage * source, LUT3D * lut, Bayer::Pattern pattern, const CMVision::ROIList & rois) {
+  ColorFormat format = source->getColorFormat();
+  int source_width = source->getWidth();
+  int scale = (format == COLOR_RAW8) ? 2 : 1;
+  if (target->getWidth() != source_width / scale || target->getHeight() != source->getHeight() / scale) {
+    fprintf(stderr, "CMVision ROI thresholding: target (w=%d h=%d) does not match the source (w=%d  h=%d)!\n", target->getWidth(),target->getHeight(),source->getWidth(),source->getHeight());
+    return false;
+  }
+  if (format != COLOR_YUV422_UYVY && format != COLOR_YUV444 && format != COLOR_RGB8 && format != COLOR_RAW8) {
+    fprintf(stderr,"CMVision ROI thresholding needs YUV422, YUV444, RGB8, or RAW8 as input, but found %s\n", Colors::colorFormatToString(format).c_str());
+    return false;
+  }
+
+  int width = target->getWidth();
+  target->fillBlack();
+  raw8 * target_pointer = target->getPixelData();
+
+  //offsets of the four samples within a bayer quad:
+  int r, g1, g2, b;
+  Bayer::getQuadOffsets(pattern, r, g1, g2, b);
+  int off_r  = (r  >> 1) * source_width + (r  & 1);
+  int off_g1 = (g1 >> 1) * source_width + (g1 & 1);
+  int off_g2 = (g2 >> 1) * source_width + (g2 & 1);
+  int off_b  = (b  >> 1) * source_width + (b  & 1);
+
+  lut_mask_t * LUT = lut->getTable();
+  lut->lock();
+  int X_SHIFT=lut->X_SHIFT;
+  int Y_SHIFT=lut->Y_SHIFT;
+  int Z_SHIFT=lut->Z_SHIFT;
+  int Z_AND_Y_BITS=lut->Z_AND_Y_BITS;
+  int Z_BITS = lut->Z_BITS;
+  const vector<CMVision::ImageROI> & windows = rois.getWindows();
+  for (unsigned int k=0;k<windows.size();k++) {
+    const CMVision::ImageROI & w = windows[k];
+    for (int j=w.y1;j<=w.y2;j++) {
+      raw8 * row = target_pointer + j * width;
+      if (format == COLOR_YUV422_UYVY) {
+        //windows start on even columns, so i is always the first of a pair:
+        const uyvy * src = (const uyvy *)(source->getData()) + ((j * width) >> 1);
+        for (int i=w.x1;i<w.x2;i+=2) {
+          uyvy p=src[i >> 1];
+          int B=((p.u >> Y_SHIFT) << Z_BITS);
+          int C=(p.v >> Z_SHIFT);
+          row[i] =  LUT[(((p.y1 >> X_SHIFT) << Z_AND_Y_BITS) | B | C)];
+          row[i+1] =  LUT[(((p.y2 >> X_SHIFT) << Z_AND_Y_BITS) | B | C)];
+        }
+      } else if (format == COLOR_YUV444) {
+        const yuv * src = (const yuv *)(source->getData()) + j * width;
+        for (int i=w.x1;i<=w.x2;i++) {
+          yuv p=src[i];
+          row[i] =  LUT[(((p.y >> X_SHIFT) << Z_AND_Y_BITS) | ((p.u >> Y_SHIFT) << Z_BITS) | (p.v >> Z_SHIFT))];
+        }
+      } else if (format == COLOR_RGB8) {
+        const rgb * src = (const rgb *)(source->getData()) + j * width;
+        for (int i=w.x1;i<=w.x2;i++) {
+          rgb p=src[i];
+          row[i] =  LUT[(((p.r >> X_SHIFT) << Z_AND_Y_BITS) | ((p.g >> Y_SHIFT) << Z_BITS) | (p.b >> Z_SHIFT))];
+        }
+      } else {
+        const unsigned char * quad = source->getData() + 2 * j * source_width + 2 * w.x1;
+        int y, u, v;
+        for (int i=w.x1;i<=w.x2;i++) {
+          Conversions::rgb2yuv(quad[off_r], (quad[off_g1] + quad[off_g2] + 1) >> 1, quad[off_b], y, u, v);
+          row[i] = LUT[(((y >> X_SHIFT) << Z_AND_Y_BITS) | ((u >> Y_SHIFT) << Z_BITS) | (v >> Z_SHIFT))];
+          quad += 2;
+        }
+      }
+    }
+  }
+  lut->unlock();
+
+  return true;
+}
+
 //static void thresholdImage(Image * target, const Image<yuv> * source, const YUVLUT * lut);
 
 //static void thresholdImage(Image * target, const Image<yuvy> * source, const YUVLUT * lut);
@@ -27,6 +27,8 @@
 #include "image.h"
 #include "colors.h"
 #include "timer.h"
+#include "bayer.h"
+#include "cmvision_roi.h"
 
 /**
 	@author James Bruce (Original CMVision implementation and algorithms),
@@ -42,6 +44,23 @@ public:
     static bool thresholdImageYUV444(Image<raw8> * target, const ImageInterface * source, YUVLUT * lut);
     static bool thresholdImageRGB(Image<raw8> * target, const ImageInterface * source, RGBLUT * lut);
 
+    /// thresholds a RAW8 Bayer image without demosaicing it: each 2x2 quad
+    /// becomes one YUV sample, so \p target is half the source resolution.
+    static bool thresholdImageBayerQuads(Image<raw8> * target, const RawImage * source, YUVLUT * lut, Bayer::Pattern pattern);
+
+    /// thresholds only the windows of \p rois (which have to be mapped to the
+    /// target's size) and sets all other target pixels to the clear label.
+    /// \p lut is the YUV LUT, or the derived RGB LUT for RGB8 sources;
+    /// \p pattern is only used for RAW8 sources, which are thresholded per
+    /// Bayer quad as in thresholdImageBayerQuads().
+    static bool thresholdImageROIs(Image<raw8> * target, const RawImage * source, LUT3D * lut, Bayer::Pattern pattern, const CMVision::ROIList & rois);
+
+    /// ratio between the source image and the thresholded image (1 or 2)
+    static int getLabelScale(int source_width, const Image<raw8> * target) {
+      if (target == 0 || target->getWidth() <= 0 || source_width <= target->getWidth()) return 1;
+      return source_width / target->getWidth();
+    }
+
     static void colorizeImageFromThresholding(rgbImage & target, const Image<raw8> & source, LUT3D * lut);
 
     //static void thresholdImage(Image * target, const Image<yuv> * source, const YUVLUT * lut);
@@ -169,6 +169,11 @@ bool UDP::addMulticast(const Address &multiaddr,const Address &interface)
   return(ret == 0);
 }
 
+bool UDP::setRecvBufferSize(int bytes)
+{
+  return(setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes)) == 0);
+}
+
 void UDP::close()
 {
   if(fd >= 0) ::close(fd);
@@ -205,6 +210,21 @@ int UDP::recv(void *data,int length,Address &src)
   return(len);
 }
 
+// receives up to num_msgs datagrams with a single system call, without
+// blocking. returns the number of datagrams received (0 if none pending).
+int UDP::recvMulti(mmsghdr *msgs,int num_msgs)
+{
+  int n = recvmmsg(fd,msgs,num_msgs,MSG_DONTWAIT,NULL);
+  if(n <= 0) return(0);
+
+  recv_packets += n;
+  for(int i=0; i<n; i++){
+    recv_bytes += msgs[i].msg_len;
+  }
+
+  return(n);
+}
+
 bool UDP::wait(int timeout_ms) const
 {
   pollfd pfd;
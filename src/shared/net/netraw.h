@@ -5,6 +5,7 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <sys/uio.h>
 
 #include <stdio.h>
 #include <string.h>
@@ -64,12 +65,14 @@ public:
 
   bool open(int port = 0, bool share_port_for_multicasting=false, bool multicast_include_localhost=false, bool blocking=false);
   bool addMulticast(const Address &multiaddr,const Address &interface);
+  bool setRecvBufferSize(int bytes);
   void close();
   bool isOpen() const
     {return(fd >= 0);}
 
   bool send(const void *data,int length,const Address &dest);
   int  recv(void *data,int length,Address &src);
+  int  recvMulti(mmsghdr *msgs,int num_msgs);
   bool wait(int timeout_ms = -1) const;
   bool havePendingData() const
     {return(wait(0));}
@@ -19,6 +19,7 @@
 */
 //========================================================================
 #include "robocup_ssl_client.h"
+#include <unistd.h>
 
 RoboCupSSLClient::RoboCupSSLClient(int port,
                      string net_address,
@@ -28,12 +29,32 @@ RoboCupSSLClient::RoboCupSSLClient(int port,
   _net_address=net_address;
   _net_interface=net_interface;
   in_buffer=new char[65536];
+
+  batch_size=0;
+  batch_buffer=new char[MaxBatchSize * MaxDataGramSize];
+  batch_msgs=new mmsghdr[MaxBatchSize];
+  batch_iovecs=new iovec[MaxBatchSize];
+  memset(batch_msgs,0,sizeof(mmsghdr) * MaxBatchSize);
+  for (int i=0;i<MaxBatchSize;i++) {
+    batch_iovecs[i].iov_base=batch_buffer + i * MaxDataGramSize;
+    batch_iovecs[i].iov_len=MaxDataGramSize;
+    batch_msgs[i].msg_hdr.msg_iov=&batch_iovecs[i];
+    batch_msgs[i].msg_hdr.msg_iovlen=1;
+    batch_packets.push_back(new SSL_WrapperPacket());
+  }
+  batch_valid.resize(MaxBatchSize,false);
 }
 
 
 RoboCupSSLClient::~RoboCupSSLClient()
 {
   delete[] in_buffer;
+  delete[] batch_buffer;
+  delete[] batch_msgs;
+  delete[] batch_iovecs;
+  for (unsigned int i=0;i<batch_packets.size();i++) {
+    delete batch_packets[i];
+  }
 }
 
 void RoboCupSSLClient::close() {
@@ -47,6 +68,8 @@ bool RoboCupSSLClient::open(bool blocking) {
     fflush(stderr);
     return(false);
   }
+  //leave room for bursts of packets from all cameras between two batches:
+  mc.setRecvBufferSize(MaxBatchSize * MaxDataGramSize);
 
   Net::Address multiaddr,interface;
   multiaddr.setHost(_net_address.c_str(),_port);
@@ -77,3 +100,95 @@ bool RoboCupSSLClient::receive(SSL_WrapperPacket & packet) {
   return false;
 }
 
+
+bool RoboCupSSLClient::wait(int timeout_ms) const {
+  return mc.wait(timeout_ms);
+}
+
+int RoboCupSSLClient::getFd() const {
+  return mc.getFd();
+}
+
+int RoboCupSSLClient::getPort() const {
+  return _port;
+}
+
+int RoboCupSSLClient::receiveBatch() {
+  batch_size = mc.recvMulti(batch_msgs,MaxBatchSize);
+  for (int i=0;i<batch_size;i++) {
+    batch_valid[i]=batch_packets[i]->ParseFromArray(batch_iovecs[i].iov_base,batch_msgs[i].msg_len);
+  }
+  return batch_size;
+}
+
+int RoboCupSSLClient::getBatchSize() const {
+  return batch_size;
+}
+
+bool RoboCupSSLClient::isBatchPacketValid(int i) const {
+  return batch_valid[i];
+}
+
+const SSL_WrapperPacket & RoboCupSSLClient::getBatchPacket(int i) const {
+  return *(batch_packets[i]);
+}
+
+const char * RoboCupSSLClient::getBatchData(int i, int & length) const {
+  length=batch_msgs[i].msg_len;
+  return (const char *)batch_iovecs[i].iov_base;
+}
+
+bool RoboCupSSLClient::parseBatchData(int i, ::google::protobuf::Message & msg) const {
+  return msg.ParseFromArray(batch_iovecs[i].iov_base,batch_msgs[i].msg_len);
+}
+
+RoboCupSSLClientGroup::RoboCupSSLClientGroup()
+{
+  epoll_fd=epoll_create1(0);
+  if (epoll_fd < 0) {
+    perror("epoll_create1");
+  }
+}
+
+RoboCupSSLClientGroup::~RoboCupSSLClientGroup()
+{
+  if (epoll_fd >= 0) ::close(epoll_fd);
+}
+
+bool RoboCupSSLClientGroup::add(RoboCupSSLClient * client) {
+  if (epoll_fd < 0 || client->getFd() < 0) return false;
+  epoll_event ev;
+  memset(&ev,0,sizeof(ev));
+  ev.events=EPOLLIN;
+  ev.data.ptr=client;
+  if (epoll_ctl(epoll_fd,EPOLL_CTL_ADD,client->getFd(),&ev)!=0) {
+    fprintf(stderr,"Unable to watch UDP network port: %d\n",client->getPort());
+    fflush(stderr);
+    return false;
+  }
+  clients.push_back(client);
+  return true;
+}
+
+void RoboCupSSLClientGroup::remove(RoboCupSSLClient * client) {
+  for (unsigned int i=0;i<clients.size();i++) {
+    if (clients[i]==client) {
+      epoll_ctl(epoll_fd,EPOLL_CTL_DEL,client->getFd(),NULL);
+      clients.erase(clients.begin() + i);
+      return;
+    }
+  }
+}
+
+int RoboCupSSLClientGroup::wait(int timeout_ms) {
+  ready.clear();
+  int n=epoll_wait(epoll_fd,events,MaxEvents,timeout_ms);
+  for (int i=0;i<n;i++) {
+    ready.push_back((RoboCupSSLClient *)events[i].data.ptr);
+  }
+  return n;
+}
+
+RoboCupSSLClient * RoboCupSSLClientGroup::getReady(int i) const {
+  return ready[i];
+}
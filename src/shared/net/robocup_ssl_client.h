@@ -22,6 +22,8 @@
 #define ROBOCUP_SSL_CLIENT_H
 #include "netraw.h"
 #include <string>
+#include <vector>
+#include <sys/epoll.h>
 #include "messages_robocup_ssl_detection.pb.h"
 #include "messages_robocup_ssl_geometry.pb.h"
 #include "messages_robocup_ssl_wrapper.pb.h"
@@ -34,11 +36,22 @@ using namespace std;
 class RoboCupSSLClient{
 protected:
   static const int MaxDataGramSize = 65536;
+  static const int MaxBatchSize = 32;
   char * in_buffer;
   Net::UDP mc; // multicast client
   int _port;
   string _net_address;
   string _net_interface;
+
+  //batch receive state, filled by receiveBatch()
+  char * batch_buffer;
+  mmsghdr * batch_msgs;
+  iovec * batch_iovecs;
+  int batch_size;
+  //packets are kept between batches, so that protobuf can reuse their
+  //sub-message allocations when parsing the next datagrams
+  vector<SSL_WrapperPacket *> batch_packets;
+  vector<bool> batch_valid;
 public:
     RoboCupSSLClient(int port = 10006,
                      string net_ref_address="224.5.23.2",
@@ -49,6 +62,53 @@ public:
     void close();
     bool receive(SSL_WrapperPacket & packet);
 
+    /// waits until data is pending or timeout_ms has passed (-1 waits forever)
+    bool wait(int timeout_ms = -1) const;
+    int getFd() const;
+    int getPort() const;
+
+    /// receives all currently pending datagrams (up to MaxBatchSize) with a
+    /// single recvmmsg call and parses them as SSL_WrapperPacket.
+    /// returns the number of datagrams in the batch; call repeatedly until
+    /// it returns 0 to drain the socket.
+    int receiveBatch();
+
+    /// access to the results of the last receiveBatch() call.
+    /// the returned packets are reused by the next call.
+    int getBatchSize() const;
+    bool isBatchPacketValid(int i) const;
+    const SSL_WrapperPacket & getBatchPacket(int i) const;
+
+    /// raw datagram access, for ports carrying other message types
+    /// (e.g. the legacy wrapper or referee packets)
+    const char * getBatchData(int i, int & length) const;
+    bool parseBatchData(int i, ::google::protobuf::Message & msg) const;
+};
+
+/*!
+  \class   RoboCupSSLClientGroup
+  \brief   Waits on several RoboCupSSLClients (ports / multicast groups) with one epoll set
+*/
+class RoboCupSSLClientGroup{
+protected:
+  static const int MaxEvents = 16;
+  int epoll_fd;
+  vector<RoboCupSSLClient *> clients;
+  vector<RoboCupSSLClient *> ready;
+  epoll_event events[MaxEvents];
+public:
+    RoboCupSSLClientGroup();
+    ~RoboCupSSLClientGroup();
+
+    /// the client must already be open. It is not owned by the group.
+    bool add(RoboCupSSLClient * client);
+    void remove(RoboCupSSLClient * client);
+
+    /// waits for any of the clients to become readable and returns the
+    /// number of ready clients (0 on timeout, -1 on error).
+    /// use getReady(i)->receiveBatch() to drain them.
+    int wait(int timeout_ms = -1);
+    RoboCupSSLClient * getReady(int i) const;
 };
 
 #endif
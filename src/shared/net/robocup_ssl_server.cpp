@@ -85,6 +85,20 @@ bool RoboCupSSLServer::send(const SSL_GeometryData & geometry) {
   return ret;
 }
 
+bool RoboCupSSLServer::send(const SSL_DetectionTick & tick) {
+  mutex.lock();
+  bool ret = sendWrapperPacket<SSL_DetectionTick>(tick);
+  mutex.unlock();
+  return ret;
+}
+
+bool RoboCupSSLServer::sendSerialized(const string & buffer) {
+  mutex.lock();
+  bool ret = sendBuffer(buffer);
+  mutex.unlock();
+  return ret;
+}
+
 bool RoboCupSSLServer::sendLegacyMessage(const SSL_DetectionFrame& frame) {
   RoboCup2014Legacy::Wrapper::SSL_WrapperPacket pkt;
   SSL_DetectionFrame * nframe = pkt.mutable_detection();
@@ -24,6 +24,7 @@
 #include <string>
 #include <QMutex>
 #include "messages_robocup_ssl_detection.pb.h"
+#include "messages_robocup_ssl_detection_tick.pb.h"
 #include "messages_robocup_ssl_geometry.pb.h"
 #include "messages_robocup_ssl_geometry_legacy.pb.h"
 #include "messages_robocup_ssl_wrapper.pb.h"
@@ -49,10 +50,15 @@ public:
     ~RoboCupSSLServer();
     bool open();
     void close();
+    bool isOpen() const
+      {return(mc.isOpen());}
     template <typename T>
     bool sendWrapperPacket(const T & packet) {
       string buffer;
       packet.SerializeToString(&buffer);
+      return(sendBuffer(buffer));
+    }
+    bool sendBuffer(const string & buffer) {
       Net::Address multiaddr;
       multiaddr.setHost(_net_address.c_str(),_port);
       bool result;
@@ -71,6 +77,9 @@ public:
 
     bool send(const SSL_DetectionFrame & frame);
     bool send(const SSL_GeometryData & geometry);
+    bool send(const SSL_DetectionTick & tick);
+    /// sends an already serialized packet, e.g. a cached geometry packet
+    bool sendSerialized(const string & buffer);
     bool sendLegacyMessage(
         const RoboCup2014Legacy::Geometry::SSL_GeometryData & geometry);
     bool sendLegacyMessage(const SSL_DetectionFrame & frame);
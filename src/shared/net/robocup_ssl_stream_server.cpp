@@ -0,0 +1,356 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    robocup_ssl_stream_server.cpp
+  \brief   C++ Implementation: robocup_ssl_stream_server
+  \author  Author Name, 2026
+*/
+//========================================================================
+#include "robocup_ssl_stream_server.h"
+#include "timer.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+RoboCupSSLStreamServer::RoboCupSSLStreamServer()
+{
+  tcp_fd=-1;
+  unix_fd=-1;
+  tcp_port=0;
+  next_id=1;
+  generation=0;
+  queue_limit=1024*1024;
+  stall_timeout=1.0;
+  disconnected_slow=0;
+  _shutdown=false;
+  if (pipe(wake_fds)!=0) {
+    perror("pipe");
+    wake_fds[0]=wake_fds[1]=-1;
+  } else {
+    fcntl(wake_fds[0],F_SETFL,O_NONBLOCK);
+    fcntl(wake_fds[1],F_SETFL,O_NONBLOCK);
+  }
+}
+
+RoboCupSSLStreamServer::~RoboCupSSLStreamServer()
+{
+  stop();
+  close();
+  if (wake_fds[0]>=0) ::close(wake_fds[0]);
+  if (wake_fds[1]>=0) ::close(wake_fds[1]);
+}
+
+void RoboCupSSLStreamServer::wakeup() {
+  char c=0;
+  if (wake_fds[1]>=0) {
+    //a full pipe already guarantees a wakeup:
+    if (write(wake_fds[1],&c,1) < 0) {}
+  }
+}
+
+void RoboCupSSLStreamServer::close() {
+  mutex.lock();
+  if (tcp_fd>=0) ::close(tcp_fd);
+  tcp_fd=-1;
+  tcp_port=0;
+  if (unix_fd>=0) {
+    ::close(unix_fd);
+    unlink(unix_path.c_str());
+  }
+  unix_fd=-1;
+  unix_path="";
+  while (!subscribers.empty()) {
+    removeSubscriber(subscribers.front());
+  }
+  generation++;
+  mutex.unlock();
+  wakeup();
+}
+
+bool RoboCupSSLStreamServer::open(int port, const string & path) {
+  close();
+  bool result=true;
+  mutex.lock();
+  if (port > 0) {
+    tcp_fd=socket(AF_INET,SOCK_STREAM | SOCK_NONBLOCK,0);
+    int yes=1;
+    setsockopt(tcp_fd,SOL_SOCKET,SO_REUSEADDR,&yes,sizeof(yes));
+    sockaddr_in addr;
+    memset(&addr,0,sizeof(addr));
+    addr.sin_family=AF_INET;
+    addr.sin_addr.s_addr=htonl(INADDR_ANY);
+    addr.sin_port=htons(port);
+    if (tcp_fd<0 || bind(tcp_fd,(sockaddr *)&addr,sizeof(addr))!=0 || listen(tcp_fd,8)!=0) {
+      fprintf(stderr,"Unable to open TCP stream port: %d (%s)\n",port,strerror(errno));
+      fflush(stderr);
+      if (tcp_fd>=0) ::close(tcp_fd);
+      tcp_fd=-1;
+      result=false;
+    } else {
+      tcp_port=port;
+    }
+  }
+  if (path.length() > 0) {
+    sockaddr_un addr;
+    memset(&addr,0,sizeof(addr));
+    addr.sun_family=AF_UNIX;
+    if (path.length() >= sizeof(addr.sun_path)) {
+      fprintf(stderr,"Unix stream socket path too long: %s\n",path.c_str());
+      fflush(stderr);
+      result=false;
+    } else {
+      strncpy(addr.sun_path,path.c_str(),sizeof(addr.sun_path)-1);
+      unlink(path.c_str());
+      unix_fd=socket(AF_UNIX,SOCK_STREAM | SOCK_NONBLOCK,0);
+      if (unix_fd<0 || bind(unix_fd,(sockaddr *)&addr,sizeof(addr))!=0 || listen(unix_fd,8)!=0) {
+        fprintf(stderr,"Unable to open Unix stream socket: %s (%s)\n",path.c_str(),strerror(errno));
+        fflush(stderr);
+        if (unix_fd>=0) ::close(unix_fd);
+        unix_fd=-1;
+        result=false;
+      } else {
+        unix_path=path;
+      }
+    }
+  }
+  _shutdown=false;
+  mutex.unlock();
+  if (!isRunning()) start();
+  wakeup();
+  return result;
+}
+
+void RoboCupSSLStreamServer::stop() {
+  _shutdown=true;
+  wakeup();
+  wait();
+}
+
+void RoboCupSSLStreamServer::setQueueLimit(int bytes) {
+  mutex.lock();
+  queue_limit=bytes;
+  mutex.unlock();
+}
+
+void RoboCupSSLStreamServer::setStallTimeout(double seconds) {
+  mutex.lock();
+  stall_timeout=seconds;
+  mutex.unlock();
+}
+
+bool RoboCupSSLStreamServer::send(const SSL_DetectionFrame & frame) {
+  SSL_WrapperPacket pkt;
+  SSL_DetectionFrame * nframe = pkt.mutable_detection();
+  nframe->CopyFrom(frame);
+  nframe->set_t_sent(GetTimeSec());
+  string buffer;
+  pkt.SerializeToString(&buffer);
+  return sendSerialized(buffer);
+}
+
+bool RoboCupSSLStreamServer::sendSerialized(const string & buffer) {
+  //the length-prefixed packet is shared (reference counted) by all queues:
+  QByteArray packet;
+  packet.resize(4 + buffer.length());
+  uint32_t len=htonl(buffer.length());
+  memcpy(packet.data(),&len,4);
+  memcpy(packet.data()+4,buffer.data(),buffer.length());
+
+  double now=GetTimeSec();
+  bool queued=false;
+  mutex.lock();
+  for (list<Subscriber *>::iterator it=subscribers.begin(); it!=subscribers.end(); ++it) {
+    Subscriber * s=*it;
+    if (s->disconnect) continue;
+    if (s->queued_bytes + packet.size() > queue_limit) {
+      s->dropped_packets++;
+      if (s->full_since==0.0) {
+        s->full_since=now;
+      } else if (now - s->full_since > stall_timeout) {
+        s->disconnect=true;
+      }
+    } else {
+      s->queue.push_back(packet);
+      s->queued_bytes+=packet.size();
+      s->full_since=0.0;
+      queued=true;
+    }
+  }
+  mutex.unlock();
+  wakeup();
+  return queued;
+}
+
+void RoboCupSSLStreamServer::getSubscriberStats(vector<SubscriberStats> & stats) {
+  stats.clear();
+  mutex.lock();
+  for (list<Subscriber *>::iterator it=subscribers.begin(); it!=subscribers.end(); ++it) {
+    Subscriber * s=*it;
+    SubscriberStats st;
+    st.id=s->id;
+    st.peer=s->peer;
+    st.queued_bytes=s->queued_bytes;
+    st.queued_packets=s->queue.size();
+    st.sent_packets=s->sent_packets;
+    st.dropped_packets=s->dropped_packets;
+    stats.push_back(st);
+  }
+  mutex.unlock();
+}
+
+unsigned int RoboCupSSLStreamServer::getDisconnectedSlowCount() {
+  mutex.lock();
+  unsigned int result=disconnected_slow;
+  mutex.unlock();
+  return result;
+}
+
+void RoboCupSSLStreamServer::acceptSubscriber(int listen_fd, bool is_tcp) {
+  sockaddr_storage addr;
+  socklen_t addr_len=sizeof(addr);
+  int fd=accept4(listen_fd,(sockaddr *)&addr,&addr_len,SOCK_NONBLOCK);
+  if (fd<0) return;
+  Subscriber * s=new Subscriber;
+  s->fd=fd;
+  s->id=next_id++;
+  char buf[64];
+  if (is_tcp) {
+    int yes=1;
+    setsockopt(fd,IPPROTO_TCP,TCP_NODELAY,&yes,sizeof(yes));
+    sockaddr_in * in=(sockaddr_in *)&addr;
+    char host[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET,&in->sin_addr,host,sizeof(host));
+    snprintf(buf,sizeof(buf),"tcp %s:%d",host,ntohs(in->sin_port));
+  } else {
+    snprintf(buf,sizeof(buf),"unix #%d",s->id);
+  }
+  s->peer=buf;
+  s->queued_bytes=0;
+  s->offset=0;
+  s->sent_packets=0;
+  s->dropped_packets=0;
+  s->full_since=0.0;
+  s->disconnect=false;
+  subscribers.push_back(s);
+}
+
+void RoboCupSSLStreamServer::removeSubscriber(Subscriber * s) {
+  ::close(s->fd);
+  subscribers.remove(s);
+  delete s;
+}
+
+bool RoboCupSSLStreamServer::writeSubscriber(Subscriber * s) {
+  while (!s->queue.empty()) {
+    const QByteArray & packet=s->queue.front();
+    ssize_t n=::send(s->fd,packet.constData()+s->offset,packet.size()-s->offset,MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n<0) {
+      return (errno==EAGAIN || errno==EWOULDBLOCK || errno==EINTR);
+    }
+    s->offset+=n;
+    if (s->offset < packet.size()) return true;
+    s->queued_bytes-=packet.size();
+    s->queue.pop_front();
+    s->offset=0;
+    s->sent_packets++;
+  }
+  return true;
+}
+
+void RoboCupSSLStreamServer::run() {
+  vector<pollfd> fds;
+  vector<Subscriber *> polled;
+  while (!_shutdown) {
+    fds.clear();
+    polled.clear();
+    pollfd p;
+    p.revents=0;
+    p.fd=wake_fds[0];
+    p.events=POLLIN;
+    fds.push_back(p);
+    mutex.lock();
+    int listen_tcp=tcp_fd;
+    int listen_unix=unix_fd;
+    unsigned int polled_generation=generation;
+    if (listen_tcp>=0) {
+      p.fd=listen_tcp;
+      fds.push_back(p);
+    }
+    if (listen_unix>=0) {
+      p.fd=listen_unix;
+      fds.push_back(p);
+    }
+    for (list<Subscriber *>::iterator it=subscribers.begin(); it!=subscribers.end(); ) {
+      Subscriber * s=*it;
+      ++it;
+      if (s->disconnect) {
+        fprintf(stderr,"Stream output: dropping slow subscriber %s\n",s->peer.c_str());
+        disconnected_slow++;
+        removeSubscriber(s);
+        continue;
+      }
+      p.fd=s->fd;
+      p.events=POLLIN | (s->queue.empty() ? 0 : POLLOUT);
+      fds.push_back(p);
+      polled.push_back(s);
+    }
+    mutex.unlock();
+
+    if (poll(&fds[0],fds.size(),100) <= 0) continue;
+
+    if (fds[0].revents & POLLIN) {
+      char buf[64];
+      while (read(wake_fds[0],buf,sizeof(buf)) > 0) {}
+    }
+
+    mutex.lock();
+    //the sockets might have been reopened while polling:
+    if (polled_generation==generation) {
+      size_t idx=1;
+      if (listen_tcp>=0) {
+        if (fds[idx].revents & POLLIN) acceptSubscriber(listen_tcp,true);
+        idx++;
+      }
+      if (listen_unix>=0) {
+        if (fds[idx].revents & POLLIN) acceptSubscriber(listen_unix,false);
+        idx++;
+      }
+      for (size_t i=0; i<polled.size(); i++, idx++) {
+        Subscriber * s=polled[i];
+        bool ok=true;
+        if (fds[idx].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+          ok=false;
+        } else if (fds[idx].revents & POLLIN) {
+          //subscribers are not expected to send anything, a read of 0
+          //bytes means that they went away.
+          char buf[256];
+          ssize_t n=recv(s->fd,buf,sizeof(buf),MSG_DONTWAIT);
+          if (n==0 || (n<0 && errno!=EAGAIN && errno!=EWOULDBLOCK)) ok=false;
+        }
+        if (ok && (fds[idx].revents & POLLOUT)) ok=writeSubscriber(s);
+        if (!ok) removeSubscriber(s);
+      }
+    }
+    mutex.unlock();
+  }
+}
@@ -0,0 +1,111 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    robocup_ssl_stream_server.h
+  \brief   C++ Interface: robocup_ssl_stream_server
+  \author  Author Name, 2026
+*/
+//========================================================================
+#ifndef ROBOCUP_SSL_STREAM_SERVER_H
+#define ROBOCUP_SSL_STREAM_SERVER_H
+#include <string>
+#include <vector>
+#include <list>
+#include <deque>
+#include <QThread>
+#include <QMutex>
+#include <QByteArray>
+#include "messages_robocup_ssl_detection.pb.h"
+#include "messages_robocup_ssl_wrapper.pb.h"
+using namespace std;
+
+/*!
+  \class   RoboCupSSLStreamServer
+  \brief   Streams SSL_WrapperPackets to any number of TCP and Unix domain
+           socket subscribers.
+
+  Every packet is prefixed with its length as a 32 bit unsigned integer in
+  network byte order. Each subscriber has its own bounded queue which is
+  written by the server thread; send() never blocks on a subscriber.
+  If a subscriber's queue is full, new packets are dropped for it, and if
+  it stays full for longer than the stall timeout, it is disconnected.
+*/
+class RoboCupSSLStreamServer : public QThread {
+public:
+  struct SubscriberStats {
+    int id;
+    string peer;
+    int queued_bytes;
+    int queued_packets;
+    unsigned int sent_packets;
+    unsigned int dropped_packets;
+  };
+
+protected:
+  struct Subscriber {
+    int fd;
+    int id;
+    string peer;
+    deque<QByteArray> queue;
+    int queued_bytes;
+    int offset;           //bytes of queue.front() that were already written
+    unsigned int sent_packets;
+    unsigned int dropped_packets;
+    double full_since;    //0 if the queue is not full
+    bool disconnect;
+  };
+
+  QMutex mutex;
+  int tcp_fd;
+  int unix_fd;
+  int tcp_port;
+  string unix_path;
+  int wake_fds[2];
+  int next_id;
+  unsigned int generation; //changes whenever the sockets are closed
+  int queue_limit;
+  double stall_timeout;
+  unsigned int disconnected_slow;
+  list<Subscriber *> subscribers;
+  volatile bool _shutdown;
+
+  void wakeup();
+  void acceptSubscriber(int listen_fd, bool is_tcp);
+  bool writeSubscriber(Subscriber * s);
+  void removeSubscriber(Subscriber * s);
+  virtual void run();
+
+public:
+  RoboCupSSLStreamServer();
+  ~RoboCupSSLStreamServer();
+
+  /// (re)opens the listening sockets. A port of 0 or an empty path disables
+  /// the respective socket type.
+  bool open(int port, const string & path);
+  void close();
+  void stop();
+
+  void setQueueLimit(int bytes);
+  void setStallTimeout(double seconds);
+
+  bool send(const SSL_DetectionFrame & frame);
+  /// sends an already serialized SSL_WrapperPacket
+  bool sendSerialized(const string & buffer);
+
+  void getSubscriberStats(vector<SubscriberStats> & stats);
+  unsigned int getDisconnectedSlowCount();
+};
+
+#endif
@@ -0,0 +1,327 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    bayer.cpp
+  \brief   C++ Implementation: Bayer
+  \author  Author Name, 2026
+*/
+//========================================================================
+
+#include "bayer.h"
+#include "conversions.h"
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define BAYER_X86_SIMD
+  #include <emmintrin.h>
+#endif
+
+using namespace std;
+
+enum {
+  BAYER_R=0,
+  BAYER_G_ON_R_ROW,
+  BAYER_G_ON_B_ROW,
+  BAYER_B
+};
+
+// color of the top-left two pixels of the two rows of each pattern
+static const int bayer_colors[4][2][2] = {
+  { { 'R', 'G' }, { 'G', 'B' } },    //RGGB
+  { { 'G', 'B' }, { 'R', 'G' } },    //GBRG
+  { { 'G', 'R' }, { 'B', 'G' } },    //GRBG
+  { { 'B', 'G' }, { 'G', 'R' } }     //BGGR
+};
+
+static int pixelType(Bayer::Pattern pattern, int row_parity, int col_parity) {
+  int c = bayer_colors[pattern][row_parity][col_parity];
+  if (c == 'R') return BAYER_R;
+  if (c == 'B') return BAYER_B;
+  return (bayer_colors[pattern][row_parity][1-col_parity] == 'R') ? BAYER_G_ON_R_ROW : BAYER_G_ON_B_ROW;
+}
+
+// bilinear interpolation of pixel x, with xl and xr being its left and
+// right neighbors (mirrored at the image border)
+template <int TYPE>
+static inline void interpolate(const unsigned char * up, const unsigned char * cur,
+                               const unsigned char * down, int x, int xl, int xr,
+                               unsigned char * rgb) {
+  if (TYPE == BAYER_R) {
+    rgb[0] = cur[x];
+    rgb[1] = (up[x] + down[x] + cur[xl] + cur[xr] + 2) >> 2;
+    rgb[2] = (up[xl] + up[xr] + down[xl] + down[xr] + 2) >> 2;
+  } else if (TYPE == BAYER_B) {
+    rgb[0] = (up[xl] + up[xr] + down[xl] + down[xr] + 2) >> 2;
+    rgb[1] = (up[x] + down[x] + cur[xl] + cur[xr] + 2) >> 2;
+    rgb[2] = cur[x];
+  } else if (TYPE == BAYER_G_ON_R_ROW) {
+    rgb[0] = (cur[xl] + cur[xr] + 1) >> 1;
+    rgb[1] = cur[x];
+    rgb[2] = (up[x] + down[x] + 1) >> 1;
+  } else {
+    rgb[0] = (up[x] + down[x] + 1) >> 1;
+    rgb[1] = cur[x];
+    rgb[2] = (cur[xl] + cur[xr] + 1) >> 1;
+  }
+}
+
+// the pixel types are template parameters, so that the inner loop is free
+// of branches
+template <int EVEN, int ODD>
+static void demosaicRow(const unsigned char * up, const unsigned char * cur,
+                        const unsigned char * down, int width, unsigned char * rgb) {
+  interpolate<EVEN>(up, cur, down, 0, 1, 1, rgb);
+  int x = 1;
+  for (; x + 2 < width; x += 2) {
+    interpolate<ODD>(up, cur, down, x, x - 1, x + 1, rgb + 3 * x);
+    interpolate<EVEN>(up, cur, down, x + 1, x, x + 2, rgb + 3 * x + 3);
+  }
+  for (; x < width; x++) {
+    int xr = (x + 1 < width) ? x + 1 : x - 1;
+    if (x & 1) {
+      interpolate<ODD>(up, cur, down, x, x - 1, xr, rgb + 3 * x);
+    } else {
+      interpolate<EVEN>(up, cur, down, x, x - 1, xr, rgb + 3 * x);
+    }
+  }
+}
+
+// pixels first..end-1 of a row, with mirrored borders
+template <int EVEN, int ODD>
+static void demosaicPixels(const unsigned char * up, const unsigned char * cur,
+                           const unsigned char * down, int width, int first, int end,
+                           unsigned char * rgb) {
+  for (int x = first; x < end; x++) {
+    int xl = (x > 0) ? x - 1 : 1;
+    int xr = (x + 1 < width) ? x + 1 : x - 1;
+    if (x & 1) {
+      interpolate<ODD>(up, cur, down, x, xl, xr, rgb + 3 * x);
+    } else {
+      interpolate<EVEN>(up, cur, down, x, xl, xr, rgb + 3 * x);
+    }
+  }
+}
+
+#ifdef BAYER_X86_SIMD
+
+#define BAYER_SSE2_LOAD(p) _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(p)), zero)
+#define BAYER_SSE2_SELECT(mask, a, b) _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b))
+
+// interpolates the inner pixels of a row, 8 at a time in 16 bit lanes, with
+// the same rounding as interpolate(). A row holds red (or blue) samples and
+// green samples in turn. \p red_row tells which, \p sample_even whether the
+// red (or blue) samples are at even x. Returns the first pixel not done.
+__attribute__((target("sse2")))
+static int demosaicRowSSE2(const unsigned char * up, const unsigned char * cur,
+                           const unsigned char * down, int width, bool red_row,
+                           bool sample_even, unsigned char * rgb) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i two = _mm_set1_epi16(2);
+  const __m128i even_lanes = _mm_set1_epi32(0x0000ffff);
+  const __m128i sample = sample_even ? even_lanes : _mm_andnot_si128(even_lanes, _mm_set1_epi32(-1));
+  __attribute__((aligned(16))) unsigned char planes[3][16];
+  //start at an even pixel, so that lane parity is pixel parity
+  int x = 2;
+  for (; x + 9 <= width; x += 8) {
+    __m128i c  = BAYER_SSE2_LOAD(cur + x);
+    __m128i h  = _mm_add_epi16(BAYER_SSE2_LOAD(cur + x - 1), BAYER_SSE2_LOAD(cur + x + 1));
+    __m128i v  = _mm_add_epi16(BAYER_SSE2_LOAD(up + x), BAYER_SSE2_LOAD(down + x));
+    __m128i d  = _mm_add_epi16(_mm_add_epi16(BAYER_SSE2_LOAD(up + x - 1), BAYER_SSE2_LOAD(up + x + 1)),
+                               _mm_add_epi16(BAYER_SSE2_LOAD(down + x - 1), BAYER_SSE2_LOAD(down + x + 1)));
+    __m128i cross = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(h, v), two), 2);
+    __m128i diag  = _mm_srli_epi16(_mm_add_epi16(d, two), 2);
+    __m128i h2    = _mm_srli_epi16(_mm_add_epi16(h, one), 1);
+    __m128i v2    = _mm_srli_epi16(_mm_add_epi16(v, one), 1);
+    //the sample pixel's own color, the color of the other rows, green:
+    __m128i own   = BAYER_SSE2_SELECT(sample, c, h2);
+    __m128i other = BAYER_SSE2_SELECT(sample, diag, v2);
+    __m128i g     = BAYER_SSE2_SELECT(sample, cross, c);
+    __m128i r = red_row ? own : other;
+    __m128i b = red_row ? other : own;
+    _mm_storel_epi64((__m128i *)planes[0], _mm_packus_epi16(r, r));
+    _mm_storel_epi64((__m128i *)planes[1], _mm_packus_epi16(g, g));
+    _mm_storel_epi64((__m128i *)planes[2], _mm_packus_epi16(b, b));
+    unsigned char * dest = rgb + 3 * x;
+    for (int k = 0; k < 8; k++) {
+      dest[0] = planes[0][k];
+      dest[1] = planes[1][k];
+      dest[2] = planes[2][k];
+      dest += 3;
+    }
+  }
+  return x;
+}
+
+template <int EVEN, int ODD>
+static void demosaicRowSIMD(const unsigned char * up, const unsigned char * cur,
+                            const unsigned char * down, int width, unsigned char * rgb) {
+  bool sample_even = (EVEN == BAYER_R || EVEN == BAYER_B);
+  bool red_row = (EVEN == BAYER_R || ODD == BAYER_R);
+  demosaicPixels<EVEN, ODD>(up, cur, down, width, 0, 2, rgb);
+  int x = demosaicRowSSE2(up, cur, down, width, red_row, sample_even, rgb);
+  demosaicPixels<EVEN, ODD>(up, cur, down, width, x, width, rgb);
+}
+
+#endif
+
+template <int EVEN, int ODD>
+static void demosaicRowDispatch(const unsigned char * up, const unsigned char * cur,
+                                const unsigned char * down, int width, unsigned char * rgb) {
+#ifdef BAYER_X86_SIMD
+  if (Conversions::getImplementation() >= Conversions::IMPL_SSE2) {
+    demosaicRowSIMD<EVEN, ODD>(up, cur, down, width, rgb);
+    return;
+  }
+#endif
+  demosaicRow<EVEN, ODD>(up, cur, down, width, rgb);
+}
+
+// demosaics row y into packed rgb. Borders are mirrored, which keeps the
+// color filter phase of the neighbors intact.
+static void demosaicRow(const unsigned char * src, int width, int height, int y,
+                        Bayer::Pattern pattern, unsigned char * rgb) {
+  const unsigned char * cur  = src + y * width;
+  const unsigned char * up   = src + (y > 0 ? y - 1 : 1) * width;
+  const unsigned char * down = src + (y < height - 1 ? y + 1 : height - 2) * width;
+  switch (pixelType(pattern, y & 1, 0)) {
+    case BAYER_R:
+      demosaicRowDispatch<BAYER_R, BAYER_G_ON_R_ROW>(up, cur, down, width, rgb);
+      break;
+    case BAYER_G_ON_R_ROW:
+      demosaicRowDispatch<BAYER_G_ON_R_ROW, BAYER_R>(up, cur, down, width, rgb);
+      break;
+    case BAYER_B:
+      demosaicRowDispatch<BAYER_B, BAYER_G_ON_B_ROW>(up, cur, down, width, rgb);
+      break;
+    default:
+      demosaicRowDispatch<BAYER_G_ON_B_ROW, BAYER_B>(up, cur, down, width, rgb);
+  }
+}
+
+struct BayerBand : public WorkerThreads::Task {
+  const unsigned char * src;
+  unsigned char * dest;
+  int width;
+  int height;
+  int first_row;
+  int end_row;
+  Bayer::Pattern pattern;
+  ColorFormat output_fmt;
+  virtual void run();
+};
+
+static void demosaicBand(const BayerBand & band) {
+  int w = band.width;
+  vector<unsigned char> row(band.output_fmt == COLOR_RGB8 ? 0 : w * 3);
+  for (int y = band.first_row; y < band.end_row; y++) {
+    switch (band.output_fmt) {
+      case COLOR_RGB8:
+        demosaicRow(band.src, w, band.height, y, band.pattern, band.dest + y * w * 3);
+        break;
+      case COLOR_YUV422_UYVY:
+        demosaicRow(band.src, w, band.height, y, band.pattern, &row[0]);
+        Conversions::rgb2uyvy(&row[0], band.dest + y * w * 2, w, 1);
+        break;
+      case COLOR_YUV422_YUYV:
+        demosaicRow(band.src, w, band.height, y, band.pattern, &row[0]);
+        Conversions::rgb2yuyv(&row[0], band.dest + y * w * 2, w, 1);
+        break;
+      default: {
+        demosaicRow(band.src, w, band.height, y, band.pattern, &row[0]);
+        unsigned char * d = band.dest + y * w * 3;
+        int yy, u, v;
+        for (int x = 0; x < w; x++) {
+          Conversions::rgb2yuv(row[3*x], row[3*x+1], row[3*x+2], yy, u, v);
+          d[0] = yy;
+          d[1] = u;
+          d[2] = v;
+          d += 3;
+        }
+      }
+    }
+  }
+}
+
+void BayerBand::run() {
+  demosaicBand(*this);
+}
+
+void Bayer::getQuadOffsets(Pattern pattern, int & r, int & g1, int & g2, int & b) {
+  int found_g = 0;
+  for (int i = 0; i < 4; i++) {
+    int c = bayer_colors[pattern][i >> 1][i & 1];
+    if (c == 'R') {
+      r = i;
+    } else if (c == 'B') {
+      b = i;
+    } else if (found_g++ == 0) {
+      g1 = i;
+    } else {
+      g2 = i;
+    }
+  }
+}
+
+string Bayer::patternToString(Pattern pattern) {
+  switch (pattern) {
+    case PATTERN_RGGB: return "RGGB";
+    case PATTERN_GBRG: return "GBRG";
+    case PATTERN_GRBG: return "GRBG";
+    case PATTERN_BGGR: return "BGGR";
+  }
+  return "RGGB";
+}
+
+Bayer::Pattern Bayer::stringToPattern(const string & s) {
+  if (s == "GBRG") return PATTERN_GBRG;
+  if (s == "GRBG") return PATTERN_GRBG;
+  if (s == "BGGR") return PATTERN_BGGR;
+  return PATTERN_RGGB;
+}
+
+bool Bayer::isSupportedOutput(ColorFormat output_fmt) {
+  return output_fmt == COLOR_RGB8 || output_fmt == COLOR_YUV422_UYVY ||
+         output_fmt == COLOR_YUV422_YUYV || output_fmt == COLOR_YUV444;
+}
+
+bool Bayer::demosaic(const unsigned char * src, unsigned char * dest, int width, int height,
+                     Pattern pattern, ColorFormat output_fmt, int threads,
+                     WorkerThreads * workers) {
+  if (!isSupportedOutput(output_fmt) || width < 2 || height < 2) return false;
+  if (workers == 0 || threads < 1) threads = 1;
+  if (threads > height / 2) threads = height / 2;
+
+  vector<BayerBand> bands(threads);
+  vector<WorkerThreads::Task *> tasks(threads);
+  for (int i = 0; i < threads; i++) {
+    BayerBand & band = bands[i];
+    band.src = src;
+    band.dest = dest;
+    band.width = width;
+    band.height = height;
+    band.first_row = (int)((long long)height * i / threads);
+    band.end_row = (int)((long long)height * (i + 1) / threads);
+    band.pattern = pattern;
+    band.output_fmt = output_fmt;
+    tasks[i] = &band;
+  }
+  if (threads == 1) {
+    demosaicBand(bands[0]);
+  } else {
+    workers->run(&tasks[0], threads);
+  }
+  return true;
+}
@@ -0,0 +1,71 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    bayer.h
+  \brief   C++ Interface: Bayer
+  \author  Author Name, 2026
+*/
+//========================================================================
+
+#ifndef BAYER_H
+#define BAYER_H
+
+#include "colors.h"
+#include "worker_threads.h"
+#include <string>
+using namespace std;
+
+/*!
+  \class  Bayer
+  \brief  Bilinear demosaicing of 8 bit Bayer images
+
+  Demosaics a RAW8 Bayer image directly into RGB8, YUV422 (UYVY or YUYV)
+  or YUV444. Rows are interpolated into a small row buffer and converted
+  to the output format right away, so there is no full-frame RGB
+  intermediate. Rows are interpolated with SSE2 if the conversions use
+  SSE2 or better (see Conversions::getImplementation()), bit-exact to the
+  scalar version. The image can be split into row bands which are
+  processed by the persistent threads of a WorkerThreads pool.
+*/
+class Bayer {
+public:
+  /// color filter layout, named by the first two rows. The order matches
+  /// dc1394color_filter_t, starting at DC1394_COLOR_FILTER_RGGB.
+  enum Pattern {
+    PATTERN_RGGB=0,
+    PATTERN_GBRG,
+    PATTERN_GRBG,
+    PATTERN_BGGR
+  };
+
+  /// returns false if \p output_fmt is not supported.
+  /// \p dest has to be allocated for \p output_fmt.
+  /// The image is split into \p threads bands, which are run on
+  /// \p workers. Without workers, the calling thread does all the work.
+  static bool demosaic(const unsigned char * src, unsigned char * dest, int width, int height,
+                       Pattern pattern, ColorFormat output_fmt, int threads=1,
+                       WorkerThreads * workers=0);
+
+  static bool isSupportedOutput(ColorFormat output_fmt);
+
+  /// position of each color within the 2x2 quad at even (x,y), as an
+  /// offset of row*2+col. Both green samples are returned.
+  static void getQuadOffsets(Pattern pattern, int & r, int & g1, int & g2, int & b);
+
+  static string patternToString(Pattern pattern);
+  static Pattern stringToPattern(const string & s);
+};
+
+#endif
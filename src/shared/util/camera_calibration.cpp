@@ -233,9 +233,9 @@ void CameraParameters::field2image(
                                 principal_point_y->getDouble() + p[PP_Y]);
 }
 
-void CameraParameters::image2field(
-    GVector::vector3d<double> &p_f, const GVector::vector2d<double> &p_i,
-    double z) const {
+void CameraParameters::image2ray(
+    GVector::vector3d<double> &origin, GVector::vector3d<double> &direction,
+    const GVector::vector2d<double> &p_i) const {
   // Undo scaling and offset
   GVector::vector2d<double> p_d(
       (p_i.x - principal_point_x->getDouble()) / focal_length->getDouble(),
@@ -257,22 +257,27 @@ void CameraParameters::image2field(
 
   Quaternion<double> q_field2cam_inv = q_field2cam;
   q_field2cam_inv.invert();
-  GVector::vector3d<double> v_in_w =
-      q_field2cam_inv.rotateVectorByQuaternion(v);
-  GVector::vector3d<double> zero_in_w =
-      q_field2cam_inv.rotateVectorByQuaternion(
+  direction = q_field2cam_inv.rotateVectorByQuaternion(v).norm();
+  origin = q_field2cam_inv.rotateVectorByQuaternion(
           GVector::vector3d<double>(0,0,0) - translation);
+}
+
+void CameraParameters::image2field(
+    GVector::vector3d<double> &p_f, const GVector::vector2d<double> &p_i,
+    double z) const {
+  GVector::vector3d<double> zero_in_w;
+  GVector::vector3d<double> v_in_w;
+  image2ray(zero_in_w,v_in_w,p_i);
 
   // Compute the the point where the rays intersects the field
   double t = GVector::ray_plane_intersect(
       GVector::vector3d<double>(0,0,z), GVector::vector3d<double>(0,0,1).norm(),
-      zero_in_w, v_in_w.norm());
+      zero_in_w, v_in_w);
 
   // Set p_f
-  p_f = zero_in_w + v_in_w.norm() * t;
+  p_f = zero_in_w + v_in_w * t;
 }
 
-
 double CameraParameters::calc_chisqr(
     std::vector<GVector::vector3d<double> > &p_f,
     std::vector<GVector::vector2d<double> > &p_i, Eigen::VectorXd &p,
@@ -815,3 +820,191 @@ void CameraParameters::AdditionalCalibrationInformation::addSettingsToList(
   list.addChild(cov_ls_y);
   list.addChild(pointSeparation);
 }
+
+CameraModel::CameraModel() :
+    width(0), height(0), focal_length(1.0), principal_point_x(0.0),
+    principal_point_y(0.0), distortion(0.0), lut_cols(0), lut_rows(0) {
+  for (int i = 0; i < 9; i++) {
+    field2cam[i] = cam2field[i] = (i % 4 == 0) ? 1.0 : 0.0;
+  }
+}
+
+bool CameraModel::update(
+    const CameraParameters & parameters, int _width, int _height) {
+  std::vector<double> k(11);
+  k[0] = parameters.focal_length->getDouble();
+  k[1] = parameters.principal_point_x->getDouble();
+  k[2] = parameters.principal_point_y->getDouble();
+  k[3] = parameters.distortion->getDouble();
+  k[4] = parameters.q0->getDouble();
+  k[5] = parameters.q1->getDouble();
+  k[6] = parameters.q2->getDouble();
+  k[7] = parameters.q3->getDouble();
+  k[8] = parameters.tx->getDouble();
+  k[9] = parameters.ty->getDouble();
+  k[10] = parameters.tz->getDouble();
+  if (k == key && _width == width && _height == height) return false;
+  key = k;
+  width = _width;
+  height = _height;
+
+  focal_length = k[0];
+  principal_point_x = k[1];
+  principal_point_y = k[2];
+  distortion = k[3];
+  translation.set(k[8], k[9], k[10]);
+
+  // compile the rotations into matrices by rotating the unit vectors
+  Quaternion<double> q_field2cam(k[4], k[5], k[6], k[7]);
+  q_field2cam.norm();
+  Quaternion<double> q_cam2field = q_field2cam;
+  q_cam2field.invert();
+  for (int c = 0; c < 3; c++) {
+    GVector::vector3d<double> e(c == 0, c == 1, c == 2);
+    GVector::vector3d<double> f = q_field2cam.rotateVectorByQuaternion(e);
+    GVector::vector3d<double> b = q_cam2field.rotateVectorByQuaternion(e);
+    field2cam[c] = f.x;
+    field2cam[3 + c] = f.y;
+    field2cam[6 + c] = f.z;
+    cam2field[c] = b.x;
+    cam2field[3 + c] = b.y;
+    cam2field[6 + c] = b.z;
+  }
+  world_location = q_cam2field.rotateVectorByQuaternion(
+      GVector::vector3d<double>(0,0,0) - translation);
+
+  buildLUT();
+  return true;
+}
+
+double CameraModel::radialDistortion(double ru) const {
+  if (distortion<=DBL_MIN)
+    return ru;
+  double a = distortion;
+  double b = -9.0*a*a*ru + a*sqrt(a*(12.0 + 81.0*a*ru*ru));
+  b = (b < 0.0) ? (-pow(b, 1.0 / 3.0)) : pow(b, 1.0 / 3.0);
+  return pow(2.0 / 3.0, 1.0 / 3.0) / b -
+      b / (pow(2.0 * 3.0 * 3.0, 1.0 / 3.0) * a);
+}
+
+double CameraModel::radialDistortionInv(double rd) const {
+  return rd*(1.0+rd*rd*distortion);
+}
+
+void CameraModel::field2image(
+    const GVector::vector3d<double> &p_f,
+    GVector::vector2d<double> &p_i) const {
+  // Transform the point into the coordinate system of the camera
+  const double * r = field2cam;
+  double cx = r[0]*p_f.x + r[1]*p_f.y + r[2]*p_f.z + translation.x;
+  double cy = r[3]*p_f.x + r[4]*p_f.y + r[5]*p_f.z + translation.y;
+  double cz = r[6]*p_f.x + r[7]*p_f.y + r[8]*p_f.z + translation.z;
+  GVector::vector2d<double> p_d(cx/cz, cy/cz);
+
+  // Apply distortion
+  if (distortion > DBL_MIN) {
+    double ru = p_d.length();
+    if (ru > 0.0) p_d *= radialDistortion(ru) / ru;
+  }
+
+  // Project onto the image plane using the instrinsic parameters
+  p_i.set(focal_length * p_d.x + principal_point_x,
+          focal_length * p_d.y + principal_point_y);
+}
+
+void CameraModel::image2ray(
+    GVector::vector3d<double> &origin, GVector::vector3d<double> &direction,
+    const GVector::vector2d<double> &p_i) const {
+  // Undo scaling and offset, then compensate for distortion
+  double ux = (p_i.x - principal_point_x) / focal_length;
+  double uy = (p_i.y - principal_point_y) / focal_length;
+  double s = 1.0 + (ux*ux + uy*uy) * distortion;
+  ux *= s;
+  uy *= s;
+
+  // Transform the ray (ux,uy,1) into world coordinates
+  const double * r = cam2field;
+  direction.set(r[0]*ux + r[1]*uy + r[2],
+                r[3]*ux + r[4]*uy + r[5],
+                r[6]*ux + r[7]*uy + r[8]);
+  direction = direction.norm();
+  origin = world_location;
+}
+
+void CameraModel::image2fieldExact(
+    GVector::vector3d<double> &p_f, const GVector::vector2d<double> &p_i,
+    double z) const {
+  GVector::vector3d<double> origin;
+  GVector::vector3d<double> direction;
+  image2ray(origin,direction,p_i);
+
+  // Compute the the point where the rays intersects the plane at height z
+  double t = GVector::ray_plane_intersect(
+      GVector::vector3d<double>(0,0,z), GVector::vector3d<double>(0,0,1),
+      origin, direction);
+  p_f = origin + direction * t;
+}
+
+void CameraModel::image2field(
+    GVector::vector3d<double> &p_f, const GVector::vector2d<double> &p_i,
+    double z) const {
+  if (lut_cols > 0 && p_i.x >= 0.0 && p_i.y >= 0.0) {
+    double fx = p_i.x / image2field_lut_step;
+    double fy = p_i.y / image2field_lut_step;
+    int ix = (int)fx;
+    int iy = (int)fy;
+    if (ix < lut_cols - 1 && iy < lut_rows - 1) {
+      const float * n00 = &lut_ground[(iy * lut_cols + ix) * 2];
+      const float * n10 = n00 + 2;
+      const float * n01 = n00 + lut_cols * 2;
+      const float * n11 = n01 + 2;
+      // nodes whose ray misses the field are NaN and use the exact path
+      double sum = n00[0] + n10[0] + n01[0] + n11[0];
+      if (sum == sum) {
+        double wx = fx - ix;
+        double wy = fy - iy;
+        double gx = (1.0 - wy) * ((1.0 - wx) * n00[0] + wx * n10[0]) +
+            wy * ((1.0 - wx) * n01[0] + wx * n11[0]);
+        double gy = (1.0 - wy) * ((1.0 - wx) * n00[1] + wx * n10[1]) +
+            wy * ((1.0 - wx) * n01[1] + wx * n11[1]);
+        // move from the ground plane along the ray up to height z
+        double s = (world_location.z - z) / world_location.z;
+        p_f.set(world_location.x + (gx - world_location.x) * s,
+                world_location.y + (gy - world_location.y) * s, z);
+        return;
+      }
+    }
+  }
+  image2fieldExact(p_f,p_i,z);
+}
+
+void CameraModel::buildLUT() {
+  if (world_location.z <= 0.0 || width <= 0 || height <= 0) {
+    // a camera below the field can't use the ground plane shortcut
+    lut_cols = lut_rows = 0;
+    lut_ground.clear();
+    return;
+  }
+
+  // nodes from 0 up to and including the first one at or beyond the
+  // image border, so that every point inside the image has 4 neighbors
+  lut_cols = (width + image2field_lut_step - 1) / image2field_lut_step + 1;
+  lut_rows = (height + image2field_lut_step - 1) / image2field_lut_step + 1;
+  lut_ground.resize(lut_cols * lut_rows * 2);
+  GVector::vector3d<double> origin;
+  GVector::vector3d<double> direction;
+  for (int y = 0; y < lut_rows; y++) {
+    for (int x = 0; x < lut_cols; x++) {
+      float * node = &lut_ground[(y * lut_cols + x) * 2];
+      image2ray(origin,direction,GVector::vector2d<double>(
+          x * image2field_lut_step, y * image2field_lut_step));
+      if (direction.z < 0.0) {
+        double t = -origin.z / direction.z;
+        node[0] = origin.x + direction.x * t;
+        node[1] = origin.y + direction.y * t;
+      } else {
+        node[0] = node[1] = std::numeric_limits<float>::quiet_NaN();
+      }
+    }
+  }
+}
@@ -81,6 +81,8 @@ public:
   GVector::vector3d<double> getWorldLocation();
   void field2image(const GVector::vector3d<double> &p_f, GVector::vector2d<double> &p_i) const;
   void image2field(GVector::vector3d< double >& p_f, const GVector::vector2d< double >& p_i, double z) const;
+  /// The viewing ray of an image point in field coordinates.
+  void image2ray(GVector::vector3d<double> &origin, GVector::vector3d<double> &direction, const GVector::vector2d<double> &p_i) const;
   void calibrate(std::vector<GVector::vector3d<double> > &p_f, std::vector<GVector::vector2d<double> > &p_i, int cal_type);
 
   double radialDistortion(double ru) const;  //apply radial distortion to (undistorted) radius ru and return distorted radius
@@ -120,6 +122,8 @@ public:
 
   std::vector<int> p_to_est;
 
+public:
+
   /*!
   \class AdditionalCalibrationInformation
   \brief Some additional data used for calibration
@@ -204,4 +208,80 @@ public:
   void reset();
 };
 
+/*!
+  \class CameraModel
+
+  \brief A compiled, read-only snapshot of a CameraParameters set.
+
+  The projections of CameraParameters read every parameter through the
+  mutex-guarded VarDouble getters and renormalize the rotation on each
+  call. CameraModel copies the parameters once into plain values and
+  compiles the rotation into matrices, so its projections do neither.
+  The vision stack takes one snapshot per frame, which also keeps the
+  calibration consistent for all plugins processing that frame.
+
+  For a given image size, the model additionally holds a lookup grid
+  with the ground plane intersection of every image2field_lut_step-th
+  pixel's ray, which image2field() interpolates.
+**/
+class CameraModel
+{
+public:
+  CameraModel();
+
+  /// Takes a new snapshot of \p parameters and rebuilds the lookup grid
+  /// for images of the given size (no grid if the size is 0). Returns
+  /// false and leaves the model untouched if neither the parameters nor
+  /// the size have changed since the last update.
+  bool update(const CameraParameters & parameters, int width=0, int height=0);
+
+  void field2image(const GVector::vector3d<double> &p_f, GVector::vector2d<double> &p_i) const;
+  /// Projects an image point onto the plane at height z. Uses the lookup
+  /// grid if it covers the point.
+  void image2field(GVector::vector3d<double> &p_f, const GVector::vector2d<double> &p_i, double z) const;
+  /// Same as image2field(), but always computed from the parameters.
+  void image2fieldExact(GVector::vector3d<double> &p_f, const GVector::vector2d<double> &p_i, double z) const;
+  /// The viewing ray of an image point in field coordinates.
+  void image2ray(GVector::vector3d<double> &origin, GVector::vector3d<double> &direction, const GVector::vector2d<double> &p_i) const;
+
+  double radialDistortion(double ru) const;
+  double radialDistortionInv(double rd) const;
+
+  const GVector::vector3d<double> & getWorldLocation() const {
+    return world_location;
+  }
+  GVector::vector2d<double> getPrincipalPoint() const {
+    return GVector::vector2d<double>(principal_point_x,principal_point_y);
+  }
+  double getFocalLength() const {
+    return focal_length;
+  }
+  double getDistortion() const {
+    return distortion;
+  }
+
+  /// distance of the lookup grid nodes in pixels
+  static const int image2field_lut_step = 4;
+
+protected:
+  std::vector<double> key; //the parameter values of the snapshot
+  int width;
+  int height;
+
+  double focal_length;
+  double principal_point_x;
+  double principal_point_y;
+  double distortion;
+  double field2cam[9]; //row-major rotation matrices of the normalized quaternion
+  double cam2field[9];
+  GVector::vector3d<double> translation;
+  GVector::vector3d<double> world_location;
+
+  int lut_cols;
+  int lut_rows;
+  std::vector<float> lut_ground; //x,y per node, NaN if the ray misses the field
+
+  void buildLUT();
+};
+
 #endif
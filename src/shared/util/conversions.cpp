@@ -25,6 +25,11 @@
 
 #include "conversions.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define CONVERSIONS_X86_SIMD
+  #include <immintrin.h>
+#endif
+
 using namespace std;
 // The following #define is there for the users who experience green/purple
 // images in the display. This seems to be a videocard driver problem.
@@ -95,174 +100,479 @@ void Conversions::uyv2rgb ( unsigned char *src,
   }
 }
 
-void Conversions::uyvy2rgb ( unsigned char *src,
-                             unsigned char *dest,
-                             int width,
-                             int height ) {
-  #ifndef NO_DC1394_CONVERSIONS
-    dc1394_convert_to_RGB8(src,dest, width, height, DC1394_BYTE_ORDER_UYVY,
-                       DC1394_COLOR_CODING_YUV422, 8);
-  #else
-  
-  int NumPixels = width*height;
-                             
-  register int max_i = ( NumPixels << 1 )-1;
-  //register int max_j = NumPixels + ( NumPixels << 1 ) -1;
-  register int i = 0;
-  register int j = 0;
-  register int y0, y1, u, v;
-  register int r, g, b;
-
-  while ( i < max_i ) {
-    u  = ( unsigned char ) src[i++] - 128;
-    y0 = ( unsigned char ) src[i++];
-    v  = ( unsigned char ) src[i++] - 128;
-    y1 = ( unsigned char ) src[i++];
-    yuv2rgb ( y0, u, v, r, g, b );
-    dest[j++] = r;
-    dest[j++] = g;
-    dest[j++] = b;
-    yuv2rgb ( y1, u, v, r, g, b );
-    dest[j++] = r;
-    dest[j++] = g;
-    dest[j++] = b;
+//-------------------------------------------------
+// YUV 4:2:2 <-> RGB conversions
+//
+// The scalar versions are the reference: they apply the fixed-point
+// formulas of yuv2rgb() and rgb2yuv() to every pixel. RGB to 4:2:2 uses
+// the rounded average of the chroma of both pixels of a pair.
+// The SSE2 and AVX2 versions compute the same formulas in 32 bit integer
+// lanes and are bit-exact to the scalar ones. They are selected at
+// runtime according to the features of the cpu.
+//-------------------------------------------------
+
+// byte offsets of the components within a 4 byte macro pixel
+#define UYVY_Y 1
+#define UYVY_U 0
+#define UYVY_V 2
+#define YUYV_Y 0
+#define YUYV_U 1
+#define YUYV_V 3
+
+static void yuv422ToRgbScalar(const unsigned char *src, unsigned char *dest, int pixels,
+                              int y_ofs, int u_ofs, int v_ofs, bool bgr)
+{
+  int r, g, b;
+  int ri = bgr ? 2 : 0;
+  int bi = bgr ? 0 : 2;
+  for (int i = 0; i < pixels; i += 2) {
+    int u = src[u_ofs] - 128;
+    int v = src[v_ofs] - 128;
+    Conversions::yuv2rgb(src[y_ofs], u, v, r, g, b);
+    dest[ri] = r;
+    dest[1]  = g;
+    dest[bi] = b;
+    Conversions::yuv2rgb(src[y_ofs+2], u, v, r, g, b);
+    dest[3+ri] = r;
+    dest[4]    = g;
+    dest[3+bi] = b;
+    src += 4;
+    dest += 6;
   }
-  #endif
 }
 
-void Conversions::yuyv2rgb ( unsigned char *src,
-                            unsigned char *dest,
-                            int width,
-                            int height ) {
-#ifndef NO_DC1394_CONVERSIONS
-    dc1394_convert_to_RGB8(src,dest, width, height, DC1394_BYTE_ORDER_YUYV,
-                           DC1394_COLOR_CODING_YUV422, 8);
-#else
-    
-    int NumPixels = width*height;
-    
-    register int max_i = ( NumPixels << 1 )-1;
-    //register int max_j = NumPixels + ( NumPixels << 1 ) -1;
-    register int i = 0;
-    register int j = 0;
-    register int y0, y1, u, v;
-    register int r, g, b;
-    
-    while ( i < max_i ) {
-        y0 = ( unsigned char ) src[i++];
-        u  = ( unsigned char ) src[i++];
-        y1 = ( unsigned char ) src[i++];
-        v  = ( unsigned char ) src[i++];
-        yuv2rgb ( y0, u, v, r, g, b );
-        dest[j++] = r;
-        dest[j++] = g;
-        dest[j++] = b;
-        yuv2rgb ( y1, u, v, r, g, b );
-        dest[j++] = r;
-        dest[j++] = g;
-        dest[j++] = b;
+static void rgbToYuv422Scalar(const unsigned char *src, unsigned char *dest, int pixels,
+                              int y_ofs, int u_ofs, int v_ofs)
+{
+  int y0, u0, v0, y1, u1, v1;
+  for (int i = 0; i < pixels; i += 2) {
+    Conversions::rgb2yuv(src[0], src[1], src[2], y0, u0, v0);
+    Conversions::rgb2yuv(src[3], src[4], src[5], y1, u1, v1);
+    dest[y_ofs]   = y0;
+    dest[y_ofs+2] = y1;
+    dest[u_ofs]   = (u0 + u1 + 1) >> 1;
+    dest[v_ofs]   = (v0 + v1 + 1) >> 1;
+    src += 6;
+    dest += 4;
+  }
+}
+
+static void swapYuv422Scalar(const unsigned char *src, unsigned char *dest, int pixels)
+{
+  for (int i = 0; i < pixels; i += 2) {
+    unsigned char a = src[0];
+    unsigned char b = src[2];
+    dest[0] = src[1];
+    dest[1] = a;
+    dest[2] = src[3];
+    dest[3] = b;
+    src += 4;
+    dest += 4;
+  }
+}
+
+#ifdef CONVERSIONS_X86_SIMD
+
+// 16-bit (u,v) pairs of 4 macro pixels -> per-pixel red/green/blue offsets
+#define CONV_SSE2_CHROMA(uv, r_ofs, g_ofs, b_ofs) { \
+  __m128i r32 = _mm_srai_epi32(_mm_madd_epi16(uv, _mm_set1_epi32(1436 << 16)), 10); \
+  __m128i g32 = _mm_srai_epi32(_mm_madd_epi16(uv, _mm_set1_epi32(352 | (731 << 16))), 10); \
+  __m128i b32 = _mm_srai_epi32(_mm_madd_epi16(uv, _mm_set1_epi32(1814)), 10); \
+  r32 = _mm_packs_epi32(r32, r32); \
+  g32 = _mm_packs_epi32(g32, g32); \
+  b32 = _mm_packs_epi32(b32, b32); \
+  r_ofs = _mm_unpacklo_epi16(r32, r32); \
+  g_ofs = _mm_unpacklo_epi16(g32, g32); \
+  b_ofs = _mm_unpacklo_epi16(b32, b32); \
+}
+
+__attribute__((target("sse2")))
+static void yuv422ToRgbSSE2(const unsigned char *src, unsigned char *dest, int pixels,
+                            bool uyvy, bool bgr)
+{
+  const __m128i low_bytes = _mm_set1_epi16(0x00ff);
+  const __m128i c128 = _mm_set1_epi16(128);
+  __attribute__((aligned(16))) unsigned char rgb[3][16];
+  unsigned char *r_plane = rgb[bgr ? 2 : 0];
+  unsigned char *b_plane = rgb[bgr ? 0 : 2];
+  int i = 0;
+  for (; i + 16 <= pixels; i += 16) {
+    __m128i out[3][2];
+    for (int half = 0; half < 2; half++) {
+      __m128i x = _mm_loadu_si128((const __m128i *)(src + 2*i + 16*half));
+      __m128i y, uv;
+      if (uyvy) {
+        y  = _mm_srli_epi16(x, 8);
+        uv = _mm_and_si128(x, low_bytes);
+      } else {
+        y  = _mm_and_si128(x, low_bytes);
+        uv = _mm_srli_epi16(x, 8);
+      }
+      uv = _mm_sub_epi16(uv, c128);
+      __m128i r_ofs, g_ofs, b_ofs;
+      CONV_SSE2_CHROMA(uv, r_ofs, g_ofs, b_ofs);
+      out[0][half] = _mm_add_epi16(y, r_ofs);
+      out[1][half] = _mm_sub_epi16(y, g_ofs);
+      out[2][half] = _mm_add_epi16(y, b_ofs);
     }
-#endif
+    //saturation is the same as bound(...,0,255):
+    _mm_store_si128((__m128i *)r_plane, _mm_packus_epi16(out[0][0], out[0][1]));
+    _mm_store_si128((__m128i *)rgb[1],  _mm_packus_epi16(out[1][0], out[1][1]));
+    _mm_store_si128((__m128i *)b_plane, _mm_packus_epi16(out[2][0], out[2][1]));
+    unsigned char *d = dest + 3*i;
+    for (int k = 0; k < 16; k++) {
+      d[0] = rgb[0][k];
+      d[1] = rgb[1][k];
+      d[2] = rgb[2][k];
+      d += 3;
+    }
+  }
+  yuv422ToRgbScalar(src + 2*i, dest + 3*i, pixels - i,
+                    uyvy ? UYVY_Y : YUYV_Y, uyvy ? UYVY_U : YUYV_U, uyvy ? UYVY_V : YUYV_V, bgr);
 }
 
+// 8 pixels of 16-bit r, g, b -> 16 bytes of 4:2:2
+__attribute__((target("sse2")))
+static inline __m128i rgbToYuv422SSE2Block(__m128i r, __m128i g, __m128i b, bool uyvy)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i rg_lo = _mm_unpacklo_epi16(r, g);
+  __m128i rg_hi = _mm_unpackhi_epi16(r, g);
+  __m128i b_lo  = _mm_unpacklo_epi16(b, zero);
+  __m128i b_hi  = _mm_unpackhi_epi16(b, zero);
+  const __m128i y_rg = _mm_set1_epi32(306 | (601 << 16));
+  const __m128i u_rg = _mm_set1_epi32((int)0xFEACFF54);
+  const __m128i v_rg = _mm_set1_epi32((int)0xFE530200);
+  const __m128i y_b  = _mm_set1_epi32(117);
+  const __m128i u_b  = _mm_set1_epi32(512);
+  const __m128i v_b  = _mm_set1_epi32(0xFFAD);
+  const __m128i c128 = _mm_set1_epi32(128);
+  __m128i y = _mm_packs_epi32(
+    _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(rg_lo, y_rg), _mm_madd_epi16(b_lo, y_b)), 10),
+    _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(rg_hi, y_rg), _mm_madd_epi16(b_hi, y_b)), 10));
+  __m128i u = _mm_packs_epi32(
+    _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(rg_lo, u_rg), _mm_madd_epi16(b_lo, u_b)), 10), c128),
+    _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(rg_hi, u_rg), _mm_madd_epi16(b_hi, u_b)), 10), c128));
+  __m128i v = _mm_packs_epi32(
+    _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(rg_lo, v_rg), _mm_madd_epi16(b_lo, v_b)), 10), c128),
+    _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(rg_hi, v_rg), _mm_madd_epi16(b_hi, v_b)), 10), c128));
+  //bound(...,0,255) of rgb2yuv()
+  const __m128i c255 = _mm_set1_epi16(255);
+  y = _mm_min_epi16(_mm_max_epi16(y, zero), c255);
+  u = _mm_min_epi16(_mm_max_epi16(u, zero), c255);
+  v = _mm_min_epi16(_mm_max_epi16(v, zero), c255);
+  //rounded average of the chroma of each pixel pair
+  const __m128i ones = _mm_set1_epi16(1);
+  const __m128i one32 = _mm_set1_epi32(1);
+  __m128i u_avg = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(u, ones), one32), 1);
+  __m128i v_avg = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(v, ones), one32), 1);
+  __m128i uv = _mm_or_si128(u_avg, _mm_slli_epi32(v_avg, 16));
+  if (uyvy) return _mm_or_si128(uv, _mm_slli_epi16(y, 8));
+  return _mm_or_si128(y, _mm_slli_epi16(uv, 8));
+}
 
-void Conversions::rgb2uyvy (unsigned char *src, unsigned char *dest, int width, int height)
+__attribute__((target("sse2")))
+static void rgbToYuv422SSE2(const unsigned char *src, unsigned char *dest, int pixels, bool uyvy)
 {
-#ifndef NO_DC1394_CONVERSIONS
-    dc1394_convert_to_RGB8(src,dest, width, height, DC1394_BYTE_ORDER_UYVY,
-                           DC1394_COLOR_CODING_RGB8, 8);
-#else
-    
-    int NumPixels = width*height;
-    
-    register int max_i = ( NumPixels << 1 )-1;
-    //register int max_j = NumPixels + ( NumPixels << 1 ) -1;
-    register int i = 0;
-    register int j = 0;
-    register int y0, y1, u, v;
-    register int r, g, b;
-    
-    while ( i < max_i ) {
-        r = ( unsigned char ) src[i++];
-        g = ( unsigned char ) src[i++];
-        b = ( unsigned char ) src[i++];
-        rgb2yuv ( r, g, b, y0, u, v );
-        r = ( unsigned char ) src[i++];
-        g = ( unsigned char ) src[i++];
-        b = ( unsigned char ) src[i++];
-        rgb2yuv ( r, g, b, y1, u, v );
-        dest[j++] = u+128;
-        dest[j++] = y0;
-        dest[j++] = v+128;
-        dest[j++] = y1;
+  int i = 0;
+  for (; i + 8 <= pixels; i += 8) {
+    //SSE2 has no byte shuffle, gather the channels directly into 16 bit lanes
+    const unsigned char *s = src + 3*i;
+    __m128i r = _mm_setr_epi16(s[0], s[3], s[6], s[9],  s[12], s[15], s[18], s[21]);
+    __m128i g = _mm_setr_epi16(s[1], s[4], s[7], s[10], s[13], s[16], s[19], s[22]);
+    __m128i b = _mm_setr_epi16(s[2], s[5], s[8], s[11], s[14], s[17], s[20], s[23]);
+    __m128i out = rgbToYuv422SSE2Block(r, g, b, uyvy);
+    _mm_storeu_si128((__m128i *)(dest + 2*i), out);
+  }
+  rgbToYuv422Scalar(src + 3*i, dest + 2*i, pixels - i,
+                    uyvy ? UYVY_Y : YUYV_Y, uyvy ? UYVY_U : YUYV_U, uyvy ? UYVY_V : YUYV_V);
+}
+
+__attribute__((target("sse2")))
+static void swapYuv422SSE2(const unsigned char *src, unsigned char *dest, int pixels)
+{
+  int i = 0;
+  for (; i + 8 <= pixels; i += 8) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(src + 2*i));
+    _mm_storeu_si128((__m128i *)(dest + 2*i), _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8)));
+  }
+  swapYuv422Scalar(src + 2*i, dest + 2*i, pixels - i);
+}
+
+// planar 16 x r, g, b -> 48 bytes of packed rgb
+__attribute__((target("avx2")))
+static inline void interleaveRgbAVX2(__m128i r, __m128i g, __m128i b, unsigned char *dest)
+{
+  const __m128i r0 = _mm_setr_epi8( 0,-1,-1, 1,-1,-1, 2,-1,-1, 3,-1,-1, 4,-1,-1, 5);
+  const __m128i g0 = _mm_setr_epi8(-1, 0,-1,-1, 1,-1,-1, 2,-1,-1, 3,-1,-1, 4,-1,-1);
+  const __m128i b0 = _mm_setr_epi8(-1,-1, 0,-1,-1, 1,-1,-1, 2,-1,-1, 3,-1,-1, 4,-1);
+  const __m128i r1 = _mm_setr_epi8(-1,-1, 6,-1,-1, 7,-1,-1, 8,-1,-1, 9,-1,-1,10,-1);
+  const __m128i g1 = _mm_setr_epi8( 5,-1,-1, 6,-1,-1, 7,-1,-1, 8,-1,-1, 9,-1,-1,10);
+  const __m128i b1 = _mm_setr_epi8(-1, 5,-1,-1, 6,-1,-1, 7,-1,-1, 8,-1,-1, 9,-1,-1);
+  const __m128i r2 = _mm_setr_epi8(-1,11,-1,-1,12,-1,-1,13,-1,-1,14,-1,-1,15,-1,-1);
+  const __m128i g2 = _mm_setr_epi8(-1,-1,11,-1,-1,12,-1,-1,13,-1,-1,14,-1,-1,15,-1);
+  const __m128i b2 = _mm_setr_epi8(10,-1,-1,11,-1,-1,12,-1,-1,13,-1,-1,14,-1,-1,15);
+  _mm_storeu_si128((__m128i *)dest, _mm_or_si128(_mm_or_si128(
+    _mm_shuffle_epi8(r, r0), _mm_shuffle_epi8(g, g0)), _mm_shuffle_epi8(b, b0)));
+  _mm_storeu_si128((__m128i *)(dest + 16), _mm_or_si128(_mm_or_si128(
+    _mm_shuffle_epi8(r, r1), _mm_shuffle_epi8(g, g1)), _mm_shuffle_epi8(b, b1)));
+  _mm_storeu_si128((__m128i *)(dest + 32), _mm_or_si128(_mm_or_si128(
+    _mm_shuffle_epi8(r, r2), _mm_shuffle_epi8(g, g2)), _mm_shuffle_epi8(b, b2)));
+}
+
+// 48 bytes of packed rgb -> planar 16 x r, g, b
+__attribute__((target("avx2")))
+static inline void deinterleaveRgbAVX2(const unsigned char *src, __m128i & r, __m128i & g, __m128i & b)
+{
+  const __m128i r0 = _mm_setr_epi8( 0, 3, 6, 9,12,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+  const __m128i g0 = _mm_setr_epi8( 1, 4, 7,10,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+  const __m128i b0 = _mm_setr_epi8( 2, 5, 8,11,14,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+  const __m128i r1 = _mm_setr_epi8(-1,-1,-1,-1,-1,-1, 2, 5, 8,11,14,-1,-1,-1,-1,-1);
+  const __m128i g1 = _mm_setr_epi8(-1,-1,-1,-1,-1, 0, 3, 6, 9,12,15,-1,-1,-1,-1,-1);
+  const __m128i b1 = _mm_setr_epi8(-1,-1,-1,-1,-1, 1, 4, 7,10,13,-1,-1,-1,-1,-1,-1);
+  const __m128i r2 = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 1, 4, 7,10,13);
+  const __m128i g2 = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 2, 5, 8,11,14);
+  const __m128i b2 = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 0, 3, 6, 9,12,15);
+  __m128i x0 = _mm_loadu_si128((const __m128i *)src);
+  __m128i x1 = _mm_loadu_si128((const __m128i *)(src + 16));
+  __m128i x2 = _mm_loadu_si128((const __m128i *)(src + 32));
+  r = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, r0), _mm_shuffle_epi8(x1, r1)), _mm_shuffle_epi8(x2, r2));
+  g = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, g0), _mm_shuffle_epi8(x1, g1)), _mm_shuffle_epi8(x2, g2));
+  b = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(x0, b0), _mm_shuffle_epi8(x1, b1)), _mm_shuffle_epi8(x2, b2));
+}
+
+__attribute__((target("avx2")))
+static void yuv422ToRgbAVX2(const unsigned char *src, unsigned char *dest, int pixels,
+                            bool uyvy, bool bgr)
+{
+  const __m256i low_bytes = _mm256_set1_epi16(0x00ff);
+  const __m256i c128 = _mm256_set1_epi16(128);
+  const __m256i r_coef = _mm256_set1_epi32(1436 << 16);
+  const __m256i g_coef = _mm256_set1_epi32(352 | (731 << 16));
+  const __m256i b_coef = _mm256_set1_epi32(1814);
+  int i = 0;
+  for (; i + 32 <= pixels; i += 32) {
+    __m256i out[3][2];
+    for (int half = 0; half < 2; half++) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)(src + 2*i + 32*half));
+      __m256i y, uv;
+      if (uyvy) {
+        y  = _mm256_srli_epi16(x, 8);
+        uv = _mm256_and_si256(x, low_bytes);
+      } else {
+        y  = _mm256_and_si256(x, low_bytes);
+        uv = _mm256_srli_epi16(x, 8);
+      }
+      uv = _mm256_sub_epi16(uv, c128);
+      //all of these operate within 128 bit lanes, just like the SSE2 version
+      __m256i r32 = _mm256_srai_epi32(_mm256_madd_epi16(uv, r_coef), 10);
+      __m256i g32 = _mm256_srai_epi32(_mm256_madd_epi16(uv, g_coef), 10);
+      __m256i b32 = _mm256_srai_epi32(_mm256_madd_epi16(uv, b_coef), 10);
+      r32 = _mm256_packs_epi32(r32, r32);
+      g32 = _mm256_packs_epi32(g32, g32);
+      b32 = _mm256_packs_epi32(b32, b32);
+      out[0][half] = _mm256_add_epi16(y, _mm256_unpacklo_epi16(r32, r32));
+      out[1][half] = _mm256_sub_epi16(y, _mm256_unpacklo_epi16(g32, g32));
+      out[2][half] = _mm256_add_epi16(y, _mm256_unpacklo_epi16(b32, b32));
     }
+    //packing interleaves the 128 bit lanes of both halves, undo that:
+    __m256i r = _mm256_permute4x64_epi64(_mm256_packus_epi16(out[0][0], out[0][1]), 0xD8);
+    __m256i g = _mm256_permute4x64_epi64(_mm256_packus_epi16(out[1][0], out[1][1]), 0xD8);
+    __m256i b = _mm256_permute4x64_epi64(_mm256_packus_epi16(out[2][0], out[2][1]), 0xD8);
+    if (bgr) {
+      __m256i t = r;
+      r = b;
+      b = t;
+    }
+    interleaveRgbAVX2(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g),
+                      _mm256_castsi256_si128(b), dest + 3*i);
+    interleaveRgbAVX2(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1),
+                      _mm256_extracti128_si256(b, 1), dest + 3*i + 48);
+  }
+  yuv422ToRgbSSE2(src + 2*i, dest + 3*i, pixels - i, uyvy, bgr);
+}
+
+__attribute__((target("avx2")))
+static void rgbToYuv422AVX2(const unsigned char *src, unsigned char *dest, int pixels, bool uyvy)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i y_rg = _mm256_set1_epi32(306 | (601 << 16));
+  const __m256i u_rg = _mm256_set1_epi32((int)0xFEACFF54);
+  const __m256i v_rg = _mm256_set1_epi32((int)0xFE530200);
+  const __m256i y_b  = _mm256_set1_epi32(117);
+  const __m256i u_b  = _mm256_set1_epi32(512);
+  const __m256i v_b  = _mm256_set1_epi32(0xFFAD);
+  const __m256i c128 = _mm256_set1_epi32(128);
+  const __m256i c255 = _mm256_set1_epi16(255);
+  const __m256i ones = _mm256_set1_epi16(1);
+  const __m256i one32 = _mm256_set1_epi32(1);
+  int i = 0;
+  for (; i + 16 <= pixels; i += 16) {
+    __m128i r8, g8, b8;
+    deinterleaveRgbAVX2(src + 3*i, r8, g8, b8);
+    __m256i r = _mm256_cvtepu8_epi16(r8);
+    __m256i g = _mm256_cvtepu8_epi16(g8);
+    __m256i b = _mm256_cvtepu8_epi16(b8);
+    __m256i rg_lo = _mm256_unpacklo_epi16(r, g);
+    __m256i rg_hi = _mm256_unpackhi_epi16(r, g);
+    __m256i b_lo  = _mm256_unpacklo_epi16(b, zero);
+    __m256i b_hi  = _mm256_unpackhi_epi16(b, zero);
+    //packs_epi32 restores the pixel order of the in-lane unpacks
+    __m256i y = _mm256_packs_epi32(
+      _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(rg_lo, y_rg), _mm256_madd_epi16(b_lo, y_b)), 10),
+      _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(rg_hi, y_rg), _mm256_madd_epi16(b_hi, y_b)), 10));
+    __m256i u = _mm256_packs_epi32(
+      _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(rg_lo, u_rg), _mm256_madd_epi16(b_lo, u_b)), 10), c128),
+      _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(rg_hi, u_rg), _mm256_madd_epi16(b_hi, u_b)), 10), c128));
+    __m256i v = _mm256_packs_epi32(
+      _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(rg_lo, v_rg), _mm256_madd_epi16(b_lo, v_b)), 10), c128),
+      _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(rg_hi, v_rg), _mm256_madd_epi16(b_hi, v_b)), 10), c128));
+    y = _mm256_min_epi16(_mm256_max_epi16(y, zero), c255);
+    u = _mm256_min_epi16(_mm256_max_epi16(u, zero), c255);
+    v = _mm256_min_epi16(_mm256_max_epi16(v, zero), c255);
+    __m256i u_avg = _mm256_srli_epi32(_mm256_add_epi32(_mm256_madd_epi16(u, ones), one32), 1);
+    __m256i v_avg = _mm256_srli_epi32(_mm256_add_epi32(_mm256_madd_epi16(v, ones), one32), 1);
+    __m256i uv = _mm256_or_si256(u_avg, _mm256_slli_epi32(v_avg, 16));
+    __m256i out;
+    if (uyvy) {
+      out = _mm256_or_si256(uv, _mm256_slli_epi16(y, 8));
+    } else {
+      out = _mm256_or_si256(y, _mm256_slli_epi16(uv, 8));
+    }
+    _mm256_storeu_si256((__m256i *)(dest + 2*i), out);
+  }
+  rgbToYuv422SSE2(src + 3*i, dest + 2*i, pixels - i, uyvy);
+}
+
+__attribute__((target("avx2")))
+static void swapYuv422AVX2(const unsigned char *src, unsigned char *dest, int pixels)
+{
+  int i = 0;
+  for (; i + 16 <= pixels; i += 16) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(src + 2*i));
+    _mm256_storeu_si256((__m256i *)(dest + 2*i), _mm256_or_si256(_mm256_slli_epi16(x, 8), _mm256_srli_epi16(x, 8)));
+  }
+  swapYuv422SSE2(src + 2*i, dest + 2*i, pixels - i);
+}
+
+#endif
+
+int Conversions::implementation = -1;
+
+Conversions::Implementation Conversions::getBestImplementation()
+{
+#ifdef CONVERSIONS_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return IMPL_AVX2;
+  if (__builtin_cpu_supports("sse2")) return IMPL_SSE2;
 #endif
+  return IMPL_SCALAR;
+}
 
+Conversions::Implementation Conversions::getImplementation()
+{
+  if (implementation < 0) implementation = getBestImplementation();
+  return (Implementation)implementation;
 }
 
-void Conversions::rgb2yuyv (unsigned char *src, unsigned char *dest, int width, int height)
+Conversions::Implementation Conversions::setImplementation(Implementation impl)
 {
-#ifndef NO_DC1394_CONVERSIONS
-    dc1394_convert_to_RGB8(src,dest, width, height, DC1394_BYTE_ORDER_YUYV,
-                           DC1394_COLOR_CODING_RGB8, 8);
-#else
-    
-    int NumPixels = width*height;
-    
-    register int max_i = ( NumPixels << 1 )-1;
-    //register int max_j = NumPixels + ( NumPixels << 1 ) -1;
-    register int i = 0;
-    register int j = 0;
-    register int y0, y1, u, v;
-    register int r, g, b;
-    
-    rgb2yuv(int r, int g, int b, int & y, int & u, int & v
-    
-    while ( i < max_i ) {
-        r = ( unsigned char ) src[i++];
-        g = ( unsigned char ) src[i++];
-        b = ( unsigned char ) src[i++];
-        rgb2yuv ( r, g, b, y0, u, v );
-        r = ( unsigned char ) src[i++];
-        g = ( unsigned char ) src[i++];
-        b = ( unsigned char ) src[i++];
-        rgb2yuv ( r, g, b, y1, u, v );
-        dest[j++] = y0;
-        dest[j++] = u+128;
-        dest[j++] = y1;
-        dest[j++] = v+128;
-    }
+  Implementation best = getBestImplementation();
+  implementation = (impl > best) ? best : impl;
+  return (Implementation)implementation;
+}
+
+const char * Conversions::implementationName(Implementation impl)
+{
+  switch (impl) {
+    case IMPL_SSE2: return "SSE2";
+    case IMPL_AVX2: return "AVX2";
+    default: return "scalar";
+  }
+}
+
+static void yuv422ToRgb(unsigned char *src, unsigned char *dest, int pixels, bool uyvy, bool bgr)
+{
+  switch (Conversions::getImplementation()) {
+#ifdef CONVERSIONS_X86_SIMD
+    case Conversions::IMPL_AVX2:
+      yuv422ToRgbAVX2(src, dest, pixels, uyvy, bgr);
+      break;
+    case Conversions::IMPL_SSE2:
+      yuv422ToRgbSSE2(src, dest, pixels, uyvy, bgr);
+      break;
 #endif
+    default:
+      yuv422ToRgbScalar(src, dest, pixels,
+                        uyvy ? UYVY_Y : YUYV_Y, uyvy ? UYVY_U : YUYV_U, uyvy ? UYVY_V : YUYV_V, bgr);
+  }
 }
 
-void Conversions::uyvy2bgr ( unsigned char *src,
-                             unsigned char *dest,
-                             int width,
-                             int height ) {
+static void rgbToYuv422(unsigned char *src, unsigned char *dest, int pixels, bool uyvy)
+{
+  switch (Conversions::getImplementation()) {
+#ifdef CONVERSIONS_X86_SIMD
+    case Conversions::IMPL_AVX2:
+      rgbToYuv422AVX2(src, dest, pixels, uyvy);
+      break;
+    case Conversions::IMPL_SSE2:
+      rgbToYuv422SSE2(src, dest, pixels, uyvy);
+      break;
+#endif
+    default:
+      rgbToYuv422Scalar(src, dest, pixels,
+                        uyvy ? UYVY_Y : YUYV_Y, uyvy ? UYVY_U : YUYV_U, uyvy ? UYVY_V : YUYV_V);
+  }
+}
 
-  int NumPixels = width*height;
+void Conversions::uyvy2rgb (unsigned char *src, unsigned char *dest, int width, int height)
+{
+  yuv422ToRgb(src, dest, width*height, true, false);
+}
 
-  register int i = ( NumPixels << 1 )-1;
-  register int j = NumPixels + ( NumPixels << 1 ) -1;
-  register int y0, y1, u, v;
-  int r, g, b;
+void Conversions::yuyv2rgb (unsigned char *src, unsigned char *dest, int width, int height)
+{
+  yuv422ToRgb(src, dest, width*height, false, false);
+}
 
-  while ( i > 0 ) {
-    y1 = ( unsigned char ) src[i--];
-    v  = ( unsigned char ) src[i--] - 128;
-    y0 = ( unsigned char ) src[i--];
-    u  = ( unsigned char ) src[i--] - 128;
-    yuv2rgb ( y1, u, v, r, g, b );
-    dest[j--] = r;
-    dest[j--] = g;
-    dest[j--] = b;
-    yuv2rgb ( y0, u, v, r, g, b );
-    dest[j--] = r;
-    dest[j--] = g;
-    dest[j--] = b;
+void Conversions::uyvy2bgr (unsigned char *src, unsigned char *dest, int width, int height)
+{
+  yuv422ToRgb(src, dest, width*height, true, true);
+}
+
+void Conversions::rgb2uyvy (unsigned char *src, unsigned char *dest, int width, int height)
+{
+  rgbToYuv422(src, dest, width*height, true);
+}
+
+void Conversions::rgb2yuyv (unsigned char *src, unsigned char *dest, int width, int height)
+{
+  rgbToYuv422(src, dest, width*height, false);
+}
+
+void Conversions::yuyv2uyvy (unsigned char *src, unsigned char *dest, int width, int height)
+{
+  int pixels = width*height;
+  switch (getImplementation()) {
+#ifdef CONVERSIONS_X86_SIMD
+    case IMPL_AVX2:
+      swapYuv422AVX2(src, dest, pixels);
+      break;
+    case IMPL_SSE2:
+      swapYuv422SSE2(src, dest, pixels);
+      break;
+#endif
+    default:
+      swapYuv422Scalar(src, dest, pixels);
   }
 }
 
+void Conversions::uyvy2yuyv (unsigned char *src, unsigned char *dest, int width, int height)
+{
+  //swapping the bytes of every 16 bit word works both ways
+  yuyv2uyvy(src, dest, width, height);
+}
+
 void Conversions::uyyvyy2rgb ( unsigned char *src,
                                unsigned char *dest,
                                int width,
@@ -24,16 +24,12 @@
 
 #include "util.h"
 #include "colors.h"
-#ifndef NO_DC1394_CONVERSIONS
-  #include <dc1394/conversions.h>
-#endif
 
 //#include "ccvt.h"
 
 //-------------------------------------------------
-//NOTE full image conversion routines (yuv->rgb) in this file
-//     have been measured to be REALLY slow
-//     Some functions will use dc1394 for speedup (if available)
+//NOTE the yuv422 <-> rgb conversions in this file use SSE2 or
+//     AVX2 if available, the others are plain per-pixel loops
 //-------------------------------------------------
 
 
@@ -95,11 +91,29 @@ inline static yuv rgb2yuv(rgb const &in)
 }
 
 
-//DC1394 accelerated:
+// implementations of the accelerated conversions below; all of them
+// produce bit-identical results.
+enum Implementation {
+  IMPL_SCALAR=0,
+  IMPL_SSE2,
+  IMPL_AVX2
+};
+/// the best implementation supported by this cpu
+static Implementation getBestImplementation();
+/// the implementation currently in use, by default the best one
+static Implementation getImplementation();
+/// selects \p impl, or the best supported one below it. Returns the selection.
+static Implementation setImplementation(Implementation impl);
+static const char * implementationName(Implementation impl);
+
+//SIMD accelerated:
 static void uyvy2rgb (unsigned char *src, unsigned char *dest, int width, int height);
 static void yuyv2rgb ( unsigned char *src, unsigned char *dest, int width, int height);
+static void uyvy2bgr (unsigned char *src, unsigned char *dest, int width, int height);
 static void rgb2uyvy (unsigned char *src, unsigned char *dest, int width, int height);
 static void rgb2yuyv ( unsigned char *src, unsigned char *dest, int width, int height);
+static void yuyv2uyvy (unsigned char *src, unsigned char *dest, int width, int height);
+static void uyvy2yuyv (unsigned char *src, unsigned char *dest, int width, int height);
     
 //others (non-accelerated):
 static void uyyvyy2rgb (unsigned char *src, unsigned char *dest, int width, int height);
@@ -108,9 +122,10 @@ static void bgr2rgb (unsigned char *src, unsigned char *dest, int width, int hei
 static void rgb2bgr (unsigned char *src, unsigned char *dest, int width, int height);
 static void rgb482rgb (unsigned char *src, unsigned char *dest, int width, int height);
 static void uyv2rgb (unsigned char *src, unsigned char *dest, int width, int height);
-static void uyvy2bgr (unsigned char *src, unsigned char *dest, int width, int height);
 static void y162rgb (unsigned char *src, unsigned char *dest, int width, int height, int bits);
 
+private:
+static int implementation;
 
 };
 
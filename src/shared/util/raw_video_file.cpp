@@ -0,0 +1,234 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    raw_video_file.cpp
+  \brief   C++ Implementation: RawVideoReader, RawVideoWriter
+  \author  Author Name, 2026
+*/
+//========================================================================
+
+#include "raw_video_file.h"
+#include "rawimage.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+static const char raw_video_magic[8] = { 'S', 'S', 'L', 'R', 'A', 'W', 'V', '1' };
+
+uint32_t RawVideoFile::toFileFormat(ColorFormat fmt) {
+  switch (fmt) {
+    case COLOR_RGB8:        return 1;
+    case COLOR_YUV422_UYVY: return 2;
+    case COLOR_YUV422_YUYV: return 3;
+    case COLOR_MONO8:       return 4;
+    case COLOR_RAW8:        return 5;
+    default:                return 0;
+  }
+}
+
+ColorFormat RawVideoFile::fromFileFormat(uint32_t fmt) {
+  switch (fmt) {
+    case 1:  return COLOR_RGB8;
+    case 2:  return COLOR_YUV422_UYVY;
+    case 3:  return COLOR_YUV422_YUYV;
+    case 4:  return COLOR_MONO8;
+    case 5:  return COLOR_RAW8;
+    default: return COLOR_UNDEFINED;
+  }
+}
+
+RawVideoReader::RawVideoReader() {
+  base=0;
+  length=0;
+  header=0;
+  index=0;
+  format=COLOR_UNDEFINED;
+  frame_bytes=0;
+}
+
+RawVideoReader::~RawVideoReader() {
+  close();
+}
+
+bool RawVideoReader::open(const string & filename) {
+  close();
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr,"RawVideoReader: cannot open %s: %s\n", filename.c_str(), strerror(errno));
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(RawVideoFile::Header)) {
+    fprintf(stderr,"RawVideoReader: %s is too short\n", filename.c_str());
+    ::close(fd);
+    return false;
+  }
+  void * map = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    fprintf(stderr,"RawVideoReader: cannot map %s: %s\n", filename.c_str(), strerror(errno));
+    return false;
+  }
+  base = (unsigned char *)map;
+  length = st.st_size;
+  header = (const RawVideoFile::Header *)base;
+  format = RawVideoFile::fromFileFormat(header->format);
+  frame_bytes = RawImage::computeImageSize(format, header->width * header->height);
+
+  const char * error = 0;
+  if (memcmp(header->magic, raw_video_magic, sizeof(raw_video_magic)) != 0) {
+    error = "not a raw video file";
+  } else if (format == COLOR_UNDEFINED || header->width == 0 || header->height == 0) {
+    error = "unsupported frame format";
+  } else if (header->index_offset < sizeof(RawVideoFile::Header) ||
+             header->index_offset + (uint64_t)header->frame_count * sizeof(RawVideoFile::IndexEntry) > length) {
+    error = "index is missing (the recording was not closed?)";
+  } else {
+    index = (const RawVideoFile::IndexEntry *)(base + header->index_offset);
+    for (uint32_t i = 0; i < header->frame_count; i++) {
+      if (index[i].offset + frame_bytes > header->index_offset) {
+        error = "index points outside of the frame data";
+        break;
+      }
+    }
+  }
+  if (error != 0) {
+    fprintf(stderr,"RawVideoReader: %s: %s\n", filename.c_str(), error);
+    close();
+    return false;
+  }
+  //playback mostly moves forward:
+  madvise(base, length, MADV_SEQUENTIAL);
+  return true;
+}
+
+void RawVideoReader::close() {
+  if (base != 0) munmap(base, length);
+  base=0;
+  length=0;
+  header=0;
+  index=0;
+  format=COLOR_UNDEFINED;
+  frame_bytes=0;
+}
+
+int RawVideoReader::getFrameCount() const {
+  return header != 0 ? (int)header->frame_count : 0;
+}
+
+int RawVideoReader::getWidth() const {
+  return header != 0 ? (int)header->width : 0;
+}
+
+int RawVideoReader::getHeight() const {
+  return header != 0 ? (int)header->height : 0;
+}
+
+int RawVideoReader::getBayerPattern() const {
+  return header != 0 ? (int)header->bayer_pattern : 0;
+}
+
+unsigned char * RawVideoReader::getFrameData(int i) const {
+  if (index == 0 || i < 0 || i >= getFrameCount()) return 0;
+  return base + index[i].offset;
+}
+
+double RawVideoReader::getFrameTime(int i) const {
+  if (index == 0 || i < 0 || i >= getFrameCount()) return 0.0;
+  return index[i].time;
+}
+
+void RawVideoReader::prefetch(int i) const {
+  if (index == 0 || i < 0 || i >= getFrameCount()) return;
+  //madvise needs a page aligned start:
+  uintptr_t page = sysconf(_SC_PAGESIZE);
+  uintptr_t start = (uintptr_t)(base + index[i].offset) & ~(page - 1);
+  uintptr_t end = (uintptr_t)(base + index[i].offset) + frame_bytes;
+  madvise((void *)start, end - start, MADV_WILLNEED);
+}
+
+RawVideoWriter::RawVideoWriter() {
+  file=0;
+  position=0;
+  frame_bytes=0;
+  memset(&header, 0, sizeof(header));
+}
+
+RawVideoWriter::~RawVideoWriter() {
+  close();
+}
+
+bool RawVideoWriter::pad(size_t bytes) {
+  static const unsigned char zeros[RawVideoFile::alignment] = { 0 };
+  if (bytes == 0) return true;
+  position += bytes;
+  return fwrite(zeros, bytes, 1, file) == 1;
+}
+
+bool RawVideoWriter::open(const string & filename, ColorFormat fmt, int width, int height, int bayer_pattern) {
+  close();
+  if (RawVideoFile::toFileFormat(fmt) == 0) {
+    fprintf(stderr,"RawVideoWriter: cannot store %s frames\n", Colors::colorFormatToString(fmt).c_str());
+    return false;
+  }
+  file = fopen(filename.c_str(), "wb");
+  if (file == 0) {
+    fprintf(stderr,"RawVideoWriter: cannot create %s: %s\n", filename.c_str(), strerror(errno));
+    return false;
+  }
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, raw_video_magic, sizeof(raw_video_magic));
+  header.width = width;
+  header.height = height;
+  header.format = RawVideoFile::toFileFormat(fmt);
+  header.bayer_pattern = bayer_pattern;
+  frame_bytes = RawImage::computeImageSize(fmt, width * height);
+  index.clear();
+  //the header is rewritten by close(), once the index position is known
+  position = sizeof(header);
+  if (fwrite(&header, sizeof(header), 1, file) != 1) {
+    fclose(file);
+    file = 0;
+    return false;
+  }
+  return true;
+}
+
+bool RawVideoWriter::appendFrame(const unsigned char * data, double time) {
+  if (file == 0) return false;
+  RawVideoFile::IndexEntry entry;
+  entry.offset = position;
+  entry.time = time;
+  if (fwrite(data, frame_bytes, 1, file) != 1) return false;
+  position += frame_bytes;
+  index.push_back(entry);
+  return pad((RawVideoFile::alignment - position % RawVideoFile::alignment) % RawVideoFile::alignment);
+}
+
+bool RawVideoWriter::close() {
+  if (file == 0) return false;
+  header.frame_count = index.size();
+  header.index_offset = position;
+  bool ok = index.size() == 0 ||
+            fwrite(&index[0], sizeof(RawVideoFile::IndexEntry), index.size(), file) == index.size();
+  ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+  ok = (fclose(file) == 0) && ok;
+  file = 0;
+  index.clear();
+  return ok;
+}
@@ -0,0 +1,125 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    raw_video_file.h
+  \brief   C++ Interface: RawVideoReader, RawVideoWriter
+  \author  Author Name, 2026
+*/
+//========================================================================
+
+#ifndef RAW_VIDEO_FILE_H
+#define RAW_VIDEO_FILE_H
+
+#include "colors.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+using namespace std;
+
+/*!
+  \class  RawVideoFile
+  \brief  Layout of the raw video container
+
+  A raw video file stores uncompressed frames of one size and color
+  format (UYVY, YUYV, RGB8, MONO8 or RAW8 Bayer). It starts with a 64 byte
+  header and ends with an index holding the offset and capture timestamp
+  of every frame. Frames start on 64 byte boundaries, so a memory mapped
+  frame can be handed to the SIMD conversions directly. All values are
+  in host byte order.
+*/
+class RawVideoFile {
+public:
+  struct Header {
+    char     magic[8];     // "SSLRAWV1"
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;       // ColorFormat, see toFileFormat()
+    uint32_t bayer_pattern;// Bayer::Pattern of RAW8 frames
+    uint32_t frame_count;
+    uint32_t reserved;
+    uint64_t index_offset;
+    uint8_t  padding[24];
+  };
+
+  struct IndexEntry {
+    uint64_t offset;
+    double   time;
+  };
+
+  static const size_t alignment = 64;
+
+  /// stable numbers for the color formats, independent of the ColorFormat enum
+  static uint32_t toFileFormat(ColorFormat fmt);
+  static ColorFormat fromFileFormat(uint32_t fmt);
+};
+
+/*!
+  \class  RawVideoReader
+  \brief  Random access to the frames of a raw video file through mmap
+*/
+class RawVideoReader {
+protected:
+  unsigned char * base;
+  size_t length;
+  const RawVideoFile::Header * header;
+  const RawVideoFile::IndexEntry * index;
+  ColorFormat format;
+  int frame_bytes;
+public:
+  RawVideoReader();
+  ~RawVideoReader();
+
+  bool open(const string & filename);
+  void close();
+  bool isOpen() const { return base != 0; }
+
+  int getFrameCount() const;
+  int getWidth() const;
+  int getHeight() const;
+  ColorFormat getColorFormat() const { return format; }
+  int getBayerPattern() const;
+
+  /// frame i lies inside the mapping and stays valid until close()
+  unsigned char * getFrameData(int i) const;
+  double getFrameTime(int i) const;
+  /// asks the kernel to start reading frame i
+  void prefetch(int i) const;
+};
+
+/*!
+  \class  RawVideoWriter
+  \brief  Appends frames to a new raw video file
+*/
+class RawVideoWriter {
+protected:
+  FILE * file;
+  RawVideoFile::Header header;
+  vector<RawVideoFile::IndexEntry> index;
+  uint64_t position;
+  int frame_bytes;
+  bool pad(size_t bytes);
+public:
+  RawVideoWriter();
+  ~RawVideoWriter();
+
+  bool open(const string & filename, ColorFormat fmt, int width, int height, int bayer_pattern=0);
+  bool appendFrame(const unsigned char * data, double time);
+  /// writes the index and the final header
+  bool close();
+  bool isOpen() const { return file != 0; }
+};
+
+#endif
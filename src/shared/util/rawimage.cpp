@@ -28,6 +28,7 @@ RawImage::RawImage()
   height=0;
   format=COLOR_UNDEFINED;
   time=0.0;
+  borrowed=false;
 }
 
 
@@ -66,6 +67,11 @@ int RawImage::getNumPixels() const
   return width*height;
 }
 
+bool RawImage::isBorrowed() const
+{
+  return borrowed;
+}
+
 int RawImage::getNumBytes() const
 {
   return computeImageSize(format,getNumPixels());
@@ -105,16 +111,18 @@ void RawImage::setTime(double t)
 
 void RawImage::setData(unsigned char * d)
 {
-  if (data!=0) delete[] data;
+  if (data!=0 && !borrowed) delete[] data;
   data=d;
+  borrowed=false;
 }
 
 void  RawImage::allocate (ColorFormat fmt, int w, int h)
 {
   if(w >= 0 && h >= 0) {
-    if (data!=0) {
+    if (data!=0 && !borrowed) {
       delete[] data;
     }
+    borrowed=false;
     if (w==0 && h==0) {
       data=0;
     } else {
@@ -128,7 +136,7 @@ void  RawImage::allocate (ColorFormat fmt, int w, int h)
 
 void  RawImage::ensure_allocation (ColorFormat fmt, int w, int h)
 {
-  if(data == 0 || format != fmt || width != w || height!=h) {
+  if(data == 0 || borrowed || format != fmt || width != w || height!=h) {
     allocate(fmt,w,h);
   }
 }
@@ -142,6 +150,26 @@ void RawImage::deepCopyFromRawImage(const RawImage & img, bool copyMetaData)
   }
 }
 
+void RawImage::borrowData(const RawImage & img)
+{
+  if (data!=0 && !borrowed) delete[] data;
+  data=img.getData();
+  width=img.getWidth();
+  height=img.getHeight();
+  format=img.getColorFormat();
+  time=img.getTime();
+  borrowed=true;
+}
+
+void RawImage::detach()
+{
+  if (!borrowed || data==0) return;
+  unsigned char * copy=new unsigned char[getNumBytes()];
+  memcpy(copy,data,getNumBytes());
+  data=copy;
+  borrowed=false;
+}
+
 void RawImage::clear()
 {
   allocate(getColorFormat(),0,0);
@@ -154,9 +182,14 @@ int RawImage::computeImageSize(ColorFormat fmt, int pixelCount)
     case COLOR_RGBA8: return pixelCount*4;
     case COLOR_YUV444: return pixelCount*3;
     case COLOR_YUV422_UYVY: return pixelCount*2;
+    case COLOR_YUV422_YUYV: return pixelCount*2;
     case COLOR_YUV411: return pixelCount*3/2;
     case COLOR_MONO8: return pixelCount;
     case COLOR_MONO16: return pixelCount*2;
+    case COLOR_RGB16: return pixelCount*6;
+    case COLOR_RAW8: return pixelCount;
+    case COLOR_RAW16: return pixelCount*2;
+    case COLOR_RAW32: return pixelCount*4;
     default:
     return 0;
   }
@@ -54,6 +54,10 @@ class RawImage : public ImageInterface
   /// capture timestamp of the image
   double   time;
 
+  /// true if data points to a buffer owned by someone else (e.g. a
+  /// capture driver's DMA buffer), which must never be deleted here
+  bool borrowed;
+
   public:
   RawImage();
 
@@ -68,6 +72,7 @@ class RawImage : public ImageInterface
   int getNumBytes() const;
   int getNumColorBlocks() const;
   int getNumPixels() const;
+  bool isBorrowed() const;
 
   //mutators:
   void setColorFormat(ColorFormat f);
@@ -78,6 +83,12 @@ class RawImage : public ImageInterface
   void allocate (ColorFormat fmt, int w, int h);
   void ensure_allocation (ColorFormat fmt, int w, int h);
   void deepCopyFromRawImage(const RawImage & img, bool copyMetaData);
+  /// points to img's data without copying it. The data stays owned by img's
+  /// provider and is only valid until the frame is released. Any later
+  /// allocation replaces the borrowed pointer with a private buffer.
+  void borrowData(const RawImage & img);
+  /// replaces borrowed data by a private copy of it.
+  void detach();
   void clear();
 
   //helpers:
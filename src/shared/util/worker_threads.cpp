@@ -0,0 +1,124 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    worker_threads.cpp
+  \brief   C++ Implementation: WorkerThreads
+  \author  Author Name, 2026
+*/
+//========================================================================
+
+#include "worker_threads.h"
+#include <sched.h>
+#include <unistd.h>
+
+WorkerThreads::WorkerThreads() {
+  pthread_mutex_init(&mutex, 0);
+  pthread_cond_init(&work_cond, 0);
+  pthread_cond_init(&done_cond, 0);
+  tasks = 0;
+  task_count = 0;
+  next_task = 0;
+  pending = 0;
+  stop = false;
+}
+
+WorkerThreads::~WorkerThreads() {
+  pthread_mutex_lock(&mutex);
+  stop = true;
+  pthread_cond_broadcast(&work_cond);
+  pthread_mutex_unlock(&mutex);
+  for (unsigned int i = 0; i < threads.size(); i++)
+    pthread_join(threads[i], 0);
+  pthread_cond_destroy(&done_cond);
+  pthread_cond_destroy(&work_cond);
+  pthread_mutex_destroy(&mutex);
+}
+
+int WorkerThreads::size() const {
+  return threads.size();
+}
+
+void * WorkerThreads::threadEntry(void * arg) {
+  //run wherever the process may run, not on the creator's pinned core:
+  cpu_set_t cpu_set;
+  if (sched_getaffinity(getpid(), sizeof(cpu_set), &cpu_set) == 0)
+    sched_setaffinity(0, sizeof(cpu_set), &cpu_set);
+  ((WorkerThreads *)arg)->workerLoop();
+  return 0;
+}
+
+/// takes the next task of the current batch. The caller has to hold mutex.
+bool WorkerThreads::takeTask(Task * & task) {
+  if (next_task >= task_count) return false;
+  task = tasks[next_task++];
+  return true;
+}
+
+/// the caller has to hold mutex
+void WorkerThreads::finishTask() {
+  if (--pending == 0)
+    pthread_cond_signal(&done_cond);
+}
+
+void WorkerThreads::workerLoop() {
+  pthread_mutex_lock(&mutex);
+  while (!stop) {
+    Task * task;
+    if (takeTask(task)) {
+      pthread_mutex_unlock(&mutex);
+      task->run();
+      pthread_mutex_lock(&mutex);
+      finishTask();
+    } else {
+      pthread_cond_wait(&work_cond, &mutex);
+    }
+  }
+  pthread_mutex_unlock(&mutex);
+}
+
+void WorkerThreads::run(Task ** _tasks, int count) {
+  if (count <= 0) return;
+  while ((int)threads.size() < count - 1) {
+    pthread_t thread;
+    if (pthread_create(&thread, 0, threadEntry, this) != 0) break;
+    threads.push_back(thread);
+  }
+
+  pthread_mutex_lock(&mutex);
+  tasks = _tasks;
+  task_count = count;
+  next_task = 1;
+  pending = count - 1;
+  if (pending > 0)
+    pthread_cond_broadcast(&work_cond);
+  pthread_mutex_unlock(&mutex);
+
+  //the calling thread takes the first task, then helps with the others:
+  _tasks[0]->run();
+  pthread_mutex_lock(&mutex);
+  Task * task;
+  while (takeTask(task)) {
+    pthread_mutex_unlock(&mutex);
+    task->run();
+    pthread_mutex_lock(&mutex);
+    finishTask();
+  }
+  while (pending > 0)
+    pthread_cond_wait(&done_cond, &mutex);
+  tasks = 0;
+  task_count = 0;
+  next_task = 0;
+  pthread_mutex_unlock(&mutex);
+}
@@ -0,0 +1,80 @@
+//========================================================================
+//  This software is free: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License Version 3,
+//  as published by the Free Software Foundation.
+//
+//  This software is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  Version 3 in the file COPYING that came with this distribution.
+//  If not, see <http://www.gnu.org/licenses/>.
+//========================================================================
+/*!
+  \file    worker_threads.h
+  \brief   C++ Interface: WorkerThreads
+  \author  Author Name, 2026
+*/
+//========================================================================
+#ifndef WORKER_THREADS_H
+#define WORKER_THREADS_H
+
+#include <pthread.h>
+#include <vector>
+using namespace std;
+
+/*!
+  \class  WorkerThreads
+  \brief  Persistent threads which run the tasks of a batch together with
+          the calling thread
+
+  The threads are started on first use and then wait on a condition
+  between batches, so that per-frame work does not pay for creating and
+  joining threads.
+
+  A worker does not keep the affinity of the thread that created it:
+  capture threads may be pinned to a single core, which would serialize
+  the workers behind them. Workers may run on every core the process may
+  use instead, i.e. the affinity of the main thread.
+*/
+class WorkerThreads {
+public:
+  /// a unit of work of a batch
+  class Task {
+  public:
+    virtual ~Task() {}
+    virtual void run() = 0;
+  };
+
+protected:
+  pthread_mutex_t mutex;
+  pthread_cond_t work_cond;
+  pthread_cond_t done_cond;
+  vector<pthread_t> threads;
+  Task ** tasks;
+  int task_count;
+  int next_task;
+  int pending;
+  bool stop;
+
+  static void * threadEntry(void * arg);
+  void workerLoop();
+  bool takeTask(Task * & task);
+  void finishTask();
+
+public:
+  WorkerThreads();
+  ~WorkerThreads();
+
+  /// runs \p count tasks, using up to count-1 workers in addition to the
+  /// calling thread, and returns once all of them have finished.
+  /// If a worker can not be started, its tasks are run by the caller.
+  void run(Task ** tasks, int count);
+
+  /// number of workers started so far
+  int size() const;
+};
+
+#endif